@@ -0,0 +1,55 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+namespace UdtBenchmark
+{
+	/// <summary>
+	/// Result of one benchmark case.
+	/// </summary>
+	class BenchmarkResult
+	{
+		public BenchmarkResult(string name)
+		{
+			Name = name;
+			Parameters = new Dictionary<string, long>();
+			Metrics = new Dictionary<string, double>();
+		}
+
+		/// <summary>
+		/// Benchmark name, e.g. <c>stream</c>.
+		/// </summary>
+		public string Name { get; private set; }
+
+		/// <summary>
+		/// Inputs of the case, e.g. buffer size.
+		/// </summary>
+		public Dictionary<string, long> Parameters { get; private set; }
+
+		/// <summary>
+		/// Measured values, e.g. throughput.
+		/// </summary>
+		public Dictionary<string, double> Metrics { get; private set; }
+
+		public void Write(JsonWriter writer)
+		{
+			writer.BeginObject();
+			writer.Property("name", Name);
+
+			writer.Name("parameters");
+			writer.BeginObject();
+			foreach (var pair in Parameters)
+				writer.Property(pair.Key, pair.Value);
+			writer.EndObject();
+
+			writer.Name("metrics");
+			writer.BeginObject();
+			foreach (var pair in Metrics)
+				writer.Property(pair.Key, pair.Value);
+			writer.EndObject();
+
+			writer.EndObject();
+		}
+	}
+}
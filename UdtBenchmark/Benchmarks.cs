@@ -0,0 +1,368 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace UdtBenchmark
+{
+	/// <summary>
+	/// Benchmark cases, each run over a fresh loopback connection.
+	/// </summary>
+	static class Benchmarks
+	{
+		/// <summary>
+		/// Stream Send/Receive throughput using the given buffer size on both ends.
+		/// </summary>
+		public static BenchmarkResult StreamThroughput(int bufferSize, long totalBytes)
+		{
+			Udt.Socket client, server;
+			ConnectPair(SocketType.Stream, out client, out server);
+
+			using (client)
+			using (server)
+			{
+				byte[] sendBuffer = CreatePayload(bufferSize);
+				byte[] receiveBuffer = new byte[bufferSize];
+
+				Stopwatch stopwatch = Stopwatch.StartNew();
+
+				Task receiver = Task.Factory.StartNew(() =>
+				{
+					long received = 0;
+					while (received < totalBytes)
+						received += server.Receive(receiveBuffer);
+				});
+
+				long sent = 0;
+				while (sent < totalBytes)
+				{
+					int size = (int)Math.Min(bufferSize, totalBytes - sent);
+					sent += client.Send(sendBuffer, 0, size);
+				}
+
+				receiver.Wait();
+				stopwatch.Stop();
+
+				BenchmarkResult result = new BenchmarkResult("stream");
+				result.Parameters["buffer_size"] = bufferSize;
+				result.Parameters["total_bytes"] = totalBytes;
+				AddThroughput(result, totalBytes, stopwatch.Elapsed);
+				AddTrace(result, client.GetPerformanceInfo());
+				return result;
+			}
+		}
+
+		/// <summary>
+		/// SendMessage/ReceiveMessage rate on a datagram connection.
+		/// </summary>
+		public static BenchmarkResult MessageRate(int messageSize, int messageCount)
+		{
+			Udt.Socket client, server;
+			ConnectPair(SocketType.Dgram, out client, out server);
+
+			using (client)
+			using (server)
+			{
+				byte[] sendBuffer = CreatePayload(messageSize);
+				byte[] receiveBuffer = new byte[messageSize];
+
+				Stopwatch stopwatch = Stopwatch.StartNew();
+
+				Task receiver = Task.Factory.StartNew(() =>
+				{
+					for (int i = 0; i < messageCount; i++)
+						server.ReceiveMessage(receiveBuffer);
+				});
+
+				for (int i = 0; i < messageCount; i++)
+					client.SendMessage(sendBuffer);
+
+				receiver.Wait();
+				stopwatch.Stop();
+
+				BenchmarkResult result = new BenchmarkResult("message");
+				result.Parameters["message_size"] = messageSize;
+				result.Parameters["message_count"] = messageCount;
+				result.Metrics["messages_per_second"] = messageCount / stopwatch.Elapsed.TotalSeconds;
+				AddThroughput(result, (long)messageSize * messageCount, stopwatch.Elapsed);
+				AddTrace(result, client.GetPerformanceInfo());
+				return result;
+			}
+		}
+
+		/// <summary>
+		/// SendFile/ReceiveFile throughput for a temporary file of the given size.
+		/// </summary>
+		public static BenchmarkResult FileThroughput(long fileSize)
+		{
+			string sourceName = Path.GetTempFileName();
+			string targetName = Path.GetTempFileName();
+
+			try
+			{
+				using (FileStream source = File.OpenWrite(sourceName))
+				{
+					byte[] block = CreatePayload(1024 * 1024);
+					for (long written = 0; written < fileSize; written += block.Length)
+						source.Write(block, 0, (int)Math.Min(block.Length, fileSize - written));
+				}
+
+				Udt.Socket client, server;
+				ConnectPair(SocketType.Stream, out client, out server);
+
+				using (client)
+				using (server)
+				{
+					Stopwatch stopwatch = Stopwatch.StartNew();
+
+					Task receiver = Task.Factory.StartNew(() => server.ReceiveFile(targetName, fileSize));
+					client.SendFile(sourceName);
+
+					receiver.Wait();
+					stopwatch.Stop();
+
+					BenchmarkResult result = new BenchmarkResult("file");
+					result.Parameters["file_size"] = fileSize;
+					AddThroughput(result, fileSize, stopwatch.Elapsed);
+					AddTrace(result, client.GetPerformanceInfo());
+					return result;
+				}
+			}
+			finally
+			{
+				File.Delete(sourceName);
+				File.Delete(targetName);
+			}
+		}
+
+		/// <summary>
+		/// Round trip latency of a stream ping-pong of the given size.
+		/// </summary>
+		public static BenchmarkResult PingPongLatency(int messageSize, int iterations, int warmup)
+		{
+			Udt.Socket client, server;
+			ConnectPair(SocketType.Stream, out client, out server);
+
+			using (client)
+			using (server)
+			{
+				byte[] ping = CreatePayload(messageSize);
+				byte[] clientBuffer = new byte[messageSize];
+				byte[] serverBuffer = new byte[messageSize];
+				int rounds = warmup + iterations;
+
+				Task echo = Task.Factory.StartNew(() =>
+				{
+					for (int i = 0; i < rounds; i++)
+					{
+						ReceiveAll(server, serverBuffer);
+						server.Send(serverBuffer);
+					}
+				});
+
+				double[] samples = new double[iterations];
+				double ticksPerMicrosecond = Stopwatch.Frequency / 1000000.0;
+
+				for (int i = 0; i < rounds; i++)
+				{
+					long start = Stopwatch.GetTimestamp();
+					client.Send(ping);
+					ReceiveAll(client, clientBuffer);
+					long elapsed = Stopwatch.GetTimestamp() - start;
+
+					if (i >= warmup)
+						samples[i - warmup] = elapsed / ticksPerMicrosecond;
+				}
+
+				echo.Wait();
+				Array.Sort(samples);
+
+				BenchmarkResult result = new BenchmarkResult("pingpong");
+				result.Parameters["message_size"] = messageSize;
+				result.Parameters["iterations"] = iterations;
+				result.Metrics["mean_us"] = samples.Average();
+				result.Metrics["min_us"] = samples[0];
+				result.Metrics["p50_us"] = Percentile(samples, 0.50);
+				result.Metrics["p90_us"] = Percentile(samples, 0.90);
+				result.Metrics["p99_us"] = Percentile(samples, 0.99);
+				result.Metrics["p999_us"] = Percentile(samples, 0.999);
+				result.Metrics["max_us"] = samples[samples.Length - 1];
+				return result;
+			}
+		}
+
+		/// <summary>
+		/// Throughput and fairness of parallel streams sharing an emulated
+		/// bottleneck link.
+		/// </summary>
+		public static BenchmarkResult ImpairedThroughput(int flowCount, TimeSpan delay, double lossRate, long bandwidth, TimeSpan duration, int seed)
+		{
+			using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+			{
+				listener.Bind(IPAddress.Loopback, 0);
+				listener.Listen(flowCount);
+
+				using (NetworkEmulator emulator = new NetworkEmulator(listener.LocalEndPoint, seed))
+				{
+					foreach (LinkProfile link in new[] { emulator.Upstream, emulator.Downstream })
+					{
+						link.Delay = TimeSpan.FromTicks(delay.Ticks / 2);
+						link.LossRate = lossRate;
+					}
+
+					emulator.Upstream.Bandwidth = bandwidth;
+					// One bandwidth-delay product of queue
+					emulator.Upstream.QueueLimit = (int)Math.Max(64 * 1024, bandwidth / 8 * delay.TotalSeconds);
+
+					List<Udt.Socket> clients = new List<Udt.Socket>();
+					List<Udt.Socket> servers = new List<Udt.Socket>();
+
+					try
+					{
+						for (int i = 0; i < flowCount; i++)
+						{
+							Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream);
+							clients.Add(client);
+							client.Connect(emulator.LocalEndPoint);
+							servers.Add(listener.Accept());
+						}
+
+						byte[] sendBuffer = CreatePayload(65536);
+						long[] received = new long[flowCount];
+						DateTime stop = DateTime.UtcNow + duration;
+
+						Task[] receivers = servers.Select((server, i) => Task.Factory.StartNew(() =>
+						{
+							byte[] buffer = new byte[65536];
+							try
+							{
+								int size;
+								while ((size = server.Receive(buffer)) > 0)
+									Interlocked.Add(ref received[i], size);
+							}
+							catch (Udt.SocketException)
+							{
+							}
+						}, TaskCreationOptions.LongRunning)).ToArray();
+
+						Task[] senders = clients.Select(client => Task.Factory.StartNew(() =>
+						{
+							while (DateTime.UtcNow < stop)
+								client.Send(sendBuffer);
+						}, TaskCreationOptions.LongRunning)).ToArray();
+
+						Task.WaitAll(senders);
+
+						// Sample before closing, data still in flight does not count
+						long[] totals = new long[flowCount];
+						for (int i = 0; i < flowCount; i++)
+							totals[i] = Interlocked.Read(ref received[i]);
+
+						double seconds = duration.TotalSeconds;
+
+						BenchmarkResult result = new BenchmarkResult("impaired");
+						result.Parameters["flows"] = flowCount;
+						result.Parameters["delay_ms"] = (long)delay.TotalMilliseconds;
+						result.Parameters["loss_ppm"] = (long)(lossRate * 1000000);
+						result.Parameters["bandwidth"] = bandwidth;
+						result.Parameters["seed"] = seed;
+						result.Metrics["seconds"] = seconds;
+						result.Metrics["mbps"] = totals.Sum() * 8 / seconds / 1000000.0;
+						result.Metrics["fairness"] = JainFairness(totals);
+
+						for (int i = 0; i < flowCount; i++)
+							result.Metrics["flow" + i + "_mbps"] = totals[i] * 8 / seconds / 1000000.0;
+
+						result.Metrics["emulator_lost"] = emulator.UpstreamStatistics.PacketsLost;
+						result.Metrics["emulator_queue_dropped"] = emulator.UpstreamStatistics.PacketsQueueDropped;
+						AddTrace(result, clients[0].GetPerformanceInfo());
+
+						foreach (Udt.Socket client in clients)
+							client.Close();
+
+						Task.WaitAll(receivers, TimeSpan.FromSeconds(5));
+						return result;
+					}
+					finally
+					{
+						foreach (Udt.Socket socket in clients.Concat(servers))
+							socket.Dispose();
+					}
+				}
+			}
+		}
+
+		/// <summary>
+		/// Jain's fairness index, 1 when every flow got the same share.
+		/// </summary>
+		static double JainFairness(long[] values)
+		{
+			double sum = values.Sum();
+			double squares = values.Sum(v => (double)v * v);
+			return squares == 0 ? 1 : sum * sum / (values.Length * squares);
+		}
+
+		static void ConnectPair(SocketType type, out Udt.Socket client, out Udt.Socket server)
+		{
+			using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, type))
+			{
+				listener.Bind(IPAddress.Loopback, 0);
+				listener.Listen(1);
+
+				client = new Udt.Socket(AddressFamily.InterNetwork, type);
+
+				try
+				{
+					client.Connect(listener.LocalEndPoint);
+					server = listener.Accept();
+				}
+				catch
+				{
+					client.Dispose();
+					throw;
+				}
+			}
+		}
+
+		static void ReceiveAll(Udt.Socket socket, byte[] buffer)
+		{
+			int received = 0;
+			while (received < buffer.Length)
+				received += socket.Receive(buffer, received, buffer.Length - received);
+		}
+
+		static byte[] CreatePayload(int size)
+		{
+			// Fixed seed, every run sends the same bytes
+			byte[] payload = new byte[size];
+			new Random(size).NextBytes(payload);
+			return payload;
+		}
+
+		static double Percentile(double[] sorted, double fraction)
+		{
+			int index = (int)Math.Ceiling(fraction * sorted.Length) - 1;
+			return sorted[Math.Max(0, Math.Min(sorted.Length - 1, index))];
+		}
+
+		static void AddThroughput(BenchmarkResult result, long bytes, TimeSpan elapsed)
+		{
+			result.Metrics["seconds"] = elapsed.TotalSeconds;
+			result.Metrics["mbps"] = bytes * 8 / elapsed.TotalSeconds / 1000000.0;
+		}
+
+		static void AddTrace(BenchmarkResult result, Udt.TraceInfo trace)
+		{
+			result.Metrics["packets_sent"] = trace.Total.PacketsSent;
+			result.Metrics["packets_retransmitted"] = trace.Total.PacketsRetransmitted;
+			result.Metrics["send_packets_lost"] = trace.Total.SendPacketsLost;
+			result.Metrics["rtt_ms"] = trace.Probe.RoundtripTime.TotalMilliseconds;
+		}
+	}
+}
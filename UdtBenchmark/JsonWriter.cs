@@ -0,0 +1,153 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Text;
+
+namespace UdtBenchmark
+{
+	/// <summary>
+	/// Minimal JSON writer for benchmark results.
+	/// </summary>
+	/// <remarks>
+	/// Values are written with the invariant culture so reports compare
+	/// the same on every machine.
+	/// </remarks>
+	class JsonWriter
+	{
+		readonly TextWriter _writer;
+		readonly Stack<bool> _first = new Stack<bool>();
+		bool _afterName;
+
+		public JsonWriter(TextWriter writer)
+		{
+			_writer = writer;
+		}
+
+		public void BeginObject()
+		{
+			BeginValue();
+			_writer.Write('{');
+			_first.Push(true);
+		}
+
+		public void EndObject()
+		{
+			_first.Pop();
+			_writer.Write('}');
+		}
+
+		public void BeginArray()
+		{
+			BeginValue();
+			_writer.Write('[');
+			_first.Push(true);
+		}
+
+		public void EndArray()
+		{
+			_first.Pop();
+			_writer.Write(']');
+		}
+
+		public void Name(string name)
+		{
+			Separate();
+			WriteString(name);
+			_writer.Write(':');
+			_afterName = true;
+		}
+
+		public void Value(string value)
+		{
+			BeginValue();
+			if (value == null)
+				_writer.Write("null");
+			else
+				WriteString(value);
+		}
+
+		public void Value(long value)
+		{
+			BeginValue();
+			_writer.Write(value.ToString(CultureInfo.InvariantCulture));
+		}
+
+		public void Value(double value)
+		{
+			BeginValue();
+			if (double.IsNaN(value) || double.IsInfinity(value))
+				_writer.Write("null");
+			else
+				_writer.Write(value.ToString("R", CultureInfo.InvariantCulture));
+		}
+
+		public void Property(string name, string value)
+		{
+			Name(name);
+			Value(value);
+		}
+
+		public void Property(string name, long value)
+		{
+			Name(name);
+			Value(value);
+		}
+
+		public void Property(string name, double value)
+		{
+			Name(name);
+			Value(value);
+		}
+
+		void BeginValue()
+		{
+			if (_afterName)
+				_afterName = false;
+			else
+				Separate();
+		}
+
+		void Separate()
+		{
+			if (_first.Count == 0)
+				return;
+
+			if (_first.Peek())
+			{
+				_first.Pop();
+				_first.Push(false);
+			}
+			else
+			{
+				_writer.Write(',');
+			}
+		}
+
+		void WriteString(string value)
+		{
+			_writer.Write('"');
+
+			foreach (char c in value)
+			{
+				switch (c)
+				{
+					case '"': _writer.Write("\\\""); break;
+					case '\\': _writer.Write("\\\\"); break;
+					case '\n': _writer.Write("\\n"); break;
+					case '\r': _writer.Write("\\r"); break;
+					case '\t': _writer.Write("\\t"); break;
+					default:
+						if (c < ' ')
+							_writer.Write("\\u{0:x4}", (int)c);
+						else
+							_writer.Write(c);
+						break;
+				}
+			}
+
+			_writer.Write('"');
+		}
+	}
+}
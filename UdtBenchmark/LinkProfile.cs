@@ -0,0 +1,85 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+namespace UdtBenchmark
+{
+	/// <summary>
+	/// Impairments applied to one direction of a <see cref="NetworkEmulator"/>.
+	/// </summary>
+	/// <remarks>
+	/// The defaults forward every packet unchanged. Properties can be changed
+	/// while the emulator is running, e.g. to step the bandwidth mid-test.
+	/// </remarks>
+	public sealed class LinkProfile
+	{
+		public LinkProfile()
+		{
+			GilbertBadLossRate = 1.0;
+		}
+
+		/// <summary>
+		/// Fixed one-way delay added to every packet.
+		/// </summary>
+		public TimeSpan Delay { get; set; }
+
+		/// <summary>
+		/// Uniform random variation of <see cref="Delay"/>, +/- this amount.
+		/// </summary>
+		/// <remarks>
+		/// Jitter larger than the gap between packets reorders them, as on a
+		/// real path.
+		/// </remarks>
+		public TimeSpan Jitter { get; set; }
+
+		/// <summary>
+		/// Independent (Bernoulli) probability of dropping a packet, 0 to 1.
+		/// </summary>
+		public double LossRate { get; set; }
+
+		/// <summary>
+		/// Gilbert-Elliott probability of moving from the good to the bad
+		/// state per packet. 0 disables the burst loss model.
+		/// </summary>
+		public double GilbertGoodToBad { get; set; }
+
+		/// <summary>
+		/// Gilbert-Elliott probability of moving from the bad to the good
+		/// state per packet.
+		/// </summary>
+		public double GilbertBadToGood { get; set; }
+
+		/// <summary>
+		/// Drop probability in the good state (default 0).
+		/// </summary>
+		public double GilbertGoodLossRate { get; set; }
+
+		/// <summary>
+		/// Drop probability in the bad state (default 1).
+		/// </summary>
+		public double GilbertBadLossRate { get; set; }
+
+		/// <summary>
+		/// Probability of sending a packet without <see cref="Delay"/>, ahead
+		/// of the packets already in flight.
+		/// </summary>
+		public double ReorderRate { get; set; }
+
+		/// <summary>
+		/// Probability of sending a packet twice.
+		/// </summary>
+		public double DuplicateRate { get; set; }
+
+		/// <summary>
+		/// Link rate in bits per second, 0 for unlimited.
+		/// </summary>
+		public long Bandwidth { get; set; }
+
+		/// <summary>
+		/// Bytes that may wait for the link when <see cref="Bandwidth"/> is
+		/// set before new packets are tail dropped, 0 for unlimited.
+		/// </summary>
+		public int QueueLimit { get; set; }
+	}
+}
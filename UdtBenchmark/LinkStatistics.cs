@@ -0,0 +1,57 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+
+namespace UdtBenchmark
+{
+	/// <summary>
+	/// Packet counters for one direction of a <see cref="NetworkEmulator"/>.
+	/// </summary>
+	public sealed class LinkStatistics
+	{
+		internal long _received;
+		internal long _forwarded;
+		internal long _lost;
+		internal long _queueDropped;
+		internal long _reordered;
+		internal long _duplicated;
+		internal long _bytesForwarded;
+
+		/// <summary>
+		/// Packets that arrived at the emulator.
+		/// </summary>
+		public long PacketsReceived { get { return Interlocked.Read(ref _received); } }
+
+		/// <summary>
+		/// Packets sent on to the destination, duplicates included.
+		/// </summary>
+		public long PacketsForwarded { get { return Interlocked.Read(ref _forwarded); } }
+
+		/// <summary>
+		/// Packets dropped by the loss models.
+		/// </summary>
+		public long PacketsLost { get { return Interlocked.Read(ref _lost); } }
+
+		/// <summary>
+		/// Packets dropped because <see cref="LinkProfile.QueueLimit"/> was exceeded.
+		/// </summary>
+		public long PacketsQueueDropped { get { return Interlocked.Read(ref _queueDropped); } }
+
+		/// <summary>
+		/// Packets sent ahead of their delay.
+		/// </summary>
+		public long PacketsReordered { get { return Interlocked.Read(ref _reordered); } }
+
+		/// <summary>
+		/// Extra copies sent.
+		/// </summary>
+		public long PacketsDuplicated { get { return Interlocked.Read(ref _duplicated); } }
+
+		/// <summary>
+		/// Payload bytes sent on to the destination.
+		/// </summary>
+		public long BytesForwarded { get { return Interlocked.Read(ref _bytesForwarded); } }
+	}
+}
@@ -0,0 +1,495 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading;
+
+namespace UdtBenchmark
+{
+	/// <summary>
+	/// UDP relay that impairs the traffic between UDT sockets on one machine.
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Clients connect to <see cref="LocalEndPoint"/> instead of the server.
+	/// Each client address gets its own relay port toward <see cref="Target"/>,
+	/// so the server sees one peer per client, while all clients share the
+	/// <see cref="Upstream"/> and <see cref="Downstream"/> links. That makes a
+	/// bandwidth cap a shared bottleneck, for fairness tests.
+	/// </para>
+	/// <para>
+	/// Every random decision is taken from a <see cref="Random"/> seeded from
+	/// the constructor, one per direction, in packet arrival order. The same
+	/// seed and the same packet sequence give the same losses, reorders and
+	/// duplicates.
+	/// </para>
+	/// </remarks>
+	public sealed class NetworkEmulator : IDisposable
+	{
+		const int MaxDatagramSize = 65536;
+
+		// Disables WSAECONNRESET on UDP receive after an ICMP port unreachable
+		const int SIO_UDP_CONNRESET = -1744830452;
+
+		readonly IPEndPoint _target;
+		readonly Socket _front;
+		readonly Link _upstream;
+		readonly Link _downstream;
+		readonly Dictionary<IPEndPoint, Flow> _flows = new Dictionary<IPEndPoint, Flow>();
+		readonly SortedSet<Pending> _pending = new SortedSet<Pending>(new PendingComparer());
+		readonly List<Thread> _threads = new List<Thread>();
+		readonly bool _timerPeriodSet;
+		long _sequence;
+		volatile bool _disposed;
+
+		/// <summary>
+		/// Start relaying to <paramref name="target"/> from a loopback port.
+		/// </summary>
+		/// <param name="target">Server end point.</param>
+		/// <param name="seed">Seed for the impairment random numbers.</param>
+		/// <exception cref="ArgumentNullException">If <paramref name="target"/> is null.</exception>
+		public NetworkEmulator(IPEndPoint target, int seed)
+		{
+			if (target == null) throw new ArgumentNullException("target");
+
+			_target = target;
+			_upstream = new Link(seed);
+			_downstream = new Link(unchecked(seed + 1));
+			_front = CreateRelaySocket();
+
+			try
+			{
+				// Default 15.6 ms timer resolution would swamp millisecond delays
+				_timerPeriodSet = NativeMethods.timeBeginPeriod(1) == 0;
+			}
+			catch (DllNotFoundException)
+			{
+			}
+			catch (EntryPointNotFoundException)
+			{
+			}
+
+			StartThread(SendLoop, "NetworkEmulator send");
+			StartThread(() => ReceiveLoop(_front, null), "NetworkEmulator upstream");
+		}
+
+		/// <summary>
+		/// End point clients connect to.
+		/// </summary>
+		public IPEndPoint LocalEndPoint
+		{
+			get { return (IPEndPoint)_front.LocalEndPoint; }
+		}
+
+		/// <summary>
+		/// End point packets from clients are relayed to.
+		/// </summary>
+		public IPEndPoint Target
+		{
+			get { return _target; }
+		}
+
+		/// <summary>
+		/// Impairments for packets from the clients to <see cref="Target"/>.
+		/// </summary>
+		public LinkProfile Upstream
+		{
+			get { return _upstream.Profile; }
+		}
+
+		/// <summary>
+		/// Impairments for packets from <see cref="Target"/> to the clients.
+		/// </summary>
+		public LinkProfile Downstream
+		{
+			get { return _downstream.Profile; }
+		}
+
+		/// <summary>
+		/// Counters for packets from the clients.
+		/// </summary>
+		public LinkStatistics UpstreamStatistics
+		{
+			get { return _upstream.Statistics; }
+		}
+
+		/// <summary>
+		/// Counters for packets from <see cref="Target"/>.
+		/// </summary>
+		public LinkStatistics DownstreamStatistics
+		{
+			get { return _downstream.Statistics; }
+		}
+
+		public void Dispose()
+		{
+			if (_disposed)
+				return;
+
+			_disposed = true;
+
+			lock (_pending)
+				Monitor.PulseAll(_pending);
+
+			_front.Close();
+
+			lock (_flows)
+			{
+				foreach (Flow flow in _flows.Values)
+					flow.Relay.Close();
+			}
+
+			Thread[] threads;
+
+			lock (_threads)
+				threads = _threads.ToArray();
+
+			foreach (Thread thread in threads)
+				thread.Join();
+
+			if (_timerPeriodSet)
+				NativeMethods.timeEndPeriod(1);
+		}
+
+		Socket CreateRelaySocket()
+		{
+			Socket socket = new Socket(_target.AddressFamily, SocketType.Dgram, ProtocolType.Udp);
+
+			try
+			{
+				socket.ReceiveBufferSize = 4 * 1024 * 1024;
+				socket.SendBufferSize = 4 * 1024 * 1024;
+
+				try
+				{
+					socket.IOControl(SIO_UDP_CONNRESET, new byte[4], null);
+				}
+				catch (SocketException)
+				{
+				}
+				catch (PlatformNotSupportedException)
+				{
+				}
+
+				socket.Bind(new IPEndPoint(_target.AddressFamily == AddressFamily.InterNetworkV6 ? IPAddress.IPv6Loopback : IPAddress.Loopback, 0));
+			}
+			catch
+			{
+				socket.Close();
+				throw;
+			}
+
+			return socket;
+		}
+
+		void StartThread(ThreadStart start, string name)
+		{
+			Thread thread = new Thread(start);
+			thread.Name = name;
+			thread.IsBackground = true;
+
+			lock (_threads)
+				_threads.Add(thread);
+
+			thread.Start();
+		}
+
+		/// <param name="socket">Socket to read.</param>
+		/// <param name="flow">Flow the relay socket belongs to, null for the client facing socket.</param>
+		void ReceiveLoop(Socket socket, Flow flow)
+		{
+			byte[] buffer = new byte[MaxDatagramSize];
+
+			while (!_disposed)
+			{
+				EndPoint from = new IPEndPoint(_target.AddressFamily == AddressFamily.InterNetworkV6 ? IPAddress.IPv6Any : IPAddress.Any, 0);
+				int size;
+
+				try
+				{
+					size = socket.ReceiveFrom(buffer, ref from);
+				}
+				catch (SocketException ex)
+				{
+					if (ex.SocketErrorCode == SocketError.ConnectionReset || ex.SocketErrorCode == SocketError.MessageSize)
+						continue;
+
+					return;
+				}
+				catch (ObjectDisposedException)
+				{
+					return;
+				}
+
+				byte[] data = new byte[size];
+				Buffer.BlockCopy(buffer, 0, data, 0, size);
+
+				if (flow == null)
+				{
+					Flow clientFlow = GetFlow((IPEndPoint)from);
+
+					if (clientFlow != null)
+						Schedule(_upstream, data, clientFlow.Relay, _target);
+				}
+				else if (from.Equals(_target))
+				{
+					Schedule(_downstream, data, _front, flow.Client);
+				}
+			}
+		}
+
+		Flow GetFlow(IPEndPoint client)
+		{
+			lock (_flows)
+			{
+				if (_disposed)
+					return null;
+
+				Flow flow;
+
+				if (!_flows.TryGetValue(client, out flow))
+				{
+					flow = new Flow(client, CreateRelaySocket());
+					_flows.Add(client, flow);
+					StartThread(() => ReceiveLoop(flow.Relay, flow), "NetworkEmulator downstream " + client);
+				}
+
+				return flow;
+			}
+		}
+
+		void Schedule(Link link, byte[] data, Socket via, EndPoint to)
+		{
+			long now = Stopwatch.GetTimestamp();
+			long due;
+			int copies = link.Admit(data.Length, now, out due);
+
+			if (copies == 0)
+				return;
+
+			lock (_pending)
+			{
+				for (int i = 0; i < copies; i++)
+					_pending.Add(new Pending(due, _sequence++, data, via, to, link.Statistics));
+
+				Monitor.Pulse(_pending);
+			}
+		}
+
+		void SendLoop()
+		{
+			long spinThreshold = Stopwatch.Frequency / 500;
+
+			while (true)
+			{
+				Pending next = null;
+
+				lock (_pending)
+				{
+					if (_disposed)
+						return;
+
+					if (_pending.Count == 0)
+					{
+						Monitor.Wait(_pending);
+						continue;
+					}
+
+					Pending first = _pending.Min;
+					long remaining = first.Due - Stopwatch.GetTimestamp();
+
+					if (remaining <= 0)
+					{
+						_pending.Remove(first);
+						next = first;
+					}
+					else if (remaining > spinThreshold)
+					{
+						// Wake a millisecond early and spin the rest
+						Monitor.Wait(_pending, (int)((remaining - spinThreshold / 2) * 1000 / Stopwatch.Frequency));
+						continue;
+					}
+				}
+
+				if (next == null)
+				{
+					Thread.Yield();
+					continue;
+				}
+
+				try
+				{
+					next.Via.SendTo(next.Data, next.To);
+					Interlocked.Increment(ref next.Statistics._forwarded);
+					Interlocked.Add(ref next.Statistics._bytesForwarded, next.Data.Length);
+				}
+				catch (SocketException)
+				{
+					// Same as a packet lost on the wire
+				}
+				catch (ObjectDisposedException)
+				{
+					return;
+				}
+			}
+		}
+
+		/// <summary>
+		/// Impairment state of one direction.
+		/// </summary>
+		sealed class Link
+		{
+			public readonly LinkProfile Profile = new LinkProfile();
+			public readonly LinkStatistics Statistics = new LinkStatistics();
+
+			readonly Random _random;
+			bool _bad;
+			long _linkFree;
+
+			public Link(int seed)
+			{
+				_random = new Random(seed);
+			}
+
+			/// <summary>
+			/// Decide the fate of one packet.
+			/// </summary>
+			/// <param name="size">Packet size in bytes.</param>
+			/// <param name="now">Arrival time in <see cref="Stopwatch"/> ticks.</param>
+			/// <param name="due">Time to send the packet in <see cref="Stopwatch"/> ticks.</param>
+			/// <returns>Number of copies to send, 0 if dropped.</returns>
+			public int Admit(int size, long now, out long due)
+			{
+				due = now;
+
+				lock (this)
+				{
+					Interlocked.Increment(ref Statistics._received);
+
+					if (IsLost())
+					{
+						Interlocked.Increment(ref Statistics._lost);
+						return 0;
+					}
+
+					long sent = now;
+					long bandwidth = Profile.Bandwidth;
+
+					if (bandwidth > 0)
+					{
+						if (_linkFree > now && Profile.QueueLimit > 0)
+						{
+							double queued = (double)(_linkFree - now) / Stopwatch.Frequency * bandwidth / 8;
+
+							if (queued + size > Profile.QueueLimit)
+							{
+								Interlocked.Increment(ref Statistics._queueDropped);
+								return 0;
+							}
+						}
+
+						_linkFree = Math.Max(_linkFree, now) + (long)((double)size * 8 * Stopwatch.Frequency / bandwidth);
+						sent = _linkFree;
+					}
+
+					if (Profile.ReorderRate > 0 && _random.NextDouble() < Profile.ReorderRate)
+					{
+						Interlocked.Increment(ref Statistics._reordered);
+						due = sent;
+					}
+					else
+					{
+						double delay = Profile.Delay.TotalSeconds;
+
+						if (Profile.Jitter > TimeSpan.Zero)
+							delay += (_random.NextDouble() * 2 - 1) * Profile.Jitter.TotalSeconds;
+
+						due = sent + (long)(Math.Max(0, delay) * Stopwatch.Frequency);
+					}
+
+					if (Profile.DuplicateRate > 0 && _random.NextDouble() < Profile.DuplicateRate)
+					{
+						Interlocked.Increment(ref Statistics._duplicated);
+						return 2;
+					}
+
+					return 1;
+				}
+			}
+
+			bool IsLost()
+			{
+				bool lost = false;
+
+				if (Profile.GilbertGoodToBad > 0)
+				{
+					if (_bad)
+						_bad = _random.NextDouble() >= Profile.GilbertBadToGood;
+					else
+						_bad = _random.NextDouble() < Profile.GilbertGoodToBad;
+
+					lost = _random.NextDouble() < (_bad ? Profile.GilbertBadLossRate : Profile.GilbertGoodLossRate);
+				}
+
+				if (Profile.LossRate > 0 && _random.NextDouble() < Profile.LossRate)
+					lost = true;
+
+				return lost;
+			}
+		}
+
+		sealed class Flow
+		{
+			public readonly IPEndPoint Client;
+			public readonly Socket Relay;
+
+			public Flow(IPEndPoint client, Socket relay)
+			{
+				Client = client;
+				Relay = relay;
+			}
+		}
+
+		sealed class Pending
+		{
+			public readonly long Due;
+			public readonly long Sequence;
+			public readonly byte[] Data;
+			public readonly Socket Via;
+			public readonly EndPoint To;
+			public readonly LinkStatistics Statistics;
+
+			public Pending(long due, long sequence, byte[] data, Socket via, EndPoint to, LinkStatistics statistics)
+			{
+				Due = due;
+				Sequence = sequence;
+				Data = data;
+				Via = via;
+				To = to;
+				Statistics = statistics;
+			}
+		}
+
+		sealed class PendingComparer : IComparer<Pending>
+		{
+			public int Compare(Pending x, Pending y)
+			{
+				int result = x.Due.CompareTo(y.Due);
+				return result != 0 ? result : x.Sequence.CompareTo(y.Sequence);
+			}
+		}
+
+		static class NativeMethods
+		{
+			[DllImport("winmm.dll")]
+			public static extern uint timeBeginPeriod(uint period);
+
+			[DllImport("winmm.dll")]
+			public static extern uint timeEndPeriod(uint period);
+		}
+	}
+}
@@ -0,0 +1,109 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+
+namespace UdtBenchmark
+{
+	class Program
+	{
+		static int Main(string[] args)
+		{
+			bool quick = false;
+			string output = null;
+
+			for (int i = 0; i < args.Length; i++)
+			{
+				if (args[i] == "--quick")
+					quick = true;
+				else if (args[i] == "--output" && i + 1 < args.Length)
+					output = args[++i];
+				else
+					return Usage();
+			}
+
+			try
+			{
+				List<BenchmarkResult> results = Run(quick);
+
+				using (TextWriter writer = output == null ? Console.Out : new StreamWriter(output, false, new UTF8Encoding(false)))
+				{
+					WriteReport(writer, results);
+					writer.WriteLine();
+				}
+
+				return 0;
+			}
+			catch (Exception ex)
+			{
+				Console.Error.WriteLine("Error running benchmarks: {0}", ex);
+				return 2;
+			}
+		}
+
+		static int Usage()
+		{
+			Console.WriteLine("Usage: UdtBenchmark [--quick] [--output file.json]");
+			return 1;
+		}
+
+		static List<BenchmarkResult> Run(bool quick)
+		{
+			long streamBytes = quick ? 16L << 20 : 256L << 20;
+			int messageCount = quick ? 2000 : 50000;
+			long fileSize = quick ? 16L << 20 : 256L << 20;
+			int pingIterations = quick ? 1000 : 20000;
+
+			List<BenchmarkResult> results = new List<BenchmarkResult>();
+
+			foreach (int bufferSize in new[] { 1024, 8192, 65536, 1048576 })
+				results.Add(Report(Benchmarks.StreamThroughput(bufferSize, streamBytes)));
+
+			foreach (int messageSize in new[] { 64, 1024, 8192, 65536 })
+				results.Add(Report(Benchmarks.MessageRate(messageSize, messageCount)));
+
+			results.Add(Report(Benchmarks.FileThroughput(fileSize)));
+
+			foreach (int messageSize in new[] { 1, 1024 })
+				results.Add(Report(Benchmarks.PingPongLatency(messageSize, pingIterations, pingIterations / 10)));
+
+			foreach (int flowCount in new[] { 1, 2 })
+				results.Add(Report(Benchmarks.ImpairedThroughput(flowCount, TimeSpan.FromMilliseconds(20), 0.001, 50000000, TimeSpan.FromSeconds(quick ? 3 : 15), 1)));
+
+			return results;
+		}
+
+		static BenchmarkResult Report(BenchmarkResult result)
+		{
+			// Progress goes to stderr so stdout stays valid JSON
+			Console.Error.WriteLine("{0} {1}: {2}",
+				result.Name,
+				string.Join(" ", result.Parameters.Select(p => p.Key + "=" + p.Value)),
+				string.Join(" ", result.Metrics.Select(p => p.Key + "=" + p.Value.ToString("0.###"))));
+			return result;
+		}
+
+		static void WriteReport(TextWriter output, List<BenchmarkResult> results)
+		{
+			JsonWriter writer = new JsonWriter(output);
+
+			writer.BeginObject();
+			writer.Property("timestamp", DateTime.UtcNow.ToString("o"));
+			writer.Property("machine", Environment.MachineName);
+			writer.Property("os", Environment.OSVersion.ToString());
+			writer.Property("runtime", Environment.Version.ToString());
+			writer.Property("processor_count", Environment.ProcessorCount);
+			writer.Property("pointer_size", IntPtr.Size);
+			writer.Property("udt_protocol_version", typeof(Udt.Socket).Assembly.GetName().Version.ToString());
+
+			writer.Name("results");
+			writer.BeginArray();
+			foreach (BenchmarkResult result in results)
+				result.Write(writer);
+			writer.EndArray();
+
+			writer.EndObject();
+		}
+	}
+}
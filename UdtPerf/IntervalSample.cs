@@ -0,0 +1,61 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+namespace UdtPerf
+{
+	/// <summary>
+	/// Measurements of one stream, or the sum of all streams, over a time range.
+	/// </summary>
+	class IntervalSample
+	{
+		/// <summary>
+		/// Stream index, or <see cref="SumStream"/> for the sum of all streams.
+		/// </summary>
+		public int Stream { get; set; }
+
+		public double Start { get; set; }
+		public double End { get; set; }
+		public long Bytes { get; set; }
+		public long PacketsSent { get; set; }
+		public long PacketsReceived { get; set; }
+		public long PacketsRetransmitted { get; set; }
+		public long SendPacketsLost { get; set; }
+		public long ReceivePacketsLost { get; set; }
+		public double RttMs { get; set; }
+		public long CongestionWindow { get; set; }
+		public long FlightSize { get; set; }
+
+		public const int SumStream = -1;
+
+		public double Mbps
+		{
+			get { return End > Start ? Bytes * 8 / (End - Start) / 1000000.0 : 0; }
+		}
+
+		/// <summary>
+		/// Sum a set of per-stream samples covering the same time range.
+		/// </summary>
+		public static IntervalSample Sum(IList<IntervalSample> samples)
+		{
+			IntervalSample sum = new IntervalSample { Stream = SumStream };
+
+			if (samples.Count == 0)
+				return sum;
+
+			sum.Start = samples.Min(s => s.Start);
+			sum.End = samples.Max(s => s.End);
+			sum.Bytes = samples.Sum(s => s.Bytes);
+			sum.PacketsSent = samples.Sum(s => s.PacketsSent);
+			sum.PacketsReceived = samples.Sum(s => s.PacketsReceived);
+			sum.PacketsRetransmitted = samples.Sum(s => s.PacketsRetransmitted);
+			sum.SendPacketsLost = samples.Sum(s => s.SendPacketsLost);
+			sum.ReceivePacketsLost = samples.Sum(s => s.ReceivePacketsLost);
+			sum.RttMs = samples.Average(s => s.RttMs);
+			sum.CongestionWindow = samples.Sum(s => s.CongestionWindow);
+			sum.FlightSize = samples.Sum(s => s.FlightSize);
+			return sum;
+		}
+	}
+}
@@ -0,0 +1,188 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Linq;
+using System.Net.Sockets;
+using System.Text;
+
+namespace UdtPerf
+{
+	/// <summary>
+	/// Command line options.
+	/// </summary>
+	class PerfOptions
+	{
+		public PerfOptions()
+		{
+			Port = 9000;
+			Duration = TimeSpan.FromSeconds(10);
+			Interval = TimeSpan.FromSeconds(1);
+			Streams = 1;
+			BufferSize = 65536;
+		}
+
+		public bool IsServer { get; set; }
+		public string Host { get; set; }
+		public int Port { get; set; }
+		public TimeSpan Duration { get; set; }
+		public TimeSpan Interval { get; set; }
+		public int Streams { get; set; }
+		public bool MessageMode { get; set; }
+		public int BufferSize { get; set; }
+		public int? MaxPacketSize { get; set; }
+		public int? UdtBufferSize { get; set; }
+		public int? UdpBufferSize { get; set; }
+		public string CongestionControl { get; set; }
+		public string JsonFile { get; set; }
+		public string CsvFile { get; set; }
+
+		public SocketType SocketType
+		{
+			get { return MessageMode ? SocketType.Dgram : SocketType.Stream; }
+		}
+
+		public const string Usage =
+			"Usage: UdtPerf -s [options]\n" +
+			"       UdtPerf -c host [options]\n" +
+			"\n" +
+			"  -p, --port n          server port (default 9000)\n" +
+			"  -t, --time sec        client test duration (default 10)\n" +
+			"  -i, --interval sec    report interval (default 1)\n" +
+			"  -P, --parallel n      client parallel streams (default 1)\n" +
+			"  -m, --message         use SendMessage/ReceiveMessage on Dgram sockets\n" +
+			"  -l, --length n        send/receive buffer or message size (default 65536)\n" +
+			"      --mss n           UDT maximum packet size\n" +
+			"      --udt-buffer n    UDT send and receive buffer size\n" +
+			"      --udp-buffer n    UDP send and receive buffer size\n" +
+			"      --cc type         CongestionControl or ICongestionControlFactory type name\n" +
+			"      --json file       write summary and intervals as JSON\n" +
+			"      --csv file        write intervals as CSV\n" +
+			"\n" +
+			"Server and client must agree on -m.";
+
+		/// <summary>
+		/// Parse the command line.
+		/// </summary>
+		/// <exception cref="ArgumentException">If the arguments are not valid.</exception>
+		public static PerfOptions Parse(string[] args)
+		{
+			PerfOptions options = new PerfOptions();
+			bool modeSet = false;
+
+			for (int i = 0; i < args.Length; i++)
+			{
+				string arg = args[i];
+
+				switch (arg)
+				{
+					case "-s":
+					case "--server":
+						options.IsServer = true;
+						modeSet = true;
+						break;
+
+					case "-c":
+					case "--client":
+						options.Host = Next(args, ref i);
+						modeSet = true;
+						break;
+
+					case "-p":
+					case "--port":
+						options.Port = NextInt(args, ref i, 1, 65535);
+						break;
+
+					case "-t":
+					case "--time":
+						options.Duration = TimeSpan.FromSeconds(NextDouble(args, ref i));
+						break;
+
+					case "-i":
+					case "--interval":
+						options.Interval = TimeSpan.FromSeconds(NextDouble(args, ref i));
+						break;
+
+					case "-P":
+					case "--parallel":
+						options.Streams = NextInt(args, ref i, 1, 1024);
+						break;
+
+					case "-m":
+					case "--message":
+						options.MessageMode = true;
+						break;
+
+					case "-l":
+					case "--length":
+						options.BufferSize = NextInt(args, ref i, 1, int.MaxValue);
+						break;
+
+					case "--mss":
+						options.MaxPacketSize = NextInt(args, ref i, 76, 65536);
+						break;
+
+					case "--udt-buffer":
+						options.UdtBufferSize = NextInt(args, ref i, 1, int.MaxValue);
+						break;
+
+					case "--udp-buffer":
+						options.UdpBufferSize = NextInt(args, ref i, 1, int.MaxValue);
+						break;
+
+					case "--cc":
+						options.CongestionControl = Next(args, ref i);
+						break;
+
+					case "--json":
+						options.JsonFile = Next(args, ref i);
+						break;
+
+					case "--csv":
+						options.CsvFile = Next(args, ref i);
+						break;
+
+					default:
+						throw new ArgumentException("Unknown option: " + arg);
+				}
+			}
+
+			if (!modeSet || (options.IsServer && options.Host != null))
+				throw new ArgumentException("Exactly one of -s or -c must be given.");
+
+			if (options.Interval <= TimeSpan.Zero || options.Duration <= TimeSpan.Zero)
+				throw new ArgumentException("Time and interval must be greater than 0.");
+
+			return options;
+		}
+
+		static string Next(string[] args, ref int i)
+		{
+			if (i + 1 >= args.Length)
+				throw new ArgumentException("Missing value for " + args[i]);
+
+			return args[++i];
+		}
+
+		static int NextInt(string[] args, ref int i, int min, int max)
+		{
+			string name = args[i];
+			int value;
+
+			if (!int.TryParse(Next(args, ref i), NumberStyles.Integer, CultureInfo.InvariantCulture, out value) || value < min || value > max)
+				throw new ArgumentException(string.Format("Value for {0} must be between {1} and {2}.", name, min, max));
+
+			return value;
+		}
+
+		static double NextDouble(string[] args, ref int i)
+		{
+			string name = args[i];
+			double value;
+
+			if (!double.TryParse(Next(args, ref i), NumberStyles.Float, CultureInfo.InvariantCulture, out value))
+				throw new ArgumentException("Value for " + name + " must be a number.");
+
+			return value;
+		}
+	}
+}
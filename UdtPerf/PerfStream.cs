@@ -0,0 +1,161 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+
+namespace UdtPerf
+{
+	/// <summary>
+	/// One test connection and its counters.
+	/// </summary>
+	class PerfStream : IDisposable
+	{
+		readonly Udt.Socket _socket;
+		readonly bool _messageMode;
+		long _bytes;
+		long _sampledBytes;
+		double _sampledAt;
+
+		public PerfStream(int index, Udt.Socket socket, bool messageMode)
+		{
+			Index = index;
+			_socket = socket;
+			_messageMode = messageMode;
+		}
+
+		public int Index { get; private set; }
+
+		public Udt.Socket Socket
+		{
+			get { return _socket; }
+		}
+
+		public long Bytes
+		{
+			get { return Interlocked.Read(ref _bytes); }
+		}
+
+		/// <summary>
+		/// Send until <paramref name="stop"/> is cancelled.
+		/// </summary>
+		public void RunSender(byte[] buffer, CancellationToken stop)
+		{
+			while (!stop.IsCancellationRequested)
+			{
+				int sent = _messageMode ? _socket.SendMessage(buffer) : _socket.Send(buffer);
+				Interlocked.Add(ref _bytes, sent);
+			}
+		}
+
+		/// <summary>
+		/// Receive until the peer closes the connection.
+		/// </summary>
+		public void RunReceiver(byte[] buffer)
+		{
+			try
+			{
+				while (true)
+				{
+					int received = _messageMode ? _socket.ReceiveMessage(buffer) : _socket.Receive(buffer);
+
+					if (received <= 0)
+						break;
+
+					Interlocked.Add(ref _bytes, received);
+				}
+			}
+			catch (Udt.SocketException ex)
+			{
+				if (ex.SocketErrorCode != Udt.SocketError.ConnectionLost && ex.SocketErrorCode != Udt.SocketError.NoConnection)
+					throw;
+			}
+		}
+
+		/// <summary>
+		/// Take the counters since the previous sample.
+		/// </summary>
+		/// <param name="now">Seconds since the test started.</param>
+		public IntervalSample Sample(double now)
+		{
+			long bytes = Bytes;
+
+			IntervalSample sample = new IntervalSample
+			{
+				Stream = Index,
+				Start = _sampledAt,
+				End = now,
+				Bytes = bytes - _sampledBytes,
+			};
+
+			_sampledBytes = bytes;
+			_sampledAt = now;
+
+			try
+			{
+				// Clearing resets the local counters, so each sample is a delta
+				Udt.TraceInfo trace = _socket.GetPerformanceInfo(true);
+
+				sample.PacketsSent = trace.Local.PacketsSent;
+				sample.PacketsReceived = trace.Local.PacketsReceived;
+				sample.PacketsRetransmitted = trace.Local.PacketsRetransmitted;
+				sample.SendPacketsLost = trace.Local.SendPacketsLost;
+				sample.ReceivePacketsLost = trace.Local.ReceivePacketsLost;
+				sample.RttMs = trace.Probe.RoundtripTime.TotalMilliseconds;
+				sample.CongestionWindow = trace.Probe.CongestionWindow;
+				sample.FlightSize = trace.Probe.FlightSize;
+			}
+			catch (Udt.SocketException)
+			{
+				// Connection already gone, only the byte count is known
+			}
+			catch (ObjectDisposedException)
+			{
+			}
+
+			return sample;
+		}
+
+		/// <summary>
+		/// Totals since the connection was established.
+		/// </summary>
+		/// <param name="now">Seconds since the test started.</param>
+		public IntervalSample Total(double now)
+		{
+			IntervalSample total = new IntervalSample
+			{
+				Stream = Index,
+				Start = 0,
+				End = now,
+				Bytes = Bytes,
+			};
+
+			try
+			{
+				Udt.TraceInfo trace = _socket.GetPerformanceInfo(false);
+
+				total.PacketsSent = trace.Total.PacketsSent;
+				total.PacketsReceived = trace.Total.PacketsReceived;
+				total.PacketsRetransmitted = trace.Total.PacketsRetransmitted;
+				total.SendPacketsLost = trace.Total.SendPacketsLost;
+				total.ReceivePacketsLost = trace.Total.ReceivePacketsLost;
+				total.RttMs = trace.Probe.RoundtripTime.TotalMilliseconds;
+				total.CongestionWindow = trace.Probe.CongestionWindow;
+				total.FlightSize = trace.Probe.FlightSize;
+			}
+			catch (Udt.SocketException)
+			{
+			}
+			catch (ObjectDisposedException)
+			{
+			}
+
+			return total;
+		}
+
+		public void Dispose()
+		{
+			_socket.Dispose();
+		}
+	}
+}
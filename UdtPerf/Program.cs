@@ -0,0 +1,333 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace UdtPerf
+{
+	class Program
+	{
+		// Sent first on every stream so the server can group the streams of one test
+		const int HeaderMagic = 0x55445450; // "UDTP"
+		const int HeaderSize = 16;
+
+		static readonly object ConsoleLock = new object();
+
+		static int Main(string[] args)
+		{
+			PerfOptions options;
+
+			try
+			{
+				options = PerfOptions.Parse(args);
+			}
+			catch (ArgumentException ex)
+			{
+				Console.Error.WriteLine(ex.Message);
+				Console.WriteLine(PerfOptions.Usage);
+				return 1;
+			}
+
+			try
+			{
+				if (options.IsServer)
+					RunServer(options);
+				else
+					RunClient(options);
+
+				return 0;
+			}
+			catch (Exception ex)
+			{
+				Console.Error.WriteLine("Error: {0}", ex.Message);
+				return 2;
+			}
+		}
+
+		static void RunClient(PerfOptions options)
+		{
+			IPAddress[] addresses = Dns.GetHostAddresses(options.Host);
+			int session = new Random().Next();
+			List<PerfStream> streams = new List<PerfStream>();
+
+			try
+			{
+				for (int i = 0; i < options.Streams; i++)
+				{
+					Udt.Socket socket = CreateSocket(options, addresses[0].AddressFamily);
+					streams.Add(new PerfStream(i, socket, options.MessageMode));
+
+					socket.Connect(addresses, options.Port);
+					SendHeader(socket, options.MessageMode, session, i, options.Streams);
+				}
+
+				Console.WriteLine("Connected to {0}, {1} stream(s), {2} mode, {3} byte buffers",
+					streams[0].Socket.RemoteEndPoint, options.Streams, options.MessageMode ? "message" : "stream", options.BufferSize);
+
+				byte[] buffer = new byte[options.BufferSize];
+				new Random(0).NextBytes(buffer);
+
+				using (CancellationTokenSource stop = new CancellationTokenSource())
+				{
+					Stopwatch clock = Stopwatch.StartNew();
+					Task[] senders = streams.Select(s => Task.Factory.StartNew(() => s.RunSender(buffer, stop.Token), TaskCreationOptions.LongRunning)).ToArray();
+
+					Reporter reporter = new Reporter(options, "client", ConsoleLock);
+					ReportIntervals(reporter, streams, clock, options.Interval, () => clock.Elapsed >= options.Duration || senders.Any(t => t.IsCompleted));
+
+					stop.Cancel();
+					Task.WaitAll(senders);
+
+					double elapsed = clock.Elapsed.TotalSeconds;
+					reporter.Summary(streams.Select(s => s.Total(elapsed)).ToList());
+				}
+			}
+			finally
+			{
+				foreach (PerfStream stream in streams)
+					stream.Dispose();
+			}
+		}
+
+		static void RunServer(PerfOptions options)
+		{
+			using (Udt.Socket listener = CreateSocket(options, AddressFamily.InterNetwork))
+			{
+				listener.Bind(IPAddress.Any, options.Port);
+				listener.Listen(64);
+
+				Console.WriteLine("Server listening on UDT port {0}, {1} mode", options.Port, options.MessageMode ? "message" : "stream");
+
+				Dictionary<int, ServerSession> sessions = new Dictionary<int, ServerSession>();
+
+				while (true)
+				{
+					Udt.Socket socket = listener.Accept();
+					Task.Factory.StartNew(() => HandleServerStream(options, sessions, socket), TaskCreationOptions.LongRunning);
+				}
+			}
+		}
+
+		static void HandleServerStream(PerfOptions options, Dictionary<int, ServerSession> sessions, Udt.Socket socket)
+		{
+			try
+			{
+				int session, index, count;
+				ReceiveHeader(socket, options.MessageMode, out session, out index, out count);
+
+				PerfStream stream = new PerfStream(index, socket, options.MessageMode);
+				ServerSession serverSession;
+
+				lock (sessions)
+				{
+					if (!sessions.TryGetValue(session, out serverSession))
+					{
+						serverSession = new ServerSession(count);
+						sessions.Add(session, serverSession);
+
+						lock (ConsoleLock)
+							Console.WriteLine("Accepted test from {0}, {1} stream(s)", socket.RemoteEndPoint, count);
+
+						ServerSession started = serverSession;
+						Task.Factory.StartNew(() =>
+						{
+							started.Report(options, ConsoleLock);
+
+							lock (sessions)
+								sessions.Remove(session);
+						}, TaskCreationOptions.LongRunning);
+					}
+				}
+
+				serverSession.Add(stream);
+
+				try
+				{
+					stream.RunReceiver(new byte[Math.Max(options.BufferSize, HeaderSize)]);
+				}
+				finally
+				{
+					serverSession.Finished();
+				}
+			}
+			catch (Exception ex)
+			{
+				lock (ConsoleLock)
+					Console.Error.WriteLine("Stream error: {0}", ex.Message);
+
+				socket.Dispose();
+			}
+		}
+
+		static void ReportIntervals(Reporter reporter, IList<PerfStream> streams, Stopwatch clock, TimeSpan interval, Func<bool> done)
+		{
+			TimeSpan next = interval;
+
+			while (!done())
+			{
+				TimeSpan wait = next - clock.Elapsed;
+
+				if (wait > TimeSpan.Zero)
+				{
+					Thread.Sleep(wait < TimeSpan.FromMilliseconds(100) ? wait : TimeSpan.FromMilliseconds(100));
+					continue;
+				}
+
+				double now = clock.Elapsed.TotalSeconds;
+				reporter.Interval(streams.Select(s => s.Sample(now)).ToList());
+				next += interval;
+			}
+
+			double end = clock.Elapsed.TotalSeconds;
+			List<IntervalSample> last = streams.Select(s => s.Sample(end)).ToList();
+
+			if (last.Any(s => s.End > s.Start))
+				reporter.Interval(last);
+		}
+
+		static Udt.Socket CreateSocket(PerfOptions options, AddressFamily family)
+		{
+			Udt.Socket socket = new Udt.Socket(family, options.SocketType);
+
+			try
+			{
+				if (options.MaxPacketSize.HasValue)
+					socket.MaxPacketSize = options.MaxPacketSize.Value;
+
+				if (options.UdtBufferSize.HasValue)
+				{
+					socket.SendBufferSize = options.UdtBufferSize.Value;
+					socket.ReceiveBufferSize = options.UdtBufferSize.Value;
+				}
+
+				if (options.UdpBufferSize.HasValue)
+				{
+					socket.UdpSendBufferSize = options.UdpBufferSize.Value;
+					socket.UdpReceiveBufferSize = options.UdpBufferSize.Value;
+				}
+
+				if (options.CongestionControl != null)
+					socket.CongestionControl = CreateCongestionControl(options.CongestionControl);
+			}
+			catch
+			{
+				socket.Dispose();
+				throw;
+			}
+
+			return socket;
+		}
+
+		static Udt.ICongestionControlFactory CreateCongestionControl(string typeName)
+		{
+			Type type = Type.GetType(typeName, true);
+
+			if (typeof(Udt.ICongestionControlFactory).IsAssignableFrom(type))
+				return (Udt.ICongestionControlFactory)Activator.CreateInstance(type);
+
+			if (typeof(Udt.CongestionControl).IsAssignableFrom(type))
+				return new Udt.CongestionControlFactory(() => (Udt.CongestionControl)Activator.CreateInstance(type));
+
+			throw new ArgumentException(typeName + " is not a CongestionControl or ICongestionControlFactory.");
+		}
+
+		static void SendHeader(Udt.Socket socket, bool messageMode, int session, int index, int count)
+		{
+			byte[] header = new byte[HeaderSize];
+			BitConverter.GetBytes(HeaderMagic).CopyTo(header, 0);
+			BitConverter.GetBytes(session).CopyTo(header, 4);
+			BitConverter.GetBytes(index).CopyTo(header, 8);
+			BitConverter.GetBytes(count).CopyTo(header, 12);
+
+			if (messageMode)
+				socket.SendMessage(header);
+			else
+				socket.Send(header);
+		}
+
+		static void ReceiveHeader(Udt.Socket socket, bool messageMode, out int session, out int index, out int count)
+		{
+			byte[] header = new byte[HeaderSize];
+			int received = 0;
+
+			if (messageMode)
+			{
+				received = socket.ReceiveMessage(header);
+			}
+			else
+			{
+				while (received < HeaderSize)
+					received += socket.Receive(header, received, HeaderSize - received);
+			}
+
+			if (received != HeaderSize || BitConverter.ToInt32(header, 0) != HeaderMagic)
+				throw new InvalidDataException("Peer is not a UdtPerf client in the same mode.");
+
+			session = BitConverter.ToInt32(header, 4);
+			index = BitConverter.ToInt32(header, 8);
+			count = BitConverter.ToInt32(header, 12);
+		}
+
+		/// <summary>
+		/// Streams of one client test, reported together.
+		/// </summary>
+		class ServerSession
+		{
+			readonly int _expected;
+			readonly List<PerfStream> _streams = new List<PerfStream>();
+			readonly Stopwatch _clock = Stopwatch.StartNew();
+			int _finished;
+
+			public ServerSession(int expected)
+			{
+				_expected = expected;
+			}
+
+			public void Add(PerfStream stream)
+			{
+				lock (_streams)
+					_streams.Add(stream);
+			}
+
+			public void Finished()
+			{
+				Interlocked.Increment(ref _finished);
+			}
+
+			public void Report(PerfOptions options, object consoleLock)
+			{
+				Reporter reporter = new Reporter(options, "server", consoleLock);
+				List<PerfStream> streams;
+
+				// Wait for late streams, give up on them after one interval
+				while (true)
+				{
+					lock (_streams)
+					{
+						if (_streams.Count >= _expected || _clock.Elapsed >= options.Interval)
+						{
+							streams = _streams.OrderBy(s => s.Index).ToList();
+							break;
+						}
+					}
+
+					Thread.Sleep(10);
+				}
+
+				ReportIntervals(reporter, streams, _clock, options.Interval, () => Thread.VolatileRead(ref _finished) >= streams.Count);
+
+				double elapsed = _clock.Elapsed.TotalSeconds;
+				reporter.Summary(streams.Select(s => s.Total(elapsed)).ToList());
+
+				foreach (PerfStream stream in streams)
+					stream.Dispose();
+			}
+		}
+	}
+}
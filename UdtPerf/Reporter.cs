@@ -0,0 +1,187 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Text;
+using UdtBenchmark;
+
+namespace UdtPerf
+{
+	/// <summary>
+	/// Prints interval reports and writes the JSON/CSV result files.
+	/// </summary>
+	class Reporter
+	{
+		readonly PerfOptions _options;
+		readonly string _role;
+		readonly List<IntervalSample> _intervals = new List<IntervalSample>();
+		readonly object _consoleLock;
+
+		public Reporter(PerfOptions options, string role, object consoleLock)
+		{
+			_options = options;
+			_role = role;
+			_consoleLock = consoleLock;
+		}
+
+		/// <summary>
+		/// Report one interval for every stream, plus the sum when there is
+		/// more than one stream.
+		/// </summary>
+		public void Interval(IList<IntervalSample> samples)
+		{
+			lock (_consoleLock)
+			{
+				foreach (IntervalSample sample in samples)
+					Print(sample);
+
+				_intervals.AddRange(samples);
+
+				if (samples.Count > 1)
+				{
+					IntervalSample sum = IntervalSample.Sum(samples);
+					Print(sum);
+					_intervals.Add(sum);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Report the totals and write the result files.
+		/// </summary>
+		public void Summary(IList<IntervalSample> totals)
+		{
+			IntervalSample sum = IntervalSample.Sum(totals);
+
+			lock (_consoleLock)
+			{
+				Console.WriteLine("- - - - - - - - - - - - - - - - - - - - - - - - -");
+
+				foreach (IntervalSample total in totals)
+					Print(total);
+
+				if (totals.Count > 1)
+					Print(sum);
+			}
+
+			if (_options.JsonFile != null)
+				WriteJson(totals, sum);
+
+			if (_options.CsvFile != null)
+				WriteCsv();
+		}
+
+		static void Print(IntervalSample sample)
+		{
+			Console.WriteLine(
+				"[{0,4}] {1,6:0.00}-{2,-6:0.00} sec {3,10:0.00} MBytes {4,10:0.00} Mbits/sec  retr {5}  loss {6}/{7}  rtt {8:0.000} ms  cwnd {9}",
+				sample.Stream == IntervalSample.SumStream ? "SUM" : sample.Stream.ToString(CultureInfo.InvariantCulture),
+				sample.Start,
+				sample.End,
+				sample.Bytes / 1048576.0,
+				sample.Mbps,
+				sample.PacketsRetransmitted,
+				sample.SendPacketsLost,
+				sample.ReceivePacketsLost,
+				sample.RttMs,
+				sample.CongestionWindow);
+		}
+
+		void WriteJson(IList<IntervalSample> totals, IntervalSample sum)
+		{
+			using (StreamWriter output = new StreamWriter(_options.JsonFile, false, new UTF8Encoding(false)))
+			{
+				JsonWriter writer = new JsonWriter(output);
+
+				writer.BeginObject();
+				writer.Property("role", _role);
+				writer.Property("timestamp", DateTime.UtcNow.ToString("o"));
+
+				writer.Name("options");
+				writer.BeginObject();
+				writer.Property("mode", _options.MessageMode ? "message" : "stream");
+				writer.Property("streams", totals.Count);
+				writer.Property("length", _options.BufferSize);
+				writer.Property("duration", _options.Duration.TotalSeconds);
+				writer.Property("interval", _options.Interval.TotalSeconds);
+				if (_options.MaxPacketSize.HasValue)
+					writer.Property("mss", _options.MaxPacketSize.Value);
+				if (_options.UdtBufferSize.HasValue)
+					writer.Property("udt_buffer", _options.UdtBufferSize.Value);
+				if (_options.UdpBufferSize.HasValue)
+					writer.Property("udp_buffer", _options.UdpBufferSize.Value);
+				writer.Property("congestion_control", _options.CongestionControl ?? "native");
+				writer.EndObject();
+
+				writer.Name("intervals");
+				writer.BeginArray();
+				foreach (IntervalSample sample in _intervals)
+					WriteSample(writer, sample);
+				writer.EndArray();
+
+				writer.Name("streams");
+				writer.BeginArray();
+				foreach (IntervalSample total in totals)
+					WriteSample(writer, total);
+				writer.EndArray();
+
+				writer.Name("summary");
+				WriteSample(writer, sum);
+
+				writer.EndObject();
+				output.WriteLine();
+			}
+		}
+
+		static void WriteSample(JsonWriter writer, IntervalSample sample)
+		{
+			writer.BeginObject();
+			writer.Name("stream");
+			if (sample.Stream == IntervalSample.SumStream)
+				writer.Value("sum");
+			else
+				writer.Value(sample.Stream);
+			writer.Property("start", sample.Start);
+			writer.Property("end", sample.End);
+			writer.Property("bytes", sample.Bytes);
+			writer.Property("mbps", sample.Mbps);
+			writer.Property("packets_sent", sample.PacketsSent);
+			writer.Property("packets_received", sample.PacketsReceived);
+			writer.Property("packets_retransmitted", sample.PacketsRetransmitted);
+			writer.Property("send_packets_lost", sample.SendPacketsLost);
+			writer.Property("receive_packets_lost", sample.ReceivePacketsLost);
+			writer.Property("rtt_ms", sample.RttMs);
+			writer.Property("congestion_window", sample.CongestionWindow);
+			writer.Property("flight_size", sample.FlightSize);
+			writer.EndObject();
+		}
+
+		void WriteCsv()
+		{
+			using (StreamWriter output = new StreamWriter(_options.CsvFile, false, new UTF8Encoding(false)))
+			{
+				output.WriteLine("stream,start,end,bytes,mbps,packets_sent,packets_received,packets_retransmitted,send_packets_lost,receive_packets_lost,rtt_ms,congestion_window,flight_size");
+
+				foreach (IntervalSample sample in _intervals)
+				{
+					output.WriteLine(string.Format(CultureInfo.InvariantCulture,
+						"{0},{1:0.000},{2:0.000},{3},{4:0.000},{5},{6},{7},{8},{9},{10:0.000},{11},{12}",
+						sample.Stream == IntervalSample.SumStream ? "sum" : sample.Stream.ToString(CultureInfo.InvariantCulture),
+						sample.Start,
+						sample.End,
+						sample.Bytes,
+						sample.Mbps,
+						sample.PacketsSent,
+						sample.PacketsReceived,
+						sample.PacketsRetransmitted,
+						sample.SendPacketsLost,
+						sample.ReceivePacketsLost,
+						sample.RttMs,
+						sample.CongestionWindow,
+						sample.FlightSize));
+				}
+			}
+		}
+	}
+}
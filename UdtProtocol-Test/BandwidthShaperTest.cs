@@ -0,0 +1,163 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Net.Sockets;
+
+using NUnit.Framework;
+using System.Net;
+using System.Diagnostics;
+using System.Threading.Tasks;
+
+namespace UdtProtocol_Test
+{
+    [TestFixture]
+    public class BandwidthShaperTest
+    {
+        [Test]
+        public void Constructor()
+        {
+            using (Udt.BandwidthShaper root = new Udt.BandwidthShaper(1000000))
+            using (Udt.BandwidthShaper tenant = new Udt.BandwidthShaper(root, 100000, 500000))
+            {
+                Assert.IsNull(root.Parent);
+                Assert.AreEqual(1000000, root.Rate);
+                Assert.AreEqual(1000000, root.Ceiling);
+                Assert.AreEqual(Udt.BandwidthShaper.SendChunkSize, root.Burst);
+
+                Assert.AreSame(root, tenant.Parent);
+                Assert.AreEqual(100000, tenant.Rate);
+                Assert.AreEqual(500000, tenant.Ceiling);
+                Assert.AreEqual(0, tenant.BytesSent);
+                Assert.AreEqual(0, tenant.BytesBorrowed);
+                Assert.AreEqual(0, tenant.ThrottleCount);
+            }
+        }
+
+        [Test]
+        public void Constructor_invalid_args()
+        {
+            Assert.Throws<ArgumentOutOfRangeException>(() => new Udt.BandwidthShaper(0));
+            Assert.Throws<ArgumentNullException>(() => new Udt.BandwidthShaper(null, 1, 1));
+
+            using (Udt.BandwidthShaper root = new Udt.BandwidthShaper(1000))
+            {
+                Assert.Throws<ArgumentOutOfRangeException>(() => new Udt.BandwidthShaper(root, -1, 1));
+                Assert.Throws<ArgumentOutOfRangeException>(() => new Udt.BandwidthShaper(root, 0, 0));
+                Assert.Throws<ArgumentOutOfRangeException>(() => new Udt.BandwidthShaper(root, 10, 5));
+
+                root.Dispose();
+                Assert.Throws<ObjectDisposedException>(() => new Udt.BandwidthShaper(root, 1, 1));
+            }
+        }
+
+        [Test]
+        public void Set_rates()
+        {
+            using (Udt.BandwidthShaper root = new Udt.BandwidthShaper(1000))
+            using (Udt.BandwidthShaper child = new Udt.BandwidthShaper(root, 100, 200))
+            {
+                root.Rate = 2000;
+                Assert.AreEqual(2000, root.Ceiling);
+                Assert.Throws<InvalidOperationException>(() => root.Ceiling = 3000);
+
+                child.Ceiling = 500;
+                child.Rate = 500;
+                Assert.AreEqual(500, child.Rate);
+                Assert.Throws<ArgumentOutOfRangeException>(() => child.Rate = 501);
+                Assert.Throws<ArgumentOutOfRangeException>(() => child.Ceiling = 499);
+
+                child.Burst = 100000;
+                Assert.AreEqual(100000, child.Burst);
+                Assert.Throws<ArgumentOutOfRangeException>(() => child.Burst = 0);
+
+                child.Dispose();
+                Assert.Throws<ObjectDisposedException>(() => { long rate = child.Rate; });
+            }
+        }
+
+        [Test]
+        public void Send_is_shaped_and_borrows_idle_share()
+        {
+            const int rate = 1024 * 1024;
+            byte[] data = new byte[512 * 1024];
+
+            using (Udt.BandwidthShaper root = new Udt.BandwidthShaper(rate))
+            using (Udt.BandwidthShaper idle = new Udt.BandwidthShaper(root, rate / 2, rate))
+            using (Udt.BandwidthShaper busy = new Udt.BandwidthShaper(root, rate / 2, rate))
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+                client.Connect(listener.LocalEndPoint);
+                client.Shaper = busy;
+                Assert.AreSame(busy, client.Shaper);
+
+                using (Udt.Socket server = listener.Accept())
+                {
+                    Task receiver = Task.Factory.StartNew(() =>
+                    {
+                        byte[] received = new byte[data.Length];
+                        int total = 0;
+                        while (total < received.Length)
+                            total += server.Receive(received, total, received.Length - total);
+                    });
+
+                    Stopwatch watch = Stopwatch.StartNew();
+                    client.Send(data);
+                    watch.Stop();
+
+                    Assert.IsTrue(receiver.Wait(TimeSpan.FromSeconds(30)));
+
+                    // Half a second at the full rate, less the initial burst
+                    Assert.Greater(watch.Elapsed, TimeSpan.FromMilliseconds(300));
+                }
+
+                Assert.AreEqual(data.Length, busy.BytesSent);
+                Assert.AreEqual(data.Length, root.BytesSent);
+                Assert.AreEqual(0, idle.BytesSent);
+                Assert.Greater(busy.BytesBorrowed, 0);
+                Assert.Greater(busy.ThrottleCount, 0);
+                // Once per shaped chunk at most, however often it polled
+                Assert.LessOrEqual(busy.ThrottleCount, data.Length / Udt.BandwidthShaper.SendChunkSize);
+            }
+        }
+
+        [Test]
+        public void Close_while_send_waits_for_disposed_shaper()
+        {
+            using (Udt.BandwidthShaper root = new Udt.BandwidthShaper(64 * 1024))
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+                client.Connect(listener.LocalEndPoint);
+                client.Shaper = root;
+
+                using (Udt.Socket server = listener.Accept())
+                {
+                    Task sender = Task.Factory.StartNew(() =>
+                    {
+                        try
+                        {
+                            client.Send(new byte[256 * 1024]);
+                        }
+                        catch (Udt.SocketException)
+                        {
+                            // Socket closed under the send
+                        }
+                    });
+
+                    System.Threading.Thread.Sleep(200);
+
+                    // The waiting send keeps the shaper's node alive
+                    root.Dispose();
+                    client.Close();
+                    Assert.IsTrue(sender.Wait(TimeSpan.FromSeconds(30)));
+                }
+            }
+        }
+    }
+}
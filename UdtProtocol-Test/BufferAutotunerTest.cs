@@ -0,0 +1,158 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Net.Sockets;
+
+using NUnit.Framework;
+using System.Net;
+using System.Threading.Tasks;
+
+namespace UdtProtocol_Test
+{
+    [TestFixture]
+    public class BufferAutotunerTest
+    {
+        [Test]
+        public void Constructor()
+        {
+            Udt.BufferAutotuner tuner = new Udt.BufferAutotuner();
+            Assert.AreEqual(Udt.BufferAutotuner.DefaultMinimumBufferSize, tuner.MinimumBufferSize);
+            Assert.AreEqual(Udt.BufferAutotuner.DefaultMaximumBufferSize, tuner.MaximumBufferSize);
+            Assert.AreEqual(Udt.BufferAutotuner.DefaultFactor, tuner.Factor);
+            Assert.AreEqual(0, tuner.Count);
+        }
+
+        [Test]
+        public void Set_limits()
+        {
+            Udt.BufferAutotuner tuner = new Udt.BufferAutotuner();
+
+            tuner.MaximumBufferSize = 1024 * 1024;
+            tuner.MinimumBufferSize = 1024;
+            tuner.Factor = 1.5;
+            Assert.AreEqual(1024 * 1024, tuner.MaximumBufferSize);
+            Assert.AreEqual(1024, tuner.MinimumBufferSize);
+            Assert.AreEqual(1.5, tuner.Factor);
+
+            Assert.Throws<ArgumentOutOfRangeException>(() => tuner.MinimumBufferSize = 0);
+            Assert.Throws<ArgumentOutOfRangeException>(() => tuner.MinimumBufferSize = 2 * 1024 * 1024);
+            Assert.Throws<ArgumentOutOfRangeException>(() => tuner.MaximumBufferSize = 1023);
+            Assert.Throws<ArgumentOutOfRangeException>(() => tuner.Factor = 0);
+            Assert.Throws<ArgumentOutOfRangeException>(() => tuner.Factor = double.NaN);
+        }
+
+        [Test]
+        public void Unknown_host_is_not_tuned()
+        {
+            Udt.BufferAutotuner tuner = new Udt.BufferAutotuner();
+
+            using (Udt.Socket socket = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                int sendBuffer = socket.SendBufferSize;
+
+                Assert.AreEqual(0, tuner.GetBufferSize(IPAddress.Loopback));
+                Assert.IsFalse(tuner.Apply(socket, IPAddress.Loopback));
+                Assert.AreEqual(sendBuffer, socket.SendBufferSize);
+
+                Assert.Throws<ArgumentNullException>(() => tuner.Apply(null, IPAddress.Loopback));
+                Assert.Throws<ArgumentNullException>(() => tuner.Apply(socket, null));
+                Assert.Throws<ArgumentNullException>(() => tuner.Observe(null));
+
+                // Not connected
+                tuner.Observe(socket);
+                Assert.AreEqual(0, tuner.Count);
+            }
+        }
+
+        [Test]
+        public void Closed_connection_tunes_next_socket()
+        {
+            Udt.BufferAutotuner tuner = new Udt.BufferAutotuner();
+
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+                Transfer(tuner, listener);
+
+                Assert.AreEqual(1, tuner.Count);
+
+                int size = tuner.GetBufferSize(IPAddress.Loopback);
+                Assert.GreaterOrEqual(size, tuner.MinimumBufferSize);
+                Assert.LessOrEqual(size, tuner.MaximumBufferSize);
+
+                using (Udt.Socket next = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+                {
+                    Assert.IsTrue(tuner.Apply(next, IPAddress.Loopback));
+                    // UDT keeps its own buffers in whole packets
+                    Assert.LessOrEqual(Math.Abs(size - next.SendBufferSize), next.MaxPacketSize);
+                    Assert.AreEqual(size, next.UdpReceiveBufferSize);
+                }
+            }
+        }
+
+        [Test]
+        public void Bound_socket_keeps_buffers()
+        {
+            Udt.BufferAutotuner tuner = new Udt.BufferAutotuner();
+
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+                Transfer(tuner, listener);
+
+                using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+                {
+                    client.Bind(IPAddress.Loopback, 0);
+                    int sendBuffer = client.SendBufferSize;
+                    int udpReceiveBuffer = client.UdpReceiveBufferSize;
+
+                    // UDT no longer accepts buffer sizes, only the flow window is tuned
+                    Assert.IsTrue(tuner.Apply(client, IPAddress.Loopback));
+                    Assert.AreEqual(sendBuffer, client.SendBufferSize);
+                    Assert.AreEqual(udpReceiveBuffer, client.UdpReceiveBufferSize);
+
+                    client.Autotuner = tuner;
+                    client.Connect(listener.LocalEndPoint);
+
+                    using (Udt.Socket server = listener.Accept())
+                    {
+                        Assert.AreEqual(Udt.SocketState.Connected, client.State);
+                        Assert.AreEqual(sendBuffer, client.SendBufferSize);
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// Send 1 MB over a connection to <paramref name="listener"/> from
+        /// a socket using <paramref name="tuner"/>.
+        /// </summary>
+        private static void Transfer(Udt.BufferAutotuner tuner, Udt.Socket listener)
+        {
+            using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                client.Autotuner = tuner;
+                Assert.AreSame(tuner, client.Autotuner);
+                client.Connect(listener.LocalEndPoint);
+
+                using (Udt.Socket server = listener.Accept())
+                {
+                    byte[] data = new byte[1024 * 1024];
+
+                    Task receiver = Task.Factory.StartNew(() =>
+                    {
+                        int total = 0;
+                        while (total < data.Length)
+                            total += server.Receive(data, total, data.Length - total);
+                    });
+
+                    client.Send(data);
+                    Assert.IsTrue(receiver.Wait(TimeSpan.FromSeconds(30)));
+                }
+            }
+        }
+    }
+}
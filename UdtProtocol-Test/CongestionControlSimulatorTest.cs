@@ -0,0 +1,226 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+using NUnit.Framework;
+
+namespace UdtProtocol_Test
+{
+    [TestFixture]
+    public class CongestionControlSimulatorTest
+    {
+        [Test]
+        public void Constructor__InvalidArgs()
+        {
+            ArgumentException argEx = Assert.Throws<ArgumentNullException>(() => new Udt.CongestionControlSimulator(null));
+            Assert.AreEqual("factory", argEx.ParamName);
+        }
+
+        [Test]
+        public void Properties__InvalidArgs()
+        {
+            Udt.CongestionControlSimulator simulator = CreateSimulator(() => new FixedWindow(10));
+
+            Assert.Throws<ArgumentOutOfRangeException>(() => simulator.Bandwidth = 0);
+            Assert.Throws<ArgumentOutOfRangeException>(() => simulator.Delay = TimeSpan.FromTicks(-1));
+            Assert.Throws<ArgumentOutOfRangeException>(() => simulator.QueueLimit = 0);
+            Assert.Throws<ArgumentOutOfRangeException>(() => simulator.LossRate = 1.5);
+            Assert.Throws<ArgumentOutOfRangeException>(() => simulator.MaxPacketSize = 44);
+            Assert.Throws<ArgumentOutOfRangeException>(() => simulator.SampleInterval = TimeSpan.Zero);
+            Assert.Throws<ArgumentOutOfRangeException>(() => simulator.Run(TimeSpan.Zero));
+        }
+
+        [Test]
+        public void Window_of_one_bdp_fills_link()
+        {
+            // 10 Mbit/s * 50 ms / 1500 bytes = ~42 packets
+            Udt.CongestionControlSimulator simulator = CreateSimulator(() => new FixedWindow(50));
+            Udt.SimulationResult result = simulator.Run(TimeSpan.FromSeconds(10));
+
+            Assert.AreEqual(0, result.PacketsDropped);
+            Assert.AreEqual(0, result.PacketsRetransmitted);
+            Assert.Greater(result.Utilization, 0.9);
+            Assert.LessOrEqual(result.Utilization, 1.0);
+            Assert.AreEqual(1001, result.Samples.Count);
+            Assert.AreEqual(50, result.Samples.Last().WindowSize);
+        }
+
+        [Test]
+        public void Oversized_window_overflows_queue()
+        {
+            Udt.CongestionControlSimulator simulator = CreateSimulator(() => new FixedWindow(1000));
+            simulator.QueueLimit = 20;
+
+            Udt.SimulationResult result = simulator.Run(TimeSpan.FromSeconds(5));
+
+            Assert.Greater(result.PacketsDropped, 0);
+            Assert.Greater(result.PacketsRetransmitted, 0);
+            Assert.IsTrue(result.Samples.All(s => s.QueueLength <= 20));
+        }
+
+        [Test]
+        public void Loss_and_ack_events_reach_congestion_control()
+        {
+            List<Aimd> instances = new List<Aimd>();
+            Udt.CongestionControlSimulator simulator = CreateSimulator(() =>
+            {
+                Aimd cc = new Aimd();
+                instances.Add(cc);
+                return cc;
+            });
+            simulator.LossRate = 0.01;
+
+            Udt.SimulationResult result = simulator.Run(TimeSpan.FromSeconds(30));
+
+            Assert.AreEqual(1, instances.Count);
+            Assert.IsTrue(instances[0].Initialized);
+            Assert.IsTrue(instances[0].Closed);
+            Assert.Greater(instances[0].Acks, 0);
+            Assert.Greater(instances[0].Losses, 0);
+            Assert.Greater(result.PacketsLost, 0);
+            Assert.Greater(result.PacketsDelivered, 0);
+
+            // Each loss event halves the window
+            double peak = result.Samples.Max(s => s.WindowSize);
+            Assert.Less(result.Samples.Where(s => s.Time > TimeSpan.FromSeconds(1)).Min(s => s.WindowSize), peak / 2 + 1);
+        }
+
+        [Test]
+        public void Same_seed_gives_same_trajectory()
+        {
+            Udt.CongestionControlSimulator simulator = CreateSimulator(() => new Aimd());
+            simulator.LossRate = 0.02;
+            simulator.Seed = 5;
+
+            Udt.SimulationResult first = simulator.Run(TimeSpan.FromSeconds(10));
+            Udt.SimulationResult second = simulator.Run(TimeSpan.FromSeconds(10));
+
+            Assert.AreEqual(first.PacketsDelivered, second.PacketsDelivered);
+            Assert.AreEqual(first.PacketsLost, second.PacketsLost);
+            CollectionAssert.AreEqual(first.Samples.Select(s => s.WindowSize).ToList(), second.Samples.Select(s => s.WindowSize).ToList());
+
+            simulator.Seed = 6;
+            Assert.AreNotEqual(first.PacketsLost, simulator.Run(TimeSpan.FromSeconds(10)).PacketsLost);
+        }
+
+        [Test]
+        public void Ack_info_carries_receiver_feedback()
+        {
+            AckRecorder recorder = new AckRecorder();
+            Udt.SimulationResult result = CreateSimulator(() => recorder).Run(TimeSpan.FromSeconds(5));
+
+            Udt.AckInfo last = recorder.Last;
+            Assert.Greater(recorder.Acks, 0);
+            Assert.Greater(last.AcknowledgedPacket, 0);
+            Assert.GreaterOrEqual(last.RoundtripTime, TimeSpan.FromMilliseconds(50));
+            Assert.Less(last.RoundtripTime, TimeSpan.FromMilliseconds(200));
+            Assert.GreaterOrEqual(last.RoundtripTimeVariance, TimeSpan.Zero);
+            Assert.Greater(last.ReceiveRate, 0);
+            Assert.Greater(last.Bandwidth, 0);
+        }
+
+        [Test]
+        public void Native_plugin_is_simulated()
+        {
+            using (Udt.NativeCongestionControlFactory factory = new Udt.NativeCongestionControlFactory(
+                typeof(Udt.Socket).Assembly.Location, Udt.NativeCongestionControlFactory.BuiltInEntryPoint))
+            {
+                Udt.SimulationResult result = new Udt.CongestionControlSimulator(factory).Run(TimeSpan.FromSeconds(5));
+
+                // UDT's own algorithm starts at a window of 16 and grows it in slow start
+                Assert.Greater(result.PacketsDelivered, 0);
+                Assert.Greater(result.Samples.Max(s => s.WindowSize), 16);
+            }
+        }
+
+        [Test]
+        public void Group_member_is_simulated()
+        {
+            using (Udt.CongestionControlGroup group = new Udt.CongestionControlGroup())
+            {
+                Udt.SimulationResult result = new Udt.CongestionControlSimulator(group).Run(TimeSpan.FromSeconds(5));
+
+                Assert.Greater(result.PacketsDelivered, 0);
+                Assert.Greater(result.Samples.Max(s => s.WindowSize), 16);
+                Assert.AreEqual(0, group.MemberCount);
+            }
+        }
+
+        static Udt.CongestionControlSimulator CreateSimulator(Func<Udt.CongestionControl> create)
+        {
+            return new Udt.CongestionControlSimulator(new Udt.CongestionControlFactory(create));
+        }
+
+        class FixedWindow : Udt.CongestionControl
+        {
+            readonly int _window;
+
+            public FixedWindow(int window)
+            {
+                _window = window;
+            }
+
+            public override void Initialize()
+            {
+                WindowSize = _window;
+                PacketSendPeriod = TimeSpan.Zero;
+            }
+        }
+
+        class AckRecorder : Udt.CongestionControl
+        {
+            public int Acks;
+            public Udt.AckInfo Last;
+
+            public override void Initialize()
+            {
+                WindowSize = 20;
+                PacketSendPeriod = TimeSpan.Zero;
+            }
+
+            public override void OnAck(Udt.AckInfo ack)
+            {
+                Acks++;
+                Last = ack;
+            }
+        }
+
+        class Aimd : Udt.CongestionControl
+        {
+            public bool Initialized;
+            public bool Closed;
+            public int Acks;
+            public int Losses;
+
+            public override void Initialize()
+            {
+                Initialized = true;
+                WindowSize = 2;
+                PacketSendPeriod = TimeSpan.Zero;
+            }
+
+            public override void Close()
+            {
+                Closed = true;
+            }
+
+            public override void OnAck(int ack)
+            {
+                Acks++;
+                WindowSize = WindowSize + 1;
+            }
+
+            public override void OnLoss(IList<int> lossList)
+            {
+                Losses++;
+                WindowSize = Math.Max(2, WindowSize / 2);
+            }
+
+            public override void OnTimeout()
+            {
+                WindowSize = 2;
+            }
+        }
+    }
+}
@@ -392,5 +392,51 @@ namespace UdtProtocol_Test
 
 			packet.Dispose();
 		}
+
+		[Test]
+		public void Header_and_data()
+		{
+			DataPacket packet = new DataPacket();
+			Assert.AreEqual(IntPtr.Zero, packet.Data);
+
+			packet.PacketNumber = 12;
+			packet.MessageNumber = 34;
+			packet.MessageBoundary = MessageBoundary.First;
+			packet.InOrder = true;
+			packet.TimeStamp = TimeSpan.FromMilliseconds(5);
+			packet.DestinationId = 56;
+			packet.Write(0, new byte[] { 0x01, 0x02, 0x03 }, 0, 3);
+
+			DataPacketHeader header = packet.Header;
+			Assert.AreEqual(12, header.PacketNumber);
+			Assert.AreEqual(34, header.MessageNumber);
+			Assert.AreEqual(MessageBoundary.First, header.MessageBoundary);
+			Assert.IsTrue(header.InOrder);
+			Assert.AreEqual(TimeSpan.FromMilliseconds(5), header.TimeStamp);
+			Assert.AreEqual(56, header.DestinationId);
+			Assert.AreEqual(3, header.DataLength);
+
+			Assert.AreEqual(0x02, System.Runtime.InteropServices.Marshal.ReadByte(packet.Data, 1));
+
+			packet.Dispose();
+			Assert.Throws<ObjectDisposedException>(() => { DataPacketHeader h = packet.Header; });
+		}
+
+		[Test]
+		public void Payload_buffers_are_pooled()
+		{
+			DataPacket packet = new DataPacket();
+			packet.DataLength = 1400;
+			Assert.AreEqual(2048, packet.DataCapacity);
+
+			IntPtr data = packet.Data;
+			packet.Dispose();
+
+			// The most recently freed block of a size class is reused first
+			packet = new DataPacket();
+			packet.DataLength = 1500;
+			Assert.AreEqual(data, packet.Data);
+			packet.Dispose();
+		}
 	}
 }
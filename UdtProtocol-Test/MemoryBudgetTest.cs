@@ -0,0 +1,151 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Net.Sockets;
+
+using NUnit.Framework;
+using System.Net;
+
+namespace UdtProtocol_Test
+{
+    [TestFixture]
+    public class MemoryBudgetTest
+    {
+        [Test]
+        public void Constructor()
+        {
+            Udt.MemoryBudget budget = new Udt.MemoryBudget(1024 * 1024);
+            Assert.AreEqual(1024 * 1024, budget.Limit);
+            Assert.AreEqual(1024 * 1024, budget.Available);
+            Assert.AreEqual(Udt.MemoryBudget.DefaultMinimumBufferSize, budget.MinimumBufferSize);
+            Assert.AreEqual(0, budget.Reserved);
+            Assert.AreEqual(0, budget.SocketCount);
+            Assert.AreEqual(0, budget.ThrottledCount);
+            Assert.AreEqual(0, budget.RejectedCount);
+
+            Assert.Throws<ArgumentOutOfRangeException>(() => new Udt.MemoryBudget(-1));
+        }
+
+        [Test]
+        public void Set_limits()
+        {
+            Udt.MemoryBudget budget = new Udt.MemoryBudget(0);
+
+            budget.Limit = 4096;
+            budget.MinimumBufferSize = 1024;
+            Assert.AreEqual(4096, budget.Limit);
+            Assert.AreEqual(1024, budget.MinimumBufferSize);
+
+            Assert.Throws<ArgumentOutOfRangeException>(() => budget.Limit = -1);
+            Assert.Throws<ArgumentOutOfRangeException>(() => budget.MinimumBufferSize = 0);
+        }
+
+        [Test]
+        public void Apply_shrinks_buffers_to_share()
+        {
+            Udt.MemoryBudget budget = new Udt.MemoryBudget(1024 * 1024);
+
+            using (Udt.Socket socket = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                Assert.IsTrue(budget.Apply(socket));
+                Assert.AreEqual(256 * 1024, socket.SendBufferSize);
+                Assert.AreEqual(256 * 1024, socket.ReceiveBufferSize);
+                Assert.AreEqual(1, budget.ThrottledCount);
+
+                Assert.IsFalse(budget.Apply(socket));
+                Assert.AreEqual(0, budget.Reserved);
+
+                Assert.Throws<ArgumentNullException>(() => budget.Apply(null));
+
+                socket.Bind(IPAddress.Loopback, 0);
+                Udt.SocketException ex = Assert.Throws<Udt.SocketException>(() => budget.Apply(socket));
+                Assert.AreEqual(Udt.SocketError.BoundSocket, ex.SocketErrorCode);
+            }
+        }
+
+        [Test]
+        public void Connections_reserve_until_closed()
+        {
+            Udt.MemoryBudget budget = new Udt.MemoryBudget(64L * 1024 * 1024);
+
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                listener.Budget = budget;
+                Assert.AreSame(budget, listener.Budget);
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+                Assert.AreEqual(0, budget.SocketCount);
+
+                using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+                {
+                    client.Budget = budget;
+                    client.Connect(listener.LocalEndPoint);
+
+                    using (Udt.Socket server = listener.Accept())
+                    {
+                        Assert.AreSame(budget, server.Budget);
+                        Assert.AreEqual(2, budget.SocketCount);
+                        Assert.AreEqual(
+                            (long)client.SendBufferSize + client.ReceiveBufferSize + server.SendBufferSize + server.ReceiveBufferSize,
+                            budget.Reserved);
+                        Assert.AreEqual(budget.Limit - budget.Reserved, budget.Available);
+
+                        Assert.Throws<InvalidOperationException>(() => client.Budget = null);
+                    }
+
+                    Assert.AreEqual(1, budget.SocketCount);
+                }
+
+                Assert.AreEqual(0, budget.SocketCount);
+                Assert.AreEqual(0, budget.Reserved);
+            }
+        }
+
+        [Test]
+        public void Full_budget_rejects_connect()
+        {
+            Udt.MemoryBudget budget = new Udt.MemoryBudget(1000);
+
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+
+                client.Budget = budget;
+                Udt.SocketException ex = Assert.Throws<Udt.SocketException>(() => client.Connect(listener.LocalEndPoint));
+                Assert.AreEqual(Udt.SocketError.NoBuffer, ex.SocketErrorCode);
+                Assert.AreEqual(1, budget.RejectedCount);
+                Assert.AreEqual(0, budget.Reserved);
+                Assert.AreEqual(0, budget.SocketCount);
+                Assert.AreEqual(Udt.SocketState.Initial, client.State);
+            }
+        }
+
+        [Test]
+        public void Full_budget_rejects_accept()
+        {
+            Udt.MemoryBudget budget = new Udt.MemoryBudget(1000);
+
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                // Bind shrinks the listener to the minimum, which is still over the limit
+                listener.Budget = budget;
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+                Assert.AreEqual(budget.MinimumBufferSize, listener.SendBufferSize);
+
+                client.Connect(listener.LocalEndPoint);
+
+                Udt.SocketException ex = Assert.Throws<Udt.SocketException>(() => listener.Accept());
+                Assert.AreEqual(Udt.SocketError.NoBuffer, ex.SocketErrorCode);
+                Assert.AreEqual(1, budget.RejectedCount);
+                Assert.AreEqual(0, budget.Reserved);
+                Assert.AreEqual(0, budget.SocketCount);
+                Assert.AreEqual(Udt.SocketState.Listening, listener.State);
+            }
+        }
+    }
+}
@@ -0,0 +1,168 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Net.Sockets;
+
+using NUnit.Framework;
+using System.Net;
+
+namespace UdtProtocol_Test
+{
+    [TestFixture]
+    public class MultiplexerTest
+    {
+        [Test]
+        public void Constructor__InvalidArgs()
+        {
+            ArgumentException argEx = Assert.Throws<ArgumentNullException>(() => new Udt.Multiplexer((IPEndPoint)null));
+            Assert.AreEqual("localEP", argEx.ParamName);
+
+            argEx = Assert.Throws<ArgumentNullException>(() => new Udt.Multiplexer((Socket)null));
+            Assert.AreEqual("udpSocket", argEx.ParamName);
+
+            using (Socket tcpSocket = new Socket(AddressFamily.InterNetwork, SocketType.Stream, ProtocolType.Tcp))
+            {
+                argEx = Assert.Throws<ArgumentException>(() => new Udt.Multiplexer(tcpSocket));
+                Assert.AreEqual("udpSocket", argEx.ParamName);
+            }
+        }
+
+        [Test]
+        public void Tuning_locked_once_open()
+        {
+            using (Udt.Multiplexer mux = new Udt.Multiplexer(new IPEndPoint(IPAddress.Loopback, 0)))
+            {
+                Assert.IsFalse(mux.IsOpen);
+                mux.MaxPacketSize = 1400;
+                mux.UdpReceiveBufferSize = 1024 * 1024;
+
+                mux.Open();
+
+                Assert.IsTrue(mux.IsOpen);
+                Assert.AreNotEqual(0, mux.LocalEndPoint.Port);
+                Assert.AreEqual(1400, mux.MaxPacketSize);
+                Assert.Throws<InvalidOperationException>(() => mux.MaxPacketSize = 1052);
+                Assert.Throws<InvalidOperationException>(() => mux.UdpSendBufferSize = 65536);
+                Assert.Throws<InvalidOperationException>(() => mux.UdpReceiveBufferSize = 65536);
+            }
+        }
+
+        [Test]
+        public void Attach_shares_port()
+        {
+            using (Udt.Multiplexer serverMux = new Udt.Multiplexer(new IPEndPoint(IPAddress.Loopback, 0)))
+            using (Udt.Multiplexer clientMux = new Udt.Multiplexer(new IPEndPoint(IPAddress.Loopback, 0)))
+            using (Udt.Socket server = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client1 = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client2 = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                serverMux.Attach(server);
+                clientMux.Attach(client1);
+                clientMux.Attach(client2);
+
+                Assert.AreEqual(serverMux.LocalEndPoint.Port, server.LocalEndPoint.Port);
+                Assert.AreEqual(clientMux.LocalEndPoint.Port, client1.LocalEndPoint.Port);
+                Assert.AreEqual(clientMux.LocalEndPoint.Port, client2.LocalEndPoint.Port);
+                Assert.AreEqual(2, clientMux.SocketCount);
+
+                server.Listen(2);
+                client1.Connect(serverMux.LocalEndPoint);
+                client2.Connect(serverMux.LocalEndPoint);
+
+                using (Udt.Socket accept1 = server.Accept())
+                using (Udt.Socket accept2 = server.Accept())
+                {
+                    Assert.AreEqual(server.LocalEndPoint.Port, accept1.LocalEndPoint.Port);
+
+                    client1.Send(new byte[] { 1, 2, 3 });
+                    client2.Send(new byte[] { 4, 5 });
+
+                    byte[] buffer = new byte[1024];
+                    Assert.AreEqual(5, accept1.Receive(buffer) + accept2.Receive(buffer));
+                }
+
+                Assert.Greater(clientMux.GetPerformanceInfo().PacketsSent, 0);
+
+                client2.Dispose();
+                Assert.AreEqual(1, clientMux.SocketCount);
+            }
+        }
+
+        [Test]
+        public void ReceiveWorkerCount()
+        {
+            using (Udt.Multiplexer mux = new Udt.Multiplexer(new IPEndPoint(IPAddress.Loopback, 0)))
+            {
+                Assert.AreEqual(1, mux.ReceiveWorkerCount);
+
+                ArgumentException argEx = Assert.Throws<ArgumentOutOfRangeException>(() => mux.ReceiveWorkerCount = 0);
+                Assert.AreEqual("value", argEx.ParamName);
+
+                mux.ReceiveWorkerCount = 3;
+                mux.Open();
+
+                Assert.Throws<InvalidOperationException>(() => mux.ReceiveWorkerCount = 2);
+                Assert.AreEqual(mux.LocalEndPoint, mux.GetWorkerEndPoint(0));
+
+                var ports = Enumerable.Range(0, 3).Select(i => mux.GetWorkerEndPoint(i).Port).Distinct();
+                Assert.AreEqual(3, ports.Count());
+
+                argEx = Assert.Throws<ArgumentOutOfRangeException>(() => mux.GetWorkerEndPoint(3));
+                Assert.AreEqual("worker", argEx.ParamName);
+            }
+        }
+
+        [Test]
+        public void Attach_spreads_over_workers()
+        {
+            using (Udt.Multiplexer mux = new Udt.Multiplexer(new IPEndPoint(IPAddress.Loopback, 0)))
+            {
+                mux.ReceiveWorkerCount = 2;
+
+                Udt.Socket[] sockets = Enumerable.Range(0, 4)
+                    .Select(i => new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+                    .ToArray();
+
+                try
+                {
+                    foreach (Udt.Socket socket in sockets)
+                        mux.Attach(socket);
+
+                    Assert.AreEqual(4, mux.SocketCount);
+                    Assert.AreEqual(2, sockets.Count(s => s.LocalEndPoint.Port == mux.GetWorkerEndPoint(0).Port));
+                    Assert.AreEqual(2, sockets.Count(s => s.LocalEndPoint.Port == mux.GetWorkerEndPoint(1).Port));
+                }
+                finally
+                {
+                    foreach (Udt.Socket socket in sockets)
+                        socket.Dispose();
+                }
+            }
+        }
+
+        [Test]
+        public void ReceiveWorkerCount_with_udp_socket()
+        {
+            Socket udpSocket = new Socket(AddressFamily.InterNetwork, SocketType.Dgram, ProtocolType.Udp);
+            udpSocket.Bind(new IPEndPoint(IPAddress.Loopback, 0));
+
+            using (Udt.Multiplexer mux = new Udt.Multiplexer(udpSocket))
+            {
+                Assert.Throws<InvalidOperationException>(() => mux.ReceiveWorkerCount = 2);
+            }
+        }
+
+        [Test]
+        public void Attach_bound_socket()
+        {
+            using (Udt.Multiplexer mux = new Udt.Multiplexer(new IPEndPoint(IPAddress.Loopback, 0)))
+            using (Udt.Socket socket = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                socket.Bind(IPAddress.Loopback, 0);
+                ArgumentException argEx = Assert.Throws<ArgumentException>(() => mux.Attach(socket));
+                Assert.AreEqual("socket", argEx.ParamName);
+            }
+        }
+    }
+}
@@ -0,0 +1,143 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading.Tasks;
+
+using NUnit.Framework;
+using UdtBenchmark;
+
+namespace UdtProtocol_Test
+{
+    [TestFixture]
+    public class NetworkEmulatorTest
+    {
+        [Test]
+        public void Constructor__InvalidArgs()
+        {
+            ArgumentException argEx = Assert.Throws<ArgumentNullException>(() => new NetworkEmulator(null, 0));
+            Assert.AreEqual("target", argEx.ParamName);
+        }
+
+        [Test]
+        public void Relays_udt_stream_with_delay()
+        {
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+
+                using (NetworkEmulator emulator = new NetworkEmulator(listener.LocalEndPoint, 1))
+                using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+                {
+                    emulator.Upstream.Delay = TimeSpan.FromMilliseconds(10);
+                    emulator.Downstream.Delay = TimeSpan.FromMilliseconds(10);
+                    emulator.Upstream.LossRate = 0.01;
+
+                    client.Connect(emulator.LocalEndPoint);
+
+                    using (Udt.Socket server = listener.Accept())
+                    {
+                        byte[] sent = new byte[1024 * 1024];
+                        new Random(0).NextBytes(sent);
+                        byte[] received = new byte[sent.Length];
+
+                        Task receiver = Task.Factory.StartNew(() =>
+                        {
+                            int total = 0;
+                            while (total < received.Length)
+                                total += server.Receive(received, total, received.Length - total);
+                        });
+
+                        client.Send(sent);
+                        Assert.IsTrue(receiver.Wait(TimeSpan.FromSeconds(30)));
+                        CollectionAssert.AreEqual(sent, received);
+
+                        Udt.TraceInfo trace = client.GetPerformanceInfo();
+                        Assert.GreaterOrEqual(trace.Probe.RoundtripTime.TotalMilliseconds, 15);
+                        Assert.Greater(emulator.UpstreamStatistics.PacketsLost, 0);
+                        Assert.Greater(trace.Total.PacketsRetransmitted, 0);
+                    }
+                }
+            }
+        }
+
+        [Test]
+        public void Same_seed_drops_same_packets()
+        {
+            int[] first = RelayNumberedDatagrams(42);
+            int[] second = RelayNumberedDatagrams(42);
+
+            Assert.That(first.Length, Is.InRange(300, 450));
+            CollectionAssert.AreEqual(first, second);
+            CollectionAssert.AreNotEqual(first, RelayNumberedDatagrams(43));
+        }
+
+        [Test]
+        public void Gilbert_elliott_drops_in_bursts()
+        {
+            int[] received = RelayNumberedDatagrams(7, link =>
+            {
+                link.GilbertGoodToBad = 0.05;
+                link.GilbertBadToGood = 0.25;
+            });
+
+            // Mean burst length is 1 / 0.25 = 4 packets
+            int longestGap = 0;
+            for (int i = 1; i < received.Length; i++)
+                longestGap = Math.Max(longestGap, received[i] - received[i - 1] - 1);
+
+            Assert.Less(received.Length, 500);
+            Assert.GreaterOrEqual(longestGap, 3);
+        }
+
+        static int[] RelayNumberedDatagrams(int seed)
+        {
+            return RelayNumberedDatagrams(seed, link => link.LossRate = 0.25);
+        }
+
+        /// <summary>
+        /// Send 500 numbered datagrams through an emulator and return the numbers that arrived.
+        /// </summary>
+        static int[] RelayNumberedDatagrams(int seed, Action<LinkProfile> configure)
+        {
+            using (Socket target = new Socket(AddressFamily.InterNetwork, SocketType.Dgram, ProtocolType.Udp))
+            using (Socket sender = new Socket(AddressFamily.InterNetwork, SocketType.Dgram, ProtocolType.Udp))
+            {
+                target.Bind(new IPEndPoint(IPAddress.Loopback, 0));
+                target.ReceiveBufferSize = 1024 * 1024;
+                target.ReceiveTimeout = 500;
+
+                using (NetworkEmulator emulator = new NetworkEmulator((IPEndPoint)target.LocalEndPoint, seed))
+                {
+                    configure(emulator.Upstream);
+
+                    for (int i = 0; i < 500; i++)
+                        sender.SendTo(BitConverter.GetBytes(i), emulator.LocalEndPoint);
+
+                    List<int> received = new List<int>();
+                    byte[] buffer = new byte[4];
+
+                    try
+                    {
+                        while (true)
+                        {
+                            target.Receive(buffer);
+                            received.Add(BitConverter.ToInt32(buffer, 0));
+                        }
+                    }
+                    catch (SocketException ex)
+                    {
+                        Assert.AreEqual(SocketError.TimedOut, ex.SocketErrorCode);
+                    }
+
+                    Assert.AreEqual(500, emulator.UpstreamStatistics.PacketsReceived);
+                    Assert.AreEqual(500 - received.Count, emulator.UpstreamStatistics.PacketsLost);
+                    return received.ToArray();
+                }
+            }
+        }
+    }
+}
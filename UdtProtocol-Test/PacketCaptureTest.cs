@@ -0,0 +1,139 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading.Tasks;
+
+using NUnit.Framework;
+
+namespace UdtProtocol_Test
+{
+    [TestFixture]
+    public class PacketCaptureTest
+    {
+        [Test]
+        public void Constructor__InvalidArgs()
+        {
+            ArgumentException argEx = Assert.Throws<ArgumentNullException>(() => new Udt.PacketCapture((string)null));
+            Assert.AreEqual("path", argEx.ParamName);
+
+            argEx = Assert.Throws<ArgumentNullException>(() => new Udt.PacketCapture((Stream)null, 0));
+            Assert.AreEqual("stream", argEx.ParamName);
+
+            argEx = Assert.Throws<ArgumentOutOfRangeException>(() => new Udt.PacketCapture(new MemoryStream(), -1));
+            Assert.AreEqual("payloadPrefixLength", argEx.ParamName);
+
+            argEx = Assert.Throws<ArgumentOutOfRangeException>(() => new Udt.PacketCapture(new MemoryStream(), Udt.PacketCapture.MaxPayloadPrefixLength + 1));
+            Assert.AreEqual("payloadPrefixLength", argEx.ParamName);
+
+            argEx = Assert.Throws<ArgumentNullException>(() => Udt.CaptureReplay.Run(new MemoryStream(), 0, null));
+            Assert.AreEqual("factory", argEx.ParamName);
+        }
+
+        [Test]
+        public void Captures_default_congestion_control()
+        {
+            MemoryStream stream = new MemoryStream();
+
+            using (Udt.PacketCapture capture = new Udt.PacketCapture(stream, 16))
+            {
+                Transfer(capture, null);
+                Assert.AreEqual(0, capture.RecordsDropped);
+            }
+
+            byte[] data = stream.ToArray();
+            Assert.AreEqual(0x0A0D0D0A, BitConverter.ToInt32(data, 0));
+            Assert.Greater(CountBlocks(data, 6), 0);
+            Assert.AreEqual(1, CountBlocks(data, 1));
+        }
+
+        [Test]
+        public void Replay_reproduces_recorded_window()
+        {
+            MemoryStream stream = new MemoryStream();
+
+            using (Udt.PacketCapture capture = new Udt.PacketCapture(stream, 0))
+            {
+                Transfer(capture, new Udt.CongestionControlFactory(() => new Aimd()));
+            }
+
+            stream.Position = 0;
+            IList<Udt.ReplaySample> samples = Udt.CaptureReplay.Run(stream, 0, new Udt.CongestionControlFactory(() => new Aimd()));
+
+            Assert.Greater(samples.Count(s => s.Event == Udt.ReplayEvent.Ack), 0);
+            foreach (Udt.ReplaySample sample in samples)
+                Assert.AreEqual(sample.RecordedWindowSize, sample.WindowSize);
+        }
+
+        static void Transfer(Udt.PacketCapture capture, Udt.ICongestionControlFactory congestionControl)
+        {
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+
+                client.PacketCapture = capture;
+                if (congestionControl != null)
+                    client.CongestionControl = congestionControl;
+                client.Connect(listener.LocalEndPoint);
+
+                using (Udt.Socket server = listener.Accept())
+                {
+                    byte[] sent = new byte[1024 * 1024];
+                    byte[] received = new byte[sent.Length];
+
+                    Task receiver = Task.Factory.StartNew(() =>
+                    {
+                        int total = 0;
+                        while (total < received.Length)
+                            total += server.Receive(received, total, received.Length - total);
+                    });
+
+                    client.Send(sent);
+                    Assert.IsTrue(receiver.Wait(TimeSpan.FromSeconds(30)));
+                }
+            }
+        }
+
+        static int CountBlocks(byte[] data, int type)
+        {
+            int count = 0;
+
+            for (int offset = 0; offset + 8 <= data.Length; offset += BitConverter.ToInt32(data, offset + 4))
+            {
+                if (BitConverter.ToInt32(data, offset) == type)
+                    count++;
+            }
+
+            return count;
+        }
+
+        class Aimd : Udt.CongestionControl
+        {
+            public override void Initialize()
+            {
+                WindowSize = 16;
+                PacketSendPeriod = TimeSpan.Zero;
+            }
+
+            public override void OnAck(int ack)
+            {
+                WindowSize = WindowSize + 1;
+            }
+
+            public override void OnLoss(IList<int> lossList)
+            {
+                WindowSize = Math.Max(2, WindowSize / 2);
+            }
+
+            public override void OnTimeout()
+            {
+                WindowSize = 2;
+            }
+        }
+    }
+}
@@ -0,0 +1,109 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using NUnit.Framework;
+using Udt;
+
+namespace UdtProtocol_Test
+{
+	/// <summary>
+	/// Test fixture for <see cref="PacketCodec"/>.
+	/// </summary>
+	[TestFixture]
+	public class PacketCodecTest
+	{
+		[Test]
+		public void Data_packet_round_trip()
+		{
+			DataPacket packet = new DataPacket();
+			packet.PacketNumber = 0x01020304;
+			packet.MessageNumber = 7;
+			packet.MessageBoundary = MessageBoundary.Solo;
+			packet.TimeStamp = TimeSpan.FromMilliseconds(1);
+			packet.DestinationId = 99;
+			packet.Write(0, new byte[] { 0x0A, 0x0B, 0x0C }, 0, 3);
+
+			byte[] buffer = new byte[32];
+			Assert.AreEqual(19, PacketCodec.Encode(packet, buffer, 2));
+			CollectionAssert.AreEqual(new byte[] { 0x01, 0x02, 0x03, 0x04 }, buffer.Skip(2).Take(4).ToArray());
+			CollectionAssert.AreEqual(new byte[] { 0x0A, 0x0B, 0x0C }, buffer.Skip(18).Take(3).ToArray());
+			packet.Dispose();
+
+			DataPacket decoded = (DataPacket)PacketCodec.Decode(buffer, 2, 19);
+			Assert.AreEqual(0x01020304, decoded.PacketNumber);
+			Assert.AreEqual(7, decoded.MessageNumber);
+			Assert.AreEqual(MessageBoundary.Solo, decoded.MessageBoundary);
+			Assert.AreEqual(TimeSpan.FromMilliseconds(1), decoded.TimeStamp);
+			Assert.AreEqual(99, decoded.DestinationId);
+			Assert.AreEqual(3, decoded.DataLength);
+			Assert.IsTrue(decoded.IsEditable);
+			decoded.Dispose();
+		}
+
+		[Test]
+		public void Control_packets()
+		{
+			byte[] keepAlive = { 0x80, 0x01, 0x00, 0x00, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 9, 0, 0, 0, 0 };
+			Packet packet = PacketCodec.Decode(keepAlive, 0, keepAlive.Length);
+			Assert.IsInstanceOf<KeepAlivePacket>(packet);
+			Assert.AreEqual(9, packet.DestinationId);
+			packet.Dispose();
+
+			// ACK with sequence number, RTT, RTT variance, buffer, receive rate and bandwidth
+			byte[] ack = new byte[40];
+			ack[0] = 0x80; ack[1] = 0x02; ack[7] = 3;
+			for (int i = 0; i < 6; ++i) ack[19 + i * 4] = (byte)(i + 1);
+
+			ControlPacket control = (ControlPacket)PacketCodec.Decode(ack, 0, ack.Length);
+			Assert.AreEqual(2, control.ControlType);
+			CollectionAssert.AreEqual(new[] { 1, 2, 3, 4, 5, 6 }, control.GetControlInformation());
+
+			byte[] encoded = new byte[40];
+			Assert.AreEqual(40, PacketCodec.Encode(control, encoded, 0));
+			CollectionAssert.AreEqual(ack, encoded);
+			control.Dispose();
+		}
+
+		[Test]
+		public void DecodeHeaders()
+		{
+			byte[] buffer = new byte[64];
+			buffer[3] = 42; buffer[7] = 1;
+			buffer[32] = 0x80; buffer[33] = 0x06; buffer[39] = 17;
+
+			PacketHeader[] headers = new PacketHeader[2];
+			PacketCodec.DecodeHeaders(buffer, new[] { 0, 32 }, new[] { 20, 20 }, 2, headers);
+
+			Assert.IsFalse(headers[0].IsControl);
+			Assert.AreEqual(42, headers[0].PacketNumber);
+			Assert.AreEqual(1, headers[0].MessageNumber);
+			Assert.AreEqual(4, headers[0].DataLength);
+
+			Assert.IsTrue(headers[1].IsControl);
+			Assert.AreEqual(6, headers[1].ControlType);
+			Assert.AreEqual(17, headers[1].AdditionalInfo);
+		}
+
+		[Test]
+		public void Invalid_args()
+		{
+			ArgumentException argEx = Assert.Throws<ArgumentNullException>(() => PacketCodec.Decode(null, 0, 16));
+			Assert.AreEqual("buffer", argEx.ParamName);
+
+			argEx = Assert.Throws<ArgumentException>(() => PacketCodec.Decode(new byte[16], 0, 15));
+			Assert.AreEqual("count", argEx.ParamName);
+
+			Assert.Throws<ArgumentException>(() => PacketCodec.Decode(new byte[16], 1, 16));
+
+			DataPacket packet = new DataPacket();
+			packet.DataLength = 10;
+			argEx = Assert.Throws<ArgumentException>(() => PacketCodec.Encode(packet, new byte[20], 0));
+			Assert.AreEqual("buffer", argEx.ParamName);
+			packet.Dispose();
+			Assert.Throws<ObjectDisposedException>(() => PacketCodec.Encode(packet, new byte[32], 0));
+
+			Assert.Throws<ArgumentException>(() => PacketCodec.DecodeHeaders(new byte[20], new[] { 8 }, new[] { 16 }, 1, new PacketHeader[1]));
+		}
+	}
+}
@@ -9,6 +9,7 @@ using System.Threading.Tasks;
 
 using NUnit.Framework;
 using System.IO;
+using System.Diagnostics;
 using Moq;
 
 namespace UdtProtocol_Test
@@ -381,6 +382,359 @@ namespace UdtProtocol_Test
             }
         }
 
+        /// <summary>
+        /// Test for <see cref="Udt.NativeCongestionControlFactory(string,string)"/> with
+        /// a missing library or entry point.
+        /// </summary>
+        [Test]
+        public void NativeCongestionControlFactory_requires_plugin_library()
+        {
+            Assert.Throws<ArgumentNullException>(() => new Udt.NativeCongestionControlFactory(null));
+            Assert.Throws<ArgumentNullException>(() => new Udt.NativeCongestionControlFactory("kernel32.dll", null));
+            Assert.Throws<DllNotFoundException>(() => new Udt.NativeCongestionControlFactory("missing-congestion-control.dll"));
+            Assert.Throws<EntryPointNotFoundException>(() => new Udt.NativeCongestionControlFactory("kernel32.dll"));
+        }
+
+        /// <summary>
+        /// Test for <see cref="Udt.CongestionControlGroup"/> shared by two
+        /// connections.
+        /// </summary>
+        [Test]
+        public void CongestionControlGroup_couples_sockets()
+        {
+            using (Udt.CongestionControlGroup group = new Udt.CongestionControlGroup())
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client1 = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client2 = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                Assert.Throws<NotSupportedException>(() => group.CreateCongestionControl());
+                Assert.AreEqual(0, group.MemberCount);
+
+                client1.CongestionControl = group;
+                client2.CongestionControl = group;
+                Assert.AreSame(group, client1.CongestionControl);
+
+                // A small window ends slow start after a few packets
+                client1.MaxWindowSize = 32;
+                client2.MaxWindowSize = 32;
+
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(2);
+                client1.Connect(listener.LocalEndPoint);
+                client2.Connect(listener.LocalEndPoint);
+
+                using (Udt.Socket server1 = listener.Accept())
+                using (Udt.Socket server2 = listener.Accept())
+                {
+                    Assert.AreEqual(2, group.MemberCount);
+
+                    byte[] data = new byte[256 * 1024];
+                    byte[] received = new byte[data.Length];
+
+                    Task receiver = Task.Factory.StartNew(() =>
+                    {
+                        foreach (Udt.Socket server in new[] { server1, server2 })
+                        {
+                            int total = 0;
+                            while (total < received.Length)
+                                total += server.Receive(received, total, received.Length - total);
+                        }
+                    });
+
+                    client1.Send(data);
+                    client2.Send(data);
+                    Assert.IsTrue(receiver.Wait(TimeSpan.FromSeconds(30)));
+
+                    // Both members left slow start into the aggregate, and
+                    // each sends a share of it rather than all of it
+                    double rate = group.SendRate;
+                    Assert.Greater(rate, 0);
+
+                    foreach (Udt.Socket client in new[] { client1, client2 })
+                    {
+                        TimeSpan period = client.GetPerformanceInfo().Probe.PacketSendPeriod;
+                        Assert.Greater(period, TimeSpan.Zero);
+                        Assert.Less(1 / period.TotalSeconds, rate);
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// Test for <see cref="Udt.Socket.DiscoverPacketSize"/> when connecting.
+        /// </summary>
+        [Test]
+        public void DiscoverPacketSize_uses_path_mtu()
+        {
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                Assert.IsFalse(client.DiscoverPacketSize);
+                client.DiscoverPacketSize = true;
+                Assert.IsTrue(client.DiscoverPacketSize);
+
+                // The handshake settles on the smaller of the two sizes
+                listener.MaxPacketSize = 9000;
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+                client.Connect(listener.LocalEndPoint);
+
+                using (Udt.Socket server = listener.Accept())
+                {
+                    // Loopback has no MTU limit; without a discovered path
+                    // MTU the interface fallback is capped at 1500 bytes
+                    Assert.Greater(client.MaxPacketSize, 1052);
+                    Assert.LessOrEqual(client.MaxPacketSize, 9000);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Test for <see cref="Udt.Socket.DiscoverPacketSize"/> on a socket bound
+        /// before it connects.
+        /// </summary>
+        [Test]
+        public void DiscoverPacketSize_keeps_size_of_bound_socket()
+        {
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+
+                client.DiscoverPacketSize = true;
+                client.Bind(IPAddress.Loopback, 0);
+                int packetSize = client.MaxPacketSize;
+                client.Connect(listener.LocalEndPoint);
+
+                using (Udt.Socket server = listener.Accept())
+                {
+                    Assert.AreEqual(Udt.SocketState.Connected, client.State);
+                    Assert.AreEqual(packetSize, client.MaxPacketSize);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Test for <see cref="Udt.Socket.TrySend(byte[],int,int,out int)"/> and
+        /// <see cref="Udt.Socket.TryReceive(byte[],int,int,out int)"/>.
+        /// </summary>
+        [Test]
+        public void TrySend_TryReceive()
+        {
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+                client.Connect(listener.LocalEndPoint);
+
+                using (Udt.Socket server = listener.Accept())
+                {
+                    byte[] buffer = new byte[16];
+                    int count;
+
+                    server.BlockingReceive = false;
+                    Assert.AreEqual(Udt.SocketError.NoDataAvailable, server.TryReceive(buffer, 0, buffer.Length, out count));
+                    Assert.AreEqual(0, count);
+
+                    Assert.AreEqual(Udt.SocketError.Success, client.TrySend(new byte[] { 1, 2, 3 }, 0, 3, out count));
+                    Assert.AreEqual(3, count);
+
+                    server.BlockingReceive = true;
+                    Assert.AreEqual(Udt.SocketError.Success, server.TryReceive(buffer, 4, 12, out count));
+                    Assert.AreEqual(3, count);
+                    Assert.AreEqual(new byte[] { 1, 2, 3 }, buffer.Skip(4).Take(3).ToArray());
+
+                    Assert.Throws<ArgumentNullException>(() => client.TrySend(null, 0, 0, out count));
+                    Assert.Throws<ArgumentException>(() => server.TryReceive(buffer, 8, 12, out count));
+                }
+
+                client.Dispose();
+                Assert.AreEqual(Udt.SocketError.InvalidSocket, client.TrySend(new byte[1], 0, 1, out count));
+            }
+        }
+
+        /// <summary>
+        /// Test for <see cref="Udt.Socket.TrySendMessage(byte[],int,int,out int)"/> and
+        /// <see cref="Udt.Socket.TryReceiveMessage(byte[],int,int,out int)"/>.
+        /// </summary>
+        [Test]
+        public void TrySendMessage_TryReceiveMessage()
+        {
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Dgram))
+            using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Dgram))
+            {
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+                client.Connect(listener.LocalEndPoint);
+
+                using (Udt.Socket server = listener.Accept())
+                {
+                    byte[] buffer = new byte[16];
+                    int count;
+
+                    server.BlockingReceive = false;
+                    Assert.AreEqual(Udt.SocketError.NoDataAvailable, server.TryReceiveMessage(buffer, 0, buffer.Length, out count));
+
+                    Assert.AreEqual(Udt.SocketError.Success, client.TrySendMessage(new byte[] { 4, 5 }, 0, 2, out count));
+                    Assert.AreEqual(2, count);
+
+                    server.BlockingReceive = true;
+                    Assert.AreEqual(Udt.SocketError.Success, server.TryReceiveMessage(buffer, 0, buffer.Length, out count));
+                    Assert.AreEqual(2, count);
+                    Assert.AreEqual(4, buffer[0]);
+                    Assert.AreEqual(5, buffer[1]);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Test for <see cref="Udt.Socket.Send(IntPtr,int,Action{bool})"/>.
+        /// </summary>
+        [Test]
+        public void Send_native_memory()
+        {
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+                client.Connect(listener.LocalEndPoint);
+
+                using (Udt.Socket server = listener.Accept())
+                {
+                    IntPtr data = System.Runtime.InteropServices.Marshal.AllocHGlobal(100000);
+                    ManualResetEvent done = new ManualResetEvent(false);
+                    bool acknowledged = false;
+
+                    try
+                    {
+                        for (int i = 0; i < 100000; i++)
+                            System.Runtime.InteropServices.Marshal.WriteByte(data, i, (byte)i);
+
+                        Assert.Throws<ArgumentNullException>(() => client.Send(IntPtr.Zero, 1));
+                        Assert.Throws<ArgumentOutOfRangeException>(() => client.Send(data, -1));
+
+                        Assert.AreEqual(50000, client.Send(data, 50000));
+                        Assert.AreEqual(50000, client.Send(data + 50000, 50000, a =>
+                        {
+                            acknowledged = a;
+                            done.Set();
+                        }));
+
+                        // UDT has its own copy, the memory can be reused straight away
+                        for (int i = 0; i < 100000; i++)
+                            System.Runtime.InteropServices.Marshal.WriteByte(data, i, 0);
+
+                        byte[] buffer = new byte[100000];
+                        int received = 0;
+                        while (received < buffer.Length)
+                            received += server.Receive(buffer, received, buffer.Length - received);
+
+                        Assert.AreEqual(unchecked((byte)99999), buffer[99999]);
+                        Assert.IsTrue(done.WaitOne(5000));
+                        Assert.IsTrue(acknowledged);
+                        Assert.AreEqual(0, client.SendDataSize);
+                    }
+                    finally
+                    {
+                        System.Runtime.InteropServices.Marshal.FreeHGlobal(data);
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// Test for <see cref="Udt.CongestionControl.OnDelay"/> on a connected
+        /// socket.
+        /// </summary>
+        [Test]
+        public void CongestionControl_receives_delay_samples()
+        {
+            List<DelayRecorder> instances = new List<DelayRecorder>();
+
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                listener.CongestionControl = new Udt.CongestionControlFactory(() =>
+                {
+                    DelayRecorder cc = new DelayRecorder();
+                    lock (instances) instances.Add(cc);
+                    return cc;
+                });
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+                client.Connect(listener.LocalEndPoint);
+
+                using (Udt.Socket server = listener.Accept())
+                {
+                    // Enough packets for several full batches
+                    byte[] data = new byte[1024 * 1024];
+
+                    Task receiver = Task.Factory.StartNew(() =>
+                    {
+                        int total = 0;
+                        while (total < data.Length)
+                            total += server.Receive(data, total, data.Length - total);
+                    });
+
+                    client.Send(data);
+                    Assert.IsTrue(receiver.Wait(TimeSpan.FromSeconds(30)));
+                }
+            }
+
+            DelayRecorder recorder;
+            lock (instances) recorder = instances.FirstOrDefault(cc => cc.Batches > 0);
+
+            Assert.IsNotNull(recorder);
+            Assert.Greater(recorder.Samples, 0);
+            Assert.IsTrue(recorder.CountsMatch);
+            Assert.GreaterOrEqual(recorder.MinQueuingDelay, TimeSpan.Zero);
+        }
+
+        /// <summary>
+        /// Test for a <see cref="Udt.CongestionControl"/> created as asynchronous
+        /// on a connected socket.
+        /// </summary>
+        [Test]
+        public void Asynchronous_congestion_control_runs_on_decision_thread()
+        {
+            AsyncAckRecorder recorder = new AsyncAckRecorder();
+
+            using (Udt.Socket listener = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                client.CongestionControl = new Udt.CongestionControlFactory(() => recorder);
+                listener.Bind(IPAddress.Loopback, 0);
+                listener.Listen(1);
+                client.Connect(listener.LocalEndPoint);
+
+                using (Udt.Socket server = listener.Accept())
+                {
+                    byte[] data = new byte[1024 * 1024];
+
+                    Task receiver = Task.Factory.StartNew(() =>
+                    {
+                        int total = 0;
+                        while (total < data.Length)
+                            total += server.Receive(data, total, data.Length - total);
+                    });
+
+                    client.Send(data);
+                    Assert.IsTrue(receiver.Wait(TimeSpan.FromSeconds(30)));
+                }
+            }
+
+            // Close runs on the decision thread once UDT releases the controller
+            Assert.IsTrue(recorder.Closed.WaitOne(5000));
+            Assert.IsTrue(recorder.IsAsynchronous);
+            Assert.IsTrue(recorder.IsDisposed);
+            Assert.IsTrue(recorder.Initialized);
+            Assert.Greater(recorder.Acks, 0);
+            Assert.IsTrue(recorder.OnDecisionThread);
+        }
+
 		[Test]
 		public void Get_set_BlockingReceive()
 		{
@@ -635,6 +989,79 @@ namespace UdtProtocol_Test
 			serverTask.Wait();
 		}
 
+		[Test]
+		public void Connect_multiple_addresses()
+		{
+			int port = _portNum++;
+
+			using (Udt.Socket server = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+			using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+			{
+				server.Bind(IPAddress.Loopback, port);
+				server.Listen(1);
+
+				// The first address is never answered, the second attempt starts
+				// after the stagger and wins without waiting for the first to time out
+				client.ConnectStagger = TimeSpan.FromMilliseconds(50);
+				Stopwatch stopwatch = Stopwatch.StartNew();
+				client.Connect(new[] { IPAddress.Parse("192.0.2.1"), IPAddress.Loopback }, port);
+				stopwatch.Stop();
+
+				Assert.AreEqual(Udt.SocketState.Connected, client.State);
+				Assert.AreEqual(new IPEndPoint(IPAddress.Loopback, port), client.RemoteEndPoint);
+				Assert.Less(stopwatch.ElapsedMilliseconds, 2000);
+				Assert.IsTrue(client.BlockingReceive);
+
+				using (Udt.Socket accept = server.Accept())
+				{
+					client.Send(new byte[] { 1, 2, 3 });
+					byte[] buffer = new byte[1024];
+					Assert.AreEqual(3, accept.Receive(buffer));
+				}
+			}
+		}
+
+		[Test]
+		public void Bind_then_connect_multiple_addresses_keeps_local_end_point()
+		{
+			int port = _portNum++;
+
+			using (Udt.Socket server = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+			using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+			{
+				server.Bind(IPAddress.Loopback, port);
+				server.Listen(1);
+
+				client.Bind(IPAddress.Loopback, 0);
+				IPEndPoint local = client.LocalEndPoint;
+
+				client.ConnectStagger = TimeSpan.Zero;
+				client.Connect(new[] { IPAddress.Loopback, IPAddress.Loopback }, port);
+
+				Assert.AreEqual(Udt.SocketState.Connected, client.State);
+				Assert.AreEqual(local, client.LocalEndPoint);
+
+				using (Udt.Socket accept = server.Accept())
+				{
+					Assert.AreEqual(local, accept.RemoteEndPoint);
+				}
+			}
+		}
+
+		[Test]
+		public void ConnectStagger()
+		{
+			using (Udt.Socket socket = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+			{
+				Assert.AreEqual(Udt.Socket.DefaultConnectStagger, socket.ConnectStagger);
+				socket.ConnectStagger = TimeSpan.Zero;
+				Assert.AreEqual(TimeSpan.Zero, socket.ConnectStagger);
+
+				ArgumentException argEx = Assert.Throws<ArgumentOutOfRangeException>(() => socket.ConnectStagger = TimeSpan.FromMilliseconds(-1));
+				Assert.AreEqual("value", argEx.ParamName);
+			}
+		}
+
 		[Test]
 		public void Send_receive()
 		{
@@ -679,6 +1106,117 @@ namespace UdtProtocol_Test
 			serverTask.Wait();
 		}
 
+		[Test]
+		public void Splice()
+		{
+			int port = _portNum++;
+			int relayPort = _portNum++;
+
+			using (Udt.Socket server = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+			using (Udt.Socket relayServer = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+			using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+			using (Udt.Socket relayClient = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+			{
+				server.Bind(IPAddress.Loopback, port);
+				server.Listen(1);
+				relayServer.Bind(IPAddress.Loopback, relayPort);
+				relayServer.Listen(1);
+
+				client.Connect(IPAddress.Loopback, port);
+				relayClient.Connect(IPAddress.Loopback, relayPort);
+
+				using (Udt.Socket inbound = server.Accept())
+				using (Udt.Socket outbound = relayServer.Accept())
+				{
+					client.Send(new byte[] { 1, 2, 3, 4, 5 });
+					Assert.AreEqual(5, inbound.Splice(outbound, 5));
+
+					byte[] buffer = new byte[1024];
+					Assert.AreEqual(5, relayClient.Receive(buffer));
+					CollectionAssert.AreEqual(new byte[] { 1, 2, 3, 4, 5 }, buffer.Take(5));
+				}
+			}
+		}
+
+		/// <summary>
+		/// Test for <see cref="Udt.Socket.Splice(System.Net.Sockets.Socket,long)"/>,
+		/// <see cref="Udt.Socket.Splice(System.Net.Sockets.Socket)"/> and
+		/// <see cref="Udt.Socket.SpliceFrom(System.Net.Sockets.Socket)"/>.
+		/// </summary>
+		[Test]
+		public void Splice_operating_system_socket()
+		{
+			int port = _portNum++;
+			TcpListener tcpListener = new TcpListener(IPAddress.Loopback, 0);
+			tcpListener.Start();
+
+			try
+			{
+				using (Udt.Socket server = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+				using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+				using (Socket tcpClient = new Socket(AddressFamily.InterNetwork, SocketType.Stream, ProtocolType.Tcp))
+				{
+					server.Bind(IPAddress.Loopback, port);
+					server.Listen(1);
+					client.Connect(IPAddress.Loopback, port);
+					tcpClient.Connect(tcpListener.LocalEndpoint);
+
+					using (Udt.Socket inbound = server.Accept())
+					using (Socket tcpServer = tcpListener.AcceptSocket())
+					{
+						byte[] buffer = new byte[1024];
+
+						client.Send(new byte[] { 1, 2, 3, 4, 5 });
+						Assert.AreEqual(5, inbound.Splice(tcpServer, 5));
+						CollectionAssert.AreEqual(new byte[] { 1, 2, 3, 4, 5 }, ReceiveExactly(tcpClient, 5));
+
+						// Moves data until the TCP peer shuts down its side
+						tcpClient.Send(new byte[] { 6, 7, 8 });
+						tcpClient.Shutdown(SocketShutdown.Send);
+						Assert.AreEqual(3, inbound.SpliceFrom(tcpServer));
+
+						int total = 0;
+						while (total < 3)
+							total += client.Receive(buffer, total, 3 - total);
+						CollectionAssert.AreEqual(new byte[] { 6, 7, 8 }, buffer.Take(3));
+
+						// Moves data until the UDT peer closes
+						client.Send(new byte[] { 9, 10, 11, 12 });
+						client.Close();
+						Assert.AreEqual(4, inbound.Splice(tcpServer));
+						CollectionAssert.AreEqual(new byte[] { 9, 10, 11, 12 }, ReceiveExactly(tcpClient, 4));
+					}
+				}
+			}
+			finally
+			{
+				tcpListener.Stop();
+			}
+		}
+
+		[Test]
+		public void Splice__InvalidArgs()
+		{
+			using (Udt.Socket socket = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+			using (Udt.Socket destination = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+			using (Udt.Socket dgram = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Dgram))
+			{
+				ArgumentException argEx = Assert.Throws<ArgumentNullException>(() => socket.Splice((Udt.Socket)null));
+				Assert.AreEqual("destination", argEx.ParamName);
+
+				argEx = Assert.Throws<ArgumentOutOfRangeException>(() => socket.Splice(destination, -2));
+				Assert.AreEqual("count", argEx.ParamName);
+
+				argEx = Assert.Throws<ArgumentOutOfRangeException>(() => socket.Splice(destination, -1, 0));
+				Assert.AreEqual("bufferSize", argEx.ParamName);
+
+				argEx = Assert.Throws<ArgumentException>(() => socket.Splice(dgram));
+				Assert.AreEqual("destination", argEx.ParamName);
+
+				Assert.Throws<InvalidOperationException>(() => dgram.Splice(socket));
+			}
+		}
+
 		[Test]
 		public void SendFile_stream()
 		{
@@ -767,6 +1305,21 @@ namespace UdtProtocol_Test
 
 		private int _portNum = 10000;
 
+		private static byte[] ReceiveExactly(Socket socket, int size)
+		{
+			byte[] buffer = new byte[size];
+			int total = 0;
+
+			while (total < size)
+			{
+				int received = socket.Receive(buffer, total, size - total, SocketFlags.None);
+				Assert.Greater(received, 0);
+				total += received;
+			}
+
+			return buffer;
+		}
+
 		private string GetFile(string content = "")
 		{
 			string path = Path.GetTempFileName();
@@ -811,5 +1364,54 @@ namespace UdtProtocol_Test
         private class CongestionControlTester : Udt.CongestionControl
         {
         }
+
+        private class DelayRecorder : Udt.CongestionControl
+        {
+            public int Batches;
+            public int Samples;
+            public bool CountsMatch = true;
+            public TimeSpan MinQueuingDelay = TimeSpan.MaxValue;
+
+            public override void OnDelay(Udt.DelayInfo delay, IList<int> samples)
+            {
+                Batches++;
+                Samples += samples.Count;
+                CountsMatch &= samples.Count == delay.SampleCount;
+
+                if (delay.QueuingDelay < MinQueuingDelay)
+                    MinQueuingDelay = delay.QueuingDelay;
+            }
+        }
+
+        private class AsyncAckRecorder : Udt.CongestionControl
+        {
+            public int Acks;
+            public bool Initialized;
+            public bool OnDecisionThread = true;
+            public ManualResetEvent Closed = new ManualResetEvent(false);
+
+            public AsyncAckRecorder()
+                : base(true)
+            {
+            }
+
+            public override void Initialize()
+            {
+                Initialized = Acks == 0;
+                OnDecisionThread &= Thread.CurrentThread.Name == "UDT congestion control";
+            }
+
+            public override void OnAck(Udt.AckInfo ack)
+            {
+                Acks++;
+                OnDecisionThread &= Thread.CurrentThread.Name == "UDT congestion control";
+            }
+
+            public override void Close()
+            {
+                OnDecisionThread &= Thread.CurrentThread.Name == "UDT congestion control";
+                Closed.Set();
+            }
+        }
     }
 }
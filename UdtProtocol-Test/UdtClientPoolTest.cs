@@ -0,0 +1,75 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Net.Sockets;
+
+using NUnit.Framework;
+using System.Net;
+
+namespace UdtProtocol_Test
+{
+    [TestFixture]
+    public class UdtClientPoolTest
+    {
+        [Test]
+        public void Constructor__InvalidArgs()
+        {
+            ArgumentException argEx = Assert.Throws<ArgumentOutOfRangeException>(() => new Udt.UdtClientPool(-1));
+            Assert.AreEqual("maxIdlePerEndPoint", argEx.ParamName);
+        }
+
+        [Test]
+        public void Rent_reuses_returned_connection()
+        {
+            using (Udt.UdtListener listener = new Udt.UdtListener(IPAddress.Loopback, 0))
+            using (Udt.UdtClientPool pool = new Udt.UdtClientPool())
+            {
+                listener.Start();
+                IPEndPoint endPoint = listener.LocalEndPoint;
+
+                Udt.UdtClient client = pool.Rent(endPoint);
+                Assert.IsTrue(client.Connected);
+                listener.AcceptSocket().Dispose();
+
+                pool.Return(endPoint, client);
+                Assert.AreEqual(1, pool.IdleCount);
+
+                Assert.AreSame(client, pool.Rent(endPoint));
+                Assert.AreEqual(0, pool.IdleCount);
+
+                pool.Return(endPoint, client);
+            }
+        }
+
+        [Test]
+        public void Return_closed_client()
+        {
+            using (Udt.UdtClientPool pool = new Udt.UdtClientPool())
+            {
+                Udt.UdtClient client = new Udt.UdtClient();
+                client.Close();
+
+                pool.Return(new IPEndPoint(IPAddress.Loopback, 9000), client);
+                Assert.AreEqual(0, pool.IdleCount);
+            }
+        }
+
+        [Test]
+        public void Return_when_full()
+        {
+            using (Udt.UdtListener listener = new Udt.UdtListener(IPAddress.Loopback, 0))
+            using (Udt.UdtClientPool pool = new Udt.UdtClientPool(0))
+            {
+                listener.Start();
+                IPEndPoint endPoint = listener.LocalEndPoint;
+
+                Udt.UdtClient client = pool.Rent(endPoint);
+                pool.Return(endPoint, client);
+
+                Assert.AreEqual(0, pool.IdleCount);
+                Assert.IsTrue(client.Client.IsDisposed);
+            }
+        }
+    }
+}
@@ -0,0 +1,132 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Net.Sockets;
+
+using NUnit.Framework;
+using System.Net;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace UdtProtocol_Test
+{
+    [TestFixture]
+    public class UdtListenerTest
+    {
+        [Test]
+        public void Constructor__InvalidArgs()
+        {
+            ArgumentException argEx = Assert.Throws<ArgumentNullException>(() => new Udt.UdtListener(null));
+            Assert.AreEqual("localEP", argEx.ParamName);
+
+            argEx = Assert.Throws<ArgumentOutOfRangeException>(() => new Udt.UdtListener(IPAddress.Loopback, -1));
+            Assert.AreEqual("port", argEx.ParamName);
+
+            argEx = Assert.Throws<ArgumentOutOfRangeException>(() => new Udt.UdtListener(new IPEndPoint(IPAddress.Loopback, 0), 0));
+            Assert.AreEqual("queueCapacity", argEx.ParamName);
+        }
+
+        [Test]
+        public void Accept_when_not_started()
+        {
+            Udt.UdtListener listener = new Udt.UdtListener(IPAddress.Loopback, 0);
+            Assert.IsFalse(listener.Active);
+            Assert.IsNull(listener.Server);
+            Assert.Throws<InvalidOperationException>(() => listener.AcceptSocket());
+            Assert.Throws<InvalidOperationException>(() => listener.Pending());
+        }
+
+        [Test]
+        public void Accept_timeout()
+        {
+            using (Udt.UdtListener listener = new Udt.UdtListener(IPAddress.Loopback, 0))
+            {
+                listener.Start();
+                Assert.IsTrue(listener.Active);
+                Assert.AreNotEqual(0, listener.LocalEndPoint.Port);
+                Assert.IsFalse(listener.Pending());
+                Assert.IsNull(listener.AcceptSocket(TimeSpan.FromMilliseconds(50)));
+            }
+        }
+
+        [Test]
+        public void Accept_queued_connections()
+        {
+            using (Udt.UdtListener listener = new Udt.UdtListener(IPAddress.Loopback, 0))
+            using (Udt.Socket client1 = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client2 = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                listener.Start();
+                client1.Connect(listener.LocalEndPoint);
+                client2.Connect(listener.LocalEndPoint);
+
+                // Both connections are accepted without the application calling Accept
+                for (int i = 0; i < 50 && listener.PendingCount < 2; i++)
+                    Thread.Sleep(20);
+
+                Assert.AreEqual(2, listener.PendingCount);
+                Assert.IsTrue(listener.Pending());
+
+                using (Udt.Socket accepted1 = listener.AcceptSocket())
+                using (Udt.UdtClient accepted2 = listener.AcceptUdtClient())
+                {
+                    Assert.AreEqual(Udt.SocketState.Connected, accepted1.State);
+                    Assert.IsTrue(accepted2.Connected);
+                    Assert.AreEqual(0, listener.PendingCount);
+                }
+            }
+        }
+
+        [Test]
+        public void Stop_closes_pending_connections()
+        {
+            Udt.UdtListener listener = new Udt.UdtListener(IPAddress.Loopback, 0);
+            listener.Start();
+            Udt.Socket server = listener.Server;
+
+            using (Udt.Socket client = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                client.Connect(listener.LocalEndPoint);
+
+                for (int i = 0; i < 50 && listener.PendingCount < 1; i++)
+                    Thread.Sleep(20);
+
+                listener.Stop();
+
+                Assert.IsFalse(listener.Active);
+                Assert.IsTrue(server.IsDisposed);
+                Assert.AreEqual(0, listener.PendingCount);
+            }
+        }
+
+        [Test]
+        public void Rejected_connection_keeps_listening()
+        {
+            Udt.MemoryBudget budget = new Udt.MemoryBudget(1000);
+
+            using (Udt.UdtListener listener = new Udt.UdtListener(IPAddress.Loopback, 0))
+            using (Udt.Socket client1 = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            using (Udt.Socket client2 = new Udt.Socket(AddressFamily.InterNetwork, SocketType.Stream))
+            {
+                listener.Start();
+                listener.Server.Budget = budget;
+
+                // Over the budget, Accept drops it
+                client1.Connect(listener.LocalEndPoint);
+                Assert.IsNull(listener.AcceptSocket(TimeSpan.FromMilliseconds(500)));
+                Assert.AreEqual(1, budget.RejectedCount);
+                Assert.IsTrue(listener.Active);
+
+                budget.Limit = 1024L * 1024 * 1024;
+                client2.Connect(listener.LocalEndPoint);
+
+                using (Udt.Socket accepted = listener.AcceptSocket(TimeSpan.FromSeconds(5)))
+                {
+                    Assert.IsNotNull(accepted);
+                    Assert.AreEqual(Udt.SocketState.Connected, accepted.State);
+                }
+            }
+        }
+    }
+}
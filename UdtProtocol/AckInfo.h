@@ -0,0 +1,99 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	/// <summary>
+	/// Receiver feedback delivered with an ACK to
+	/// <see cref="CongestionControl::OnAck(AckInfo)"/>.
+	/// </summary>
+	[System::Runtime::InteropServices::StructLayout(System::Runtime::InteropServices::LayoutKind::Sequential)]
+	public value struct AckInfo
+	{
+	private:
+
+		int _ack;
+		int _rtt;
+		int _rttVariance;
+		int _receiveRate;
+		int _bandwidth;
+
+	internal:
+
+		AckInfo(int ack, int rtt, int rttVariance, int receiveRate, int bandwidth)
+			: _ack(ack), _rtt(rtt), _rttVariance(rttVariance), _receiveRate(receiveRate), _bandwidth(bandwidth)
+		{
+		}
+
+	public:
+
+		/// <summary>
+		/// Get the sequence number up to which (excluding) all packets have
+		/// been received.
+		/// </summary>
+		property int AcknowledgedPacket {
+			int get(void) { return _ack; }
+		}
+
+		/// <summary>
+		/// Get the smoothed round trip time, including this ACK's sample.
+		/// </summary>
+		property System::TimeSpan RoundtripTime {
+			System::TimeSpan get(void) { return FromMicroseconds(_rtt); }
+		}
+
+		/// <summary>
+		/// Get the round trip time variance.
+		/// </summary>
+		property System::TimeSpan RoundtripTimeVariance {
+			System::TimeSpan get(void) { return FromMicroseconds(_rttVariance); }
+		}
+
+		/// <summary>
+		/// Get the packet arrival rate reported by the receiver, in packets
+		/// per second.
+		/// </summary>
+		property int ReceiveRate {
+			int get(void) { return _receiveRate; }
+		}
+
+		/// <summary>
+		/// Get the link capacity estimated by the receiver, in packets per
+		/// second.
+		/// </summary>
+		property int Bandwidth {
+			int get(void) { return _bandwidth; }
+		}
+	};
+}
@@ -0,0 +1,159 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "AsyncCongestionControl.h"
+#include "AsyncControlQueue.h"
+#include "PacketCaptureRing.h"
+
+#include <udt.h>
+
+using namespace Udt;
+
+#pragma managed(push, off)
+
+AsyncCC::AsyncCC(AsyncControlQueue* queue, PacketCaptureRing* capture)
+	: _queue(queue), _capture(capture), _lastRtt(0), _rttVariance(0)
+{
+	_queue->AddRef();
+	_queue->SetOwner(this);
+
+	if (_capture != NULL)
+		_capture->AddRef();
+}
+
+AsyncCC::~AsyncCC(void)
+{
+	// Waits for a controller call in progress to finish
+	_queue->SetOwner(NULL);
+	_queue->Close();
+	_queue->Release();
+
+	if (_capture != NULL)
+		_capture->Release();
+}
+
+void AsyncCC::Apply(void)
+{
+	// CUDT reads the window and period right after each callback
+	m_dCWndSize = _queue->WindowSize();
+	m_dPktSndPeriod = _queue->PacketSendPeriod();
+}
+
+void AsyncCC::init(void)
+{
+	// CUDT starts with variance half the initial RTT
+	_lastRtt = m_iRTT;
+	_rttVariance = m_iRTT >> 1;
+
+	_queue->PublishWindowSize(m_dCWndSize);
+	_queue->PublishPacketSendPeriod(m_dPktSndPeriod);
+	_queue->PublishRoundTripTime(m_iRTT);
+	_queue->PublishMaxPacketSize(m_iMSS);
+
+	AsyncControlEvent e;
+	e.kind = AsyncInit;
+	_queue->Enqueue(e);
+}
+
+void AsyncCC::close(void)
+{
+	_queue->Close();
+}
+
+void AsyncCC::onACK(int32_t ack)
+{
+	// Same RTT sample recovery as CCCWrapper::onACK
+	int sample = max(0, 8 * m_iRTT - 7 * _lastRtt);
+	_rttVariance = (_rttVariance * 3 + abs(_lastRtt - sample)) >> 2;
+	_lastRtt = m_iRTT;
+	_queue->PublishRoundTripTime(m_iRTT);
+
+	AsyncControlEvent e;
+	e.kind = AsyncAck;
+	e.ack = ack;
+	e.rtt = m_iRTT;
+	e.rttVariance = _rttVariance;
+	e.receiveRate = m_iRcvRate;
+	e.bandwidth = m_iBandwidth;
+	_queue->Enqueue(e);
+	Apply();
+
+	if (_capture != NULL)
+		_capture->RecordAck(this, ack);
+}
+
+void AsyncCC::onLoss(const int32_t* losslist, int size)
+{
+	AsyncControlEvent e;
+	e.kind = AsyncLoss;
+	e.lossCount = min(size, (int)AsyncControlEvent::MaxLosses);
+
+	// A range start has the high bit set and its end in the next entry;
+	// don't cut between the two
+	if (e.lossCount < size && (losslist[e.lossCount - 1] & 0x80000000) != 0)
+		--e.lossCount;
+
+	memcpy(e.losses, losslist, e.lossCount * sizeof(int32_t));
+	_queue->Enqueue(e);
+	Apply();
+
+	if (_capture != NULL)
+		_capture->RecordLoss(this, losslist, size);
+}
+
+void AsyncCC::onTimeout(void)
+{
+	AsyncControlEvent e;
+	e.kind = AsyncTimeout;
+	_queue->Enqueue(e);
+	Apply();
+
+	if (_capture != NULL)
+		_capture->RecordTimeout(this);
+}
+
+void AsyncCC::onPktSent(const CPacket* packet)
+{
+	Apply();
+
+	if (_capture != NULL)
+		_capture->RecordPacket(this, CaptureDataSent, packet);
+}
+
+void AsyncCC::onPktReceived(const CPacket* packet)
+{
+	if (_capture != NULL)
+		_capture->RecordPacket(this, CaptureDataReceived, packet);
+}
+
+#pragma managed(pop)
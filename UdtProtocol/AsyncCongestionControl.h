@@ -0,0 +1,81 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+#include <ccc.h>
+
+namespace Udt
+{
+	class AsyncControlQueue;
+	class PacketCaptureRing;
+
+	/// <summary>
+	/// Native CCC in front of an asynchronous managed congestion control.
+	/// </summary>
+	/// <remarks>
+	/// Runs on the UDT threads without entering the CLR: ACKs, losses and
+	/// timeouts are copied into the queue for the controller thread, and
+	/// the window size and send period it published are applied after
+	/// every callback. The remaining members are called from the controller
+	/// thread with the queue's owner lock held.
+	/// </remarks>
+	class AsyncCC : public CCC
+	{
+	private:
+		AsyncControlQueue* _queue;
+		PacketCaptureRing* _capture;
+		int _lastRtt;
+		int _rttVariance;
+
+		void Apply(void);
+
+	public:
+		AsyncCC(AsyncControlQueue* queue, PacketCaptureRing* capture);
+		virtual ~AsyncCC(void);
+
+		virtual void init(void);
+		virtual void close(void);
+		virtual void onACK(int32_t ack);
+		virtual void onLoss(const int32_t* losslist, int size);
+		virtual void onTimeout(void);
+		virtual void onPktSent(const CPacket* packet);
+		virtual void onPktReceived(const CPacket* packet);
+
+		void SetAckTimer(int ms) { setACKTimer(ms); }
+		void SetAckInterval(int packets) { setACKInterval(packets); }
+		void SetRto(int us) { setRTO(us); }
+		const UDT::TRACEINFO* PerformanceInfo(void) { return getPerfInfo(); }
+		void SetRoundTripTime(int us) { m_iRTT = us; }
+		void SetMaxPacketSize(int bytes) { m_iMSS = bytes; }
+	};
+}
@@ -0,0 +1,145 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+
+#include <udt.h>
+
+#include "AsyncControlQueue.h"
+
+using namespace Udt;
+
+#pragma managed(push, off)
+
+AsyncControlQueue::AsyncControlQueue(int capacity)
+	: _head(0), _tail(0), _dropped(0), _closed(0), _references(1), _windowSize(0), _packetSendPeriod(0),
+	_roundTripTime(0), _maxPacketSize(0), _owner(NULL)
+{
+	int size = 1;
+
+	while (size < capacity)
+		size <<= 1;
+
+	_events = new AsyncControlEvent[size];
+	_mask = size - 1;
+	_signal = CreateEvent(NULL, FALSE, FALSE, NULL);
+	InitializeCriticalSection(&_ownerLock);
+}
+
+AsyncControlQueue::~AsyncControlQueue(void)
+{
+	DeleteCriticalSection(&_ownerLock);
+	CloseHandle(_signal);
+	delete [] _events;
+}
+
+void AsyncControlQueue::AddRef(void)
+{
+	InterlockedIncrement(&_references);
+}
+
+void AsyncControlQueue::Release(void)
+{
+	if (InterlockedDecrement(&_references) == 0)
+		delete this;
+}
+
+void AsyncControlQueue::Close(void)
+{
+	InterlockedExchange(&_closed, 1);
+	SetEvent(_signal);
+}
+
+void AsyncControlQueue::SetOwner(AsyncCC* owner)
+{
+	EnterCriticalSection(&_ownerLock);
+	_owner = owner;
+	LeaveCriticalSection(&_ownerLock);
+}
+
+AsyncCC* AsyncControlQueue::LockOwner(void)
+{
+	EnterCriticalSection(&_ownerLock);
+	return _owner;
+}
+
+void AsyncControlQueue::UnlockOwner(void)
+{
+	LeaveCriticalSection(&_ownerLock);
+}
+
+void AsyncControlQueue::Store(volatile LONGLONG* target, double value)
+{
+	LONGLONG bits;
+	memcpy(&bits, &value, sizeof(bits));
+	InterlockedExchange64(target, bits);
+}
+
+double AsyncControlQueue::Load(volatile LONGLONG* source)
+{
+	// A compare exchange that never matches is an atomic 64 bit read on x86 too
+	LONGLONG bits = InterlockedCompareExchange64(source, 0, 0);
+	double value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+void AsyncControlQueue::Enqueue(const AsyncControlEvent& e)
+{
+	LONG tail = _tail;
+
+	if (tail - _head > _mask)
+	{
+		InterlockedIncrement(&_dropped);
+		return;
+	}
+
+	_events[tail & _mask] = e;
+
+	// Publish the event before the new tail
+	InterlockedExchange(&_tail, tail + 1);
+	SetEvent(_signal);
+}
+
+bool AsyncControlQueue::TryDequeue(AsyncControlEvent& e)
+{
+	LONG head = _head;
+
+	if (head == _tail)
+		return false;
+
+	e = _events[head & _mask];
+	InterlockedExchange(&_head, head + 1);
+	return true;
+}
+
+#pragma managed(pop)
@@ -0,0 +1,162 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	class AsyncCC;
+
+	/// <summary>
+	/// Kind of <see cref="AsyncControlEvent"/>.
+	/// </summary>
+	enum AsyncControlEventKind
+	{
+		AsyncInit,
+		AsyncAck,
+		AsyncLoss,
+		AsyncTimeout
+	};
+
+	/// <summary>
+	/// Congestion control callback queued for an asynchronous controller.
+	/// </summary>
+	struct AsyncControlEvent
+	{
+		// Longer loss lists are truncated at a range boundary; the first
+		// entry is the one controllers compare against their last decrease
+		static const int MaxLosses = 64;
+
+		AsyncControlEventKind kind;
+		int ack;
+		int rtt;
+		int rttVariance;
+		int receiveRate;
+		int bandwidth;
+		int lossCount;
+		int32_t losses[MaxLosses];
+	};
+
+	/// <summary>
+	/// Single producer, single consumer queue between the UDT receive
+	/// thread and the thread of an asynchronous congestion control, plus
+	/// the decisions flowing back.
+	/// </summary>
+	/// <remarks>
+	/// The producer never blocks: an event that finds the queue full is
+	/// counted in <see cref="Dropped"/> and discarded. Window size and send
+	/// period are published with atomic 64 bit writes and applied to the
+	/// CCC on the next UDT callback. Reference counted; the
+	/// <see cref="AsyncCC"/> and the controller thread each hold a
+	/// reference, and the CCC detaches itself under the owner lock before
+	/// UDT deletes it.
+	/// </remarks>
+	class AsyncControlQueue
+	{
+	private:
+		AsyncControlEvent* _events;
+		LONG _mask;
+		volatile LONG _head;
+		volatile LONG _tail;
+		volatile LONG _dropped;
+		volatile LONG _closed;
+		volatile LONG _references;
+		volatile LONGLONG _windowSize;
+		volatile LONGLONG _packetSendPeriod;
+		volatile LONG _roundTripTime;
+		volatile LONG _maxPacketSize;
+		HANDLE _signal;
+		CRITICAL_SECTION _ownerLock;
+		AsyncCC* _owner;
+
+		AsyncControlQueue(const AsyncControlQueue&);
+		AsyncControlQueue& operator=(const AsyncControlQueue&);
+		~AsyncControlQueue(void);
+
+		static void Store(volatile LONGLONG* target, double value);
+		static double Load(volatile LONGLONG* source);
+
+	public:
+
+		/// <param name="capacity">Number of events, rounded up to a power of 2.</param>
+		AsyncControlQueue(int capacity);
+
+		void AddRef(void);
+		void Release(void);
+
+		/// <summary>
+		/// Auto reset event set after each enqueue.
+		/// </summary>
+		HANDLE Signal(void) const { return _signal; }
+
+		int Dropped(void) const { return _dropped; }
+
+		/// <summary>
+		/// Queue an event; called only from the producer thread.
+		/// </summary>
+		void Enqueue(const AsyncControlEvent& e);
+
+		/// <summary>
+		/// Dequeue an event; called only from the consumer thread.
+		/// </summary>
+		bool TryDequeue(AsyncControlEvent& e);
+
+		void PublishWindowSize(double value) { Store(&_windowSize, value); }
+		double WindowSize(void) { return Load(&_windowSize); }
+
+		void PublishPacketSendPeriod(double value) { Store(&_packetSendPeriod, value); }
+		double PacketSendPeriod(void) { return Load(&_packetSendPeriod); }
+
+		void PublishRoundTripTime(int value) { InterlockedExchange(&_roundTripTime, value); }
+		int RoundTripTime(void) const { return _roundTripTime; }
+
+		void PublishMaxPacketSize(int value) { InterlockedExchange(&_maxPacketSize, value); }
+		int MaxPacketSize(void) const { return _maxPacketSize; }
+
+		/// <summary>
+		/// Mark the connection closed and wake the consumer, which delivers
+		/// the events still queued and then stops.
+		/// </summary>
+		void Close(void);
+
+		bool IsClosed(void) const { return _closed != 0; }
+
+		void SetOwner(AsyncCC* owner);
+
+		/// <summary>
+		/// Lock the CCC against deletion and return it, or NULL once UDT
+		/// has deleted it. Always pair with <see cref="UnlockOwner"/>.
+		/// </summary>
+		AsyncCC* LockOwner(void);
+		void UnlockOwner(void);
+	};
+}
@@ -0,0 +1,165 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "BandwidthShaper.h"
+
+#include <udt.h>
+
+#include "TokenBucketNode.h"
+
+using namespace Udt;
+using namespace System;
+using namespace System::Threading;
+
+BandwidthShaper::BandwidthShaper(__int64 rate)
+	: _node(NULL), _parent(nullptr), _isDisposed(false)
+{
+	if (rate < 1) throw gcnew ArgumentOutOfRangeException("rate", rate, "Value must be greater than 0.");
+
+	_node = new TokenBucketNode(NULL, (double)rate, (double)rate, (double)DefaultBurst(rate));
+}
+
+BandwidthShaper::BandwidthShaper(BandwidthShaper^ parent, __int64 rate, __int64 ceiling)
+	: _node(NULL), _parent(parent), _isDisposed(false)
+{
+	if (parent == nullptr) throw gcnew ArgumentNullException("parent");
+	if (rate < 0) throw gcnew ArgumentOutOfRangeException("rate", rate, "Value must be greater than or equal to 0.");
+	if (ceiling < 1) throw gcnew ArgumentOutOfRangeException("ceiling", ceiling, "Value must be greater than 0.");
+	if (ceiling < rate) throw gcnew ArgumentOutOfRangeException("ceiling", ceiling, "Value must be greater than or equal to rate.");
+
+	_node = new TokenBucketNode(parent->GetNode(), (double)rate, (double)ceiling, (double)DefaultBurst(ceiling));
+}
+
+BandwidthShaper::~BandwidthShaper(void)
+{
+	if (_isDisposed)
+		return;
+
+	this->!BandwidthShaper();
+	_isDisposed = true;
+}
+
+BandwidthShaper::!BandwidthShaper(void)
+{
+	if (_node != NULL)
+	{
+		_node->Release();
+		_node = NULL;
+	}
+}
+
+__int64 BandwidthShaper::DefaultBurst(__int64 ceiling)
+{
+	return Math::Max(ceiling / 100, (__int64)SendChunkSize);
+}
+
+TokenBucketNode* BandwidthShaper::GetNode(void)
+{
+	if (_isDisposed) throw gcnew ObjectDisposedException(ToString());
+	return _node;
+}
+
+void BandwidthShaper::Wait(TokenBucketNode* node)
+{
+	__int64 delay;
+
+	while ((delay = node->Delay()) > 0)
+		Thread::Sleep((int)Math::Min((delay + 999) / 1000, (__int64)1000));
+}
+
+__int64 BandwidthShaper::Rate::get(void)
+{
+	return (__int64)GetNode()->Rate();
+}
+
+void BandwidthShaper::Rate::set(__int64 value)
+{
+	TokenBucketNode* node = GetNode();
+
+	if (_parent == nullptr)
+	{
+		if (value < 1) throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than 0.");
+		node->SetRates((double)value, (double)value, node->Burst());
+	}
+	else
+	{
+		if (value < 0) throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than or equal to 0.");
+		if (value > node->Ceiling()) throw gcnew ArgumentOutOfRangeException("value", value, "Value must be less than or equal to Ceiling.");
+		node->SetRates((double)value, node->Ceiling(), node->Burst());
+	}
+}
+
+__int64 BandwidthShaper::Ceiling::get(void)
+{
+	return (__int64)GetNode()->Ceiling();
+}
+
+void BandwidthShaper::Ceiling::set(__int64 value)
+{
+	TokenBucketNode* node = GetNode();
+
+	if (_parent == nullptr) throw gcnew InvalidOperationException("The ceiling of the root shaper is its rate.");
+	if (value < 1) throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than 0.");
+	if (value < node->Rate()) throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than or equal to Rate.");
+
+	node->SetRates(node->Rate(), (double)value, node->Burst());
+}
+
+__int64 BandwidthShaper::Burst::get(void)
+{
+	return (__int64)GetNode()->Burst();
+}
+
+void BandwidthShaper::Burst::set(__int64 value)
+{
+	TokenBucketNode* node = GetNode();
+
+	if (value < 1) throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than 0.");
+
+	node->SetRates(node->Rate(), node->Ceiling(), (double)value);
+}
+
+__int64 BandwidthShaper::BytesSent::get(void)
+{
+	return GetNode()->BytesSent();
+}
+
+__int64 BandwidthShaper::BytesBorrowed::get(void)
+{
+	return GetNode()->BytesBorrowed();
+}
+
+__int64 BandwidthShaper::ThrottleCount::get(void)
+{
+	return GetNode()->ThrottleCount();
+}
@@ -0,0 +1,202 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	class TokenBucketNode;
+
+	/// <summary>
+	/// Node of a hierarchical bandwidth shaper shared by many sockets.
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Build a tree such as host, then tenant, then socket: create the root
+	/// with the host's rate, and children with
+	/// <see cref="BandwidthShaper(BandwidthShaper^, __int64, __int64)"/>.
+	/// Assign a node to <see cref="Socket::Shaper"/>; several sockets may
+	/// share a node. Before data is passed to UDT, the socket waits until
+	/// the node and all its ancestors allow it.
+	/// </para>
+	/// <para>
+	/// Each node is guaranteed its <see cref="Rate"/> and may borrow the
+	/// unused rate of its ancestors up to its <see cref="Ceiling"/>, as in
+	/// Linux HTB. The root's ceiling is its rate. Rates can be changed at
+	/// any time and apply to the next send. Unlike
+	/// <see cref="SocketOptionName::MaxBandwidth"/>, the limit covers
+	/// payload bytes handed to UDT, not packets on the wire, and is
+	/// enforced across sockets.
+	/// </para>
+	/// <para>
+	/// <see cref="Socket::Send(cli::array&lt;System::Byte&gt;^, int, int)"/>
+	/// and the <c>SendMessage</c> methods are shaped. <c>SendFile</c> is not.
+	/// </para>
+	/// </remarks>
+	public ref class BandwidthShaper : public System::IDisposable
+	{
+	private:
+		TokenBucketNode* _node;
+		BandwidthShaper^ _parent;
+		bool _isDisposed;
+
+		TokenBucketNode* GetNode(void);
+		static __int64 DefaultBurst(__int64 ceiling);
+
+	internal:
+		property TokenBucketNode* Node { TokenBucketNode* get(void) { return GetNode(); } }
+
+		/// <summary>
+		/// Block until <paramref name="node"/> allows sending.
+		/// </summary>
+		static void Wait(TokenBucketNode* node);
+
+	public:
+
+		/// <summary>
+		/// Largest amount a socket hands to UDT in one call while shaped,
+		/// in bytes.
+		/// </summary>
+		literal int SendChunkSize = 65536;
+
+		/// <summary>
+		/// Initialize a new root shaper.
+		/// </summary>
+		/// <param name="rate">Rate in bytes per second.</param>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="rate"/> is less than 1.</exception>
+		BandwidthShaper(__int64 rate);
+
+		/// <summary>
+		/// Initialize a new shaper below <paramref name="parent"/>.
+		/// </summary>
+		/// <param name="parent">Parent shaper to borrow from.</param>
+		/// <param name="rate">Guaranteed rate in bytes per second.</param>
+		/// <param name="ceiling">Largest rate including borrowed share, in bytes per second.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="parent"/> is null.</exception>
+		/// <exception cref="System::ObjectDisposedException">If <paramref name="parent"/> is disposed.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="rate"/> is less than 0 or <paramref name="ceiling"/> is less than 1 or less than <paramref name="rate"/>.</exception>
+		BandwidthShaper(BandwidthShaper^ parent, __int64 rate, __int64 ceiling);
+
+		virtual ~BandwidthShaper(void);
+		!BandwidthShaper(void);
+
+		/// <summary>
+		/// Get the parent shaper, or null for the root.
+		/// </summary>
+		property BandwidthShaper^ Parent
+		{
+			BandwidthShaper^ get(void) { return _parent; }
+		}
+
+		/// <summary>
+		/// Get or set the guaranteed rate in bytes per second.
+		/// </summary>
+		/// <remarks>
+		/// Setting the rate of the root also sets its ceiling.
+		/// </remarks>
+		/// <exception cref="System::ArgumentOutOfRangeException">If the value is less than 0, less than 1 for the root or greater than <see cref="Ceiling"/>.</exception>
+		/// <exception cref="System::ObjectDisposedException">If the shaper is disposed.</exception>
+		property __int64 Rate
+		{
+			__int64 get(void);
+			void set(__int64 value);
+		}
+
+		/// <summary>
+		/// Get or set the largest rate including borrowed share, in bytes
+		/// per second.
+		/// </summary>
+		/// <exception cref="System::ArgumentOutOfRangeException">If the value is less than 1 or less than <see cref="Rate"/>.</exception>
+		/// <exception cref="System::InvalidOperationException">If setting the ceiling of the root.</exception>
+		/// <exception cref="System::ObjectDisposedException">If the shaper is disposed.</exception>
+		property __int64 Ceiling
+		{
+			__int64 get(void);
+			void set(__int64 value);
+		}
+
+		/// <summary>
+		/// Get or set the largest burst in bytes.
+		/// </summary>
+		/// <remarks>
+		/// Defaults to 10 milliseconds at the ceiling, and at least
+		/// <see cref="SendChunkSize"/>.
+		/// </remarks>
+		/// <exception cref="System::ArgumentOutOfRangeException">If the value is less than 1.</exception>
+		/// <exception cref="System::ObjectDisposedException">If the shaper is disposed.</exception>
+		property __int64 Burst
+		{
+			__int64 get(void);
+			void set(__int64 value);
+		}
+
+		/// <summary>
+		/// Get the bytes sent through this shaper and its descendants.
+		/// </summary>
+		/// <exception cref="System::ObjectDisposedException">If the shaper is disposed.</exception>
+		property __int64 BytesSent
+		{
+			__int64 get(void);
+		}
+
+		/// <summary>
+		/// Get the bytes this shaper sent beyond its own rate using share
+		/// borrowed from an ancestor.
+		/// </summary>
+		/// <exception cref="System::ObjectDisposedException">If the shaper is disposed.</exception>
+		property __int64 BytesBorrowed
+		{
+			__int64 get(void);
+		}
+
+		/// <summary>
+		/// Get the number of sends that had to wait for this shaper.
+		/// </summary>
+		/// <exception cref="System::ObjectDisposedException">If the shaper is disposed.</exception>
+		property __int64 ThrottleCount
+		{
+			__int64 get(void);
+		}
+
+		/// <summary>
+		/// Get true if the shaper has been disposed.
+		/// </summary>
+		/// <remarks>
+		/// Sockets and children already using a disposed shaper keep it
+		/// alive and keep being shaped by it.
+		/// </remarks>
+		property bool IsDisposed
+		{
+			bool get(void) { return _isDisposed; }
+		}
+	};
+}
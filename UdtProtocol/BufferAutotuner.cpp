@@ -0,0 +1,224 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "BufferAutotuner.h"
+
+#include "Socket.h"
+#include "TraceInfo.h"
+
+using namespace Udt;
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Net;
+using namespace System::Threading;
+
+namespace
+{
+	// Weight of a new measurement in the smoothed estimate
+	const double NewSampleWeight = 0.25;
+
+	// UDT keeps 28 bytes of each packet for the IP and UDP headers
+	const int PacketOverhead = 28;
+}
+
+BufferAutotuner::BufferAutotuner(void)
+	: _routes(gcnew Dictionary<IPAddress^, RouteEstimate>()),
+	_minimumBufferSize(DefaultMinimumBufferSize),
+	_maximumBufferSize(DefaultMaximumBufferSize),
+	_factor(DefaultFactor)
+{
+}
+
+void BufferAutotuner::Observe(Socket^ socket)
+{
+	if (socket == nullptr) throw gcnew ArgumentNullException("socket");
+
+	if (socket->State != SocketState::Connected)
+		return;
+
+	IPEndPoint^ remote = socket->RemoteEndPoint;
+	ProbeTraceInfo^ probe = socket->GetPerformanceInfo(false)->Probe;
+	double seconds = probe->RoundtripTime.TotalSeconds;
+
+	if (remote == nullptr || seconds <= 0 || probe->BandwidthMbps <= 0)
+		return;
+
+	double bytes = probe->BandwidthMbps * 1000000.0 / 8.0 * seconds;
+
+	Monitor::Enter(_routes);
+
+	try
+	{
+		RouteEstimate estimate;
+
+		if (_routes->TryGetValue(remote->Address, estimate))
+		{
+			estimate.Bytes += (bytes - estimate.Bytes) * NewSampleWeight;
+		}
+		else
+		{
+			if (_routes->Count >= MaxRoutes)
+				EvictOldest();
+
+			estimate.Bytes = bytes;
+		}
+
+		estimate.Updated = DateTime::UtcNow.Ticks;
+		_routes[remote->Address] = estimate;
+	}
+	finally
+	{
+		Monitor::Exit(_routes);
+	}
+}
+
+void BufferAutotuner::EvictOldest(void)
+{
+	IPAddress^ oldest = nullptr;
+	__int64 oldestUpdated = Int64::MaxValue;
+
+	for each (KeyValuePair<IPAddress^, RouteEstimate> route in _routes)
+	{
+		if (route.Value.Updated < oldestUpdated)
+		{
+			oldest = route.Key;
+			oldestUpdated = route.Value.Updated;
+		}
+	}
+
+	if (oldest != nullptr)
+		_routes->Remove(oldest);
+}
+
+int BufferAutotuner::GetBufferSize(IPAddress^ address)
+{
+	if (address == nullptr) throw gcnew ArgumentNullException("address");
+
+	RouteEstimate estimate;
+	bool found;
+
+	Monitor::Enter(_routes);
+
+	try
+	{
+		found = _routes->TryGetValue(address, estimate);
+	}
+	finally
+	{
+		Monitor::Exit(_routes);
+	}
+
+	if (!found)
+		return 0;
+
+	double size = estimate.Bytes * _factor;
+	return (int)Math::Max((double)_minimumBufferSize, Math::Min((double)_maximumBufferSize, size));
+}
+
+bool BufferAutotuner::Apply(Socket^ socket, IPAddress^ address)
+{
+	if (socket == nullptr) throw gcnew ArgumentNullException("socket");
+	if (address == nullptr) throw gcnew ArgumentNullException("address");
+
+	int size = GetBufferSize(address);
+
+	if (size == 0)
+		return false;
+
+	// UDT caps the receive buffer at the flow window, so the window goes first
+	int payload = socket->MaxPacketSize - PacketOverhead;
+	socket->MaxWindowSize = Math::Max(32, size / payload);
+
+	// UDT fixes the buffers once the socket is opened by bind
+	if (socket->State == SocketState::Initial)
+	{
+		socket->SendBufferSize = size;
+		socket->ReceiveBufferSize = size;
+		socket->UdpSendBufferSize = size;
+		socket->UdpReceiveBufferSize = size;
+	}
+
+	return true;
+}
+
+void BufferAutotuner::Clear(void)
+{
+	Monitor::Enter(_routes);
+
+	try
+	{
+		_routes->Clear();
+	}
+	finally
+	{
+		Monitor::Exit(_routes);
+	}
+}
+
+int BufferAutotuner::Count::get(void)
+{
+	Monitor::Enter(_routes);
+
+	try
+	{
+		return _routes->Count;
+	}
+	finally
+	{
+		Monitor::Exit(_routes);
+	}
+}
+
+void BufferAutotuner::MinimumBufferSize::set(int value)
+{
+	if (value < 1 || value > _maximumBufferSize)
+		throw gcnew ArgumentOutOfRangeException("value", value, "Value must be between 1 and MaximumBufferSize.");
+
+	_minimumBufferSize = value;
+}
+
+void BufferAutotuner::MaximumBufferSize::set(int value)
+{
+	if (value < _minimumBufferSize)
+		throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than or equal to MinimumBufferSize.");
+
+	_maximumBufferSize = value;
+}
+
+void BufferAutotuner::Factor::set(double value)
+{
+	if (!(value > 0))
+		throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than 0.");
+
+	_factor = value;
+}
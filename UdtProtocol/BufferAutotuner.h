@@ -0,0 +1,188 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	ref class Socket;
+
+	/// <summary>
+	/// Sizes socket buffers and the flow window from the bandwidth-delay
+	/// product measured on earlier connections to the same host.
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// UDT fixes its buffers when a socket is opened and its flow window
+	/// when it connects, so they can not follow the path of a live
+	/// connection. Instead, assign
+	/// one autotuner to <see cref="Socket::Autotuner"/> of every socket.
+	/// When a socket closes, its round trip time and bandwidth estimate
+	/// from <see cref="ProbeTraceInfo"/> update a per-host estimate of the
+	/// bandwidth-delay product. Before a socket connects, its
+	/// <see cref="Socket::SendBufferSize"/>,
+	/// <see cref="Socket::ReceiveBufferSize"/>,
+	/// <see cref="Socket::UdpSendBufferSize"/>,
+	/// <see cref="Socket::UdpReceiveBufferSize"/> and
+	/// <see cref="Socket::MaxWindowSize"/> are set to <see cref="Factor"/>
+	/// times the estimate for the host, between
+	/// <see cref="MinimumBufferSize"/> and <see cref="MaximumBufferSize"/>.
+	/// Sockets bound before they connect only get the flow window. Hosts
+	/// without an estimate keep the socket's own settings.
+	/// </para>
+	/// <para>
+	/// Estimates are smoothed, so they grow and shrink with the path over
+	/// several connections. Long lived connections can report earlier
+	/// with <see cref="Observe"/>. All members are thread safe.
+	/// </para>
+	/// </remarks>
+	public ref class BufferAutotuner
+	{
+	private:
+		value struct RouteEstimate
+		{
+			double Bytes;
+			__int64 Updated;
+		};
+
+		System::Collections::Generic::Dictionary<System::Net::IPAddress^, RouteEstimate>^ _routes;
+		int _minimumBufferSize;
+		int _maximumBufferSize;
+		double _factor;
+
+		literal int MaxRoutes = 4096;
+
+		void EvictOldest(void);
+
+	public:
+
+		/// <summary>
+		/// Default value of <see cref="MinimumBufferSize"/>.
+		/// </summary>
+		literal int DefaultMinimumBufferSize = 256 * 1024;
+
+		/// <summary>
+		/// Default value of <see cref="MaximumBufferSize"/>.
+		/// </summary>
+		literal int DefaultMaximumBufferSize = 64 * 1024 * 1024;
+
+		/// <summary>
+		/// Default value of <see cref="Factor"/>.
+		/// </summary>
+		literal double DefaultFactor = 2.0;
+
+		/// <summary>
+		/// Initialize a new instance with the default limits.
+		/// </summary>
+		BufferAutotuner(void);
+
+		/// <summary>
+		/// Record the path measurements of a connected socket.
+		/// </summary>
+		/// <remarks>
+		/// Sockets using this autotuner are observed automatically when
+		/// they close. Sockets that are not connected or have no
+		/// measurements yet are ignored.
+		/// </remarks>
+		/// <param name="socket">Socket to observe.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="socket"/> is null.</exception>
+		void Observe(Socket^ socket);
+
+		/// <summary>
+		/// Size the buffers and flow window of an unconnected socket for a
+		/// host.
+		/// </summary>
+		/// <remarks>
+		/// Sockets using this autotuner are tuned automatically when they
+		/// connect. The buffers of a bound socket are left as they are,
+		/// since UDT no longer accepts them.
+		/// </remarks>
+		/// <param name="socket">Socket to tune.</param>
+		/// <param name="address">Host the socket will connect to.</param>
+		/// <returns>True if the socket was tuned; false if there is no estimate for the host.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="socket"/> or <paramref name="address"/> is null.</exception>
+		/// <exception cref="SocketException">If the socket is already connected.</exception>
+		bool Apply(Socket^ socket, System::Net::IPAddress^ address);
+
+		/// <summary>
+		/// Get the buffer size that would be applied for a host, or 0 if
+		/// there is no estimate for it.
+		/// </summary>
+		/// <param name="address">Host address.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="address"/> is null.</exception>
+		int GetBufferSize(System::Net::IPAddress^ address);
+
+		/// <summary>
+		/// Forget all estimates.
+		/// </summary>
+		void Clear(void);
+
+		/// <summary>
+		/// Get or set the smallest buffer size applied, in bytes.
+		/// </summary>
+		/// <exception cref="System::ArgumentOutOfRangeException">If the value is less than 1 or greater than <see cref="MaximumBufferSize"/>.</exception>
+		property int MinimumBufferSize
+		{
+			int get(void) { return _minimumBufferSize; }
+			void set(int value);
+		}
+
+		/// <summary>
+		/// Get or set the largest buffer size applied, in bytes.
+		/// </summary>
+		/// <exception cref="System::ArgumentOutOfRangeException">If the value is less than <see cref="MinimumBufferSize"/>.</exception>
+		property int MaximumBufferSize
+		{
+			int get(void) { return _maximumBufferSize; }
+			void set(int value);
+		}
+
+		/// <summary>
+		/// Get or set the buffer size as a multiple of the bandwidth-delay
+		/// product.
+		/// </summary>
+		/// <exception cref="System::ArgumentOutOfRangeException">If the value is not greater than 0.</exception>
+		property double Factor
+		{
+			double get(void) { return _factor; }
+			void set(double value);
+		}
+
+		/// <summary>
+		/// Get the number of hosts with an estimate.
+		/// </summary>
+		property int Count
+		{
+			int get(void);
+		}
+	};
+}
@@ -0,0 +1,59 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+#include <ccc.h>
+
+namespace Udt
+{
+	/// <summary>
+	/// Reaches the protected CCC state that CUDT maintains through
+	/// friendship, for code that drives or observes a CCC outside of a
+	/// UDT socket.
+	/// </summary>
+	class CCCState : public CCC
+	{
+	private:
+		CCCState(void);
+
+	public:
+		static double& PacketSendPeriod(CCC* cc) { return cc->*(&CCCState::m_dPktSndPeriod); }
+		static double& WindowSize(CCC* cc) { return cc->*(&CCCState::m_dCWndSize); }
+		static double& MaxWindowSize(CCC* cc) { return cc->*(&CCCState::m_dMaxCWndSize); }
+		static int& Bandwidth(CCC* cc) { return cc->*(&CCCState::m_iBandwidth); }
+		static int& MaxPacketSize(CCC* cc) { return cc->*(&CCCState::m_iMSS); }
+		static int32_t& SendCurrentSequence(CCC* cc) { return cc->*(&CCCState::m_iSndCurrSeqNo); }
+		static int& ReceiveRate(CCC* cc) { return cc->*(&CCCState::m_iRcvRate); }
+		static int& RoundtripTime(CCC* cc) { return cc->*(&CCCState::m_iRTT); }
+	};
+}
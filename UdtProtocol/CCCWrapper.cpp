@@ -33,26 +33,111 @@
 #include "StdAfx.h"
 #include "CCCWrapper.h"
 #include "Packet.h"
+#include "PacketCaptureRing.h"
+#include "DelayTracker.h"
 
 using namespace Udt;
 using namespace System;
+using namespace System::Collections::Generic;
 
 CCCWrapper::CCCWrapper(Udt::CongestionControl^ wrapped)
-	: _wrapped(nullptr)
+	: _wrapped(nullptr), _capture(NULL), _lastRtt(0), _rttVariance(0), _delay(NULL)
+{
+	Attach(wrapped);
+}
+
+CCCWrapper::CCCWrapper(Udt::CongestionControl^ wrapped, PacketCaptureRing* capture)
+	: _wrapped(nullptr), _capture(NULL), _lastRtt(0), _rttVariance(0), _delay(NULL)
+{
+	Attach(wrapped);
+
+	if (capture != NULL)
+	{
+		_capture = capture;
+		_capture->AddRef();
+	}
+}
+
+CCCWrapper::~CCCWrapper(void)
+{
+	if (_capture != NULL)
+		_capture->Release();
+
+	delete _delay;
+}
+
+void CCCWrapper::Attach(Udt::CongestionControl^ wrapped)
 {
 	if (wrapped->_cccWrapper != NULL) throw gcnew InvalidOperationException("Congestion control object already in use. Can not reuse congestion control objects.");
 	if (wrapped->IsDisposed) throw gcnew InvalidOperationException("Invalid congestion control object. Object is disposed.");
 
 	_wrapped = wrapped;
 	_wrapped->_cccWrapper = this;
+
+	// Only pay for the clock reads if someone listens
+	Reflection::MethodInfo^ onDelay = wrapped->GetType()->GetMethod("OnDelay", gcnew cli::array<Type^> { DelayInfo::typeid, IList<int>::typeid });
+
+	if (onDelay != nullptr && onDelay->DeclaringType != CongestionControl::typeid)
+		_delay = new DelayTracker();
 }
 
-CCCWrapper::~CCCWrapper(void)
+void CCCWrapper::DeliverDelay(void)
 {
+	DelaySummary summary = _delay->Flush();
+	NativeIntArray^ list = gcnew NativeIntArray(_delay->Samples(), summary.count);
+
+	__try
+	{
+		_wrapped->OnDelay(DelayInfo(summary.count, summary.current, summary.base, summary.gradient), list);
+	}
+	__finally
+	{
+		delete list;
+	}
+}
+
+void CCCWrapper::init()
+{
+	// CUDT starts with variance half the initial RTT
+	_lastRtt = m_iRTT;
+	_rttVariance = m_iRTT >> 1;
+
+	_wrapped->Initialize();
+}
+
+void CCCWrapper::close()
+{
+	_wrapped->Close();
+}
+
+void CCCWrapper::onTimeout()
+{
+	_wrapped->OnTimeout();
+
+	if (_capture != NULL)
+		_capture->RecordTimeout(this);
+}
+
+void CCCWrapper::onACK(int32_t ack)
+{
+	// CUDT folds each sample into m_iRTT as (7 * rtt + sample) / 8 right
+	// before onACK, so the sample can be recovered and the variance
+	// tracked with CUDT's own estimator.
+	int sample = max(0, 8 * m_iRTT - 7 * _lastRtt);
+	_rttVariance = (_rttVariance * 3 + abs(_lastRtt - sample)) >> 2;
+	_lastRtt = m_iRTT;
+
+	_wrapped->OnAck(AckInfo(ack, m_iRTT, _rttVariance, m_iRcvRate, m_iBandwidth));
+
+	if (_capture != NULL)
+		_capture->RecordAck(this, ack);
 }
 
 void CCCWrapper::onPktReceived(const CPacket* packet)
 {
+	if (_capture != NULL)
+		_capture->RecordPacket(this, CaptureDataReceived, packet);
+
 	Packet^ managedPacket = Packet::Wrap(packet);
 
 	__try
@@ -63,10 +148,16 @@ void CCCWrapper::onPktReceived(const CPacket* packet)
 	{
 		delete managedPacket;
 	}
+
+	if (_delay != NULL && !packet->getFlag() && _delay->Add(packet->m_iTimeStamp))
+		DeliverDelay();
 }
 
 void CCCWrapper::onPktSent(const CPacket* packet)
 {
+	if (_capture != NULL)
+		_capture->RecordPacket(this, CaptureDataSent, packet);
+
 	Packet^ managedPacket = Packet::Wrap(packet);
 
 	__try
@@ -105,6 +196,9 @@ void CCCWrapper::onLoss(const int32_t* losslist, int size)
 	{
 		delete list;
 	}
+
+	if (_capture != NULL)
+		_capture->RecordLoss(this, losslist, size);
 }
 
 void CCCWrapper::setACKTimer(TimeSpan value)
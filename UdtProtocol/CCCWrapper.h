@@ -41,21 +41,31 @@
 namespace Udt
 {
 	ref class Packet;
+	class PacketCaptureRing;
+	class DelayTracker;
 
 	class CCCWrapper : public CCC
 	{
 	private:
 		gcroot<CongestionControl^> _wrapped;
+		PacketCaptureRing* _capture;
+		int _lastRtt;
+		int _rttVariance;
+		DelayTracker* _delay;
+
+		void Attach(CongestionControl^ wrapped);
+		void DeliverDelay(void);
 
 	public:
 
 		CCCWrapper(CongestionControl^ wrapped);
+		CCCWrapper(CongestionControl^ wrapped, PacketCaptureRing* capture);
 		virtual ~CCCWrapper(void);
 
-		virtual void init() { _wrapped->Initialize(); }
-		virtual void close() { _wrapped->Close(); }
-		virtual void onTimeout() { _wrapped->OnTimeout(); }
-		virtual void onACK(int32_t ack) { _wrapped->OnAck(ack); }
+		virtual void init();
+		virtual void close();
+		virtual void onTimeout();
+		virtual void onACK(int32_t ack);
 		virtual void onLoss(const int32_t* losslist, int size);
 		virtual void onPktReceived(const CPacket* packet);
 		virtual void onPktSent(const CPacket*);
@@ -36,24 +36,82 @@
 
 #include "CCCWrapperFactory.h"
 #include "CCCWrapper.h"
+#include "PacketCaptureRing.h"
+#include "AsyncControlQueue.h"
+#include "AsyncCongestionControl.h"
+#include "CongestionControlDispatcher.h"
+#include "NativeCongestionControlFactory.h"
+#include "CongestionControlGroup.h"
+#include "CoupledCongestionControl.h"
 
 using namespace Udt;
+using namespace System;
 
 CCCWrapperFactory::CCCWrapperFactory(ICongestionControlFactory^ managedFactory)
-	: _managedFactory(managedFactory)
+	: _managedFactory(managedFactory), _capture(NULL), _synchronous(true)
 {
 }
 
+CCCWrapperFactory::CCCWrapperFactory(ICongestionControlFactory^ managedFactory, PacketCaptureRing* capture)
+	: _managedFactory(managedFactory), _capture(capture), _synchronous(false)
+{
+	if (_capture != NULL)
+		_capture->AddRef();
+}
+
+CCCWrapperFactory::CCCWrapperFactory(ICongestionControlFactory^ managedFactory, PacketCaptureRing* capture, bool synchronous)
+	: _managedFactory(managedFactory), _capture(capture), _synchronous(synchronous)
+{
+	if (_capture != NULL)
+		_capture->AddRef();
+}
+
 CCCWrapperFactory::~CCCWrapperFactory(void)
 {
+	if (_capture != NULL)
+		_capture->Release();
 }
 
 CCC* CCCWrapperFactory::create()
 {
-	return new CCCWrapper(_managedFactory->CreateCongestionControl());
+	CongestionControl^ controller = _managedFactory->CreateCongestionControl();
+
+	if (_synchronous || !controller->IsAsynchronous)
+		return new CCCWrapper(controller, _capture);
+
+	if (controller->_cccWrapper != NULL || controller->_asyncQueue != NULL) throw gcnew InvalidOperationException("Congestion control object already in use. Can not reuse congestion control objects.");
+	if (controller->IsDisposed) throw gcnew InvalidOperationException("Invalid congestion control object. Object is disposed.");
+
+	AsyncControlQueue* queue = new AsyncControlQueue(1024);
+	AsyncCC* cc = new AsyncCC(queue, _capture);
+
+	// The dispatcher takes over the reference from the constructor
+	controller->_asyncQueue = queue;
+	(gcnew CongestionControlDispatcher(controller, queue))->Start();
+
+	return cc;
 }
 
 CCCVirtualFactory* CCCWrapperFactory::clone()
 {
-	return new CCCWrapperFactory(_managedFactory);
+	return new CCCWrapperFactory(_managedFactory, _capture, _synchronous);
+}
+
+CCC* CCCWrapperFactory::CreateOffline(ICongestionControlFactory^ factory)
+{
+	NativeCongestionControlFactory^ native = dynamic_cast<NativeCongestionControlFactory^>(factory);
+
+	if (native != nullptr)
+		return native->Factory->create();
+
+	CongestionControlGroup^ group = dynamic_cast<CongestionControlGroup^>(factory);
+
+	if (group != nullptr)
+	{
+		CoupledCCFactory coupled(group->State, NULL);
+		return coupled.create();
+	}
+
+	CCCWrapperFactory wrapper(factory);
+	return wrapper.create();
 }
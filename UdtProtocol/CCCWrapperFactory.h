@@ -38,18 +38,40 @@
 namespace Udt
 {
 	interface class ICongestionControlFactory;
+	class PacketCaptureRing;
 
 	class CCCWrapperFactory : public CCCVirtualFactory
 	{
 	private:
 		gcroot<ICongestionControlFactory^> _managedFactory;
+		PacketCaptureRing* _capture;
+		bool _synchronous;
+
+		CCCWrapperFactory(ICongestionControlFactory^ managedFactory, PacketCaptureRing* capture, bool synchronous);
 
 	public:
 
+		/// <summary>
+		/// Factory that runs every controller on the calling thread, for
+		/// simulations and capture replays.
+		/// </summary>
 		CCCWrapperFactory(ICongestionControlFactory^ managedFactory);
+
+		/// <summary>
+		/// Factory for sockets; asynchronous controllers get an
+		/// <see cref="AsyncCC"/> and a dispatcher thread.
+		/// </summary>
+		CCCWrapperFactory(ICongestionControlFactory^ managedFactory, PacketCaptureRing* capture);
 		virtual ~CCCWrapperFactory(void);
 		
 		virtual CCC* create();
 		virtual CCCVirtualFactory* clone();
+
+		/// <summary>
+		/// Create a controller from any factory for a simulation or capture
+		/// replay. Managed controllers run on the calling thread; native
+		/// plug-ins and group members are created as a socket gets them.
+		/// </summary>
+		static CCC* CreateOffline(ICongestionControlFactory^ factory);
 	};
 }
@@ -0,0 +1,403 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "CaptureReplay.h"
+
+#include "ICongestionControlFactory.h"
+#include "CCCWrapperFactory.h"
+#include "CCCState.h"
+
+#include <udt.h>
+#include <ccc.h>
+#include <packet.h>
+
+#include <vector>
+
+using namespace Udt;
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Globalization;
+using namespace System::IO;
+using namespace System::Text;
+
+namespace Udt
+{
+	/// <summary>
+	/// UDT packet or event read from a capture.
+	/// </summary>
+	private ref class CaptureReplayRecord
+	{
+	public:
+		__int64 Time;
+		bool Outbound;
+		cli::array<Byte>^ Data;
+		int OriginalLength;
+		String^ Comment;
+	};
+}
+
+namespace
+{
+	const unsigned int SectionHeaderBlock = 0x0A0D0D0A;
+	const unsigned int InterfaceDescriptionBlock = 1;
+	const unsigned int EnhancedPacketBlock = 6;
+	const unsigned int ByteOrderMagic = 0x1A2B3C4D;
+
+	// UDT default flow window (UDT_FC)
+	const int FlowWindowSize = 25600;
+
+	int Pad4(int length)
+	{
+		return (length + 3) & ~3;
+	}
+
+	unsigned int ReadBigEndian32(cli::array<Byte>^ data, int offset)
+	{
+		return ((unsigned int)data[offset] << 24) | ((unsigned int)data[offset + 1] << 16) | ((unsigned int)data[offset + 2] << 8) | data[offset + 3];
+	}
+
+	__int64 ToTicks(unsigned __int64 value, Byte resolution)
+	{
+		if ((resolution & 0x80) != 0)
+			return (__int64)(value * 10000000.0 / Math::Pow(2, resolution & 0x7F));
+
+		__int64 ticks = (__int64)value;
+
+		for (int i = resolution; i < 7; ++i)
+			ticks *= 10;
+
+		for (int i = 7; i < resolution; ++i)
+			ticks /= 10;
+
+		return ticks;
+	}
+
+	/// <summary>
+	/// Read the UDT packets of one pcapng interface.
+	/// </summary>
+	List<CaptureReplayRecord^>^ ReadConnection(Stream^ stream, int connection)
+	{
+		BinaryReader^ reader = gcnew BinaryReader(stream);
+		List<CaptureReplayRecord^>^ records = gcnew List<CaptureReplayRecord^>();
+		List<Byte>^ resolutions = gcnew List<Byte>();
+		bool first = true;
+
+		while (true)
+		{
+			cli::array<Byte>^ header = reader->ReadBytes(8);
+
+			if (header->Length == 0)
+				break;
+
+			if (header->Length < 8)
+				throw gcnew InvalidDataException("Truncated pcapng block.");
+
+			unsigned int type = BitConverter::ToUInt32(header, 0);
+			int length = BitConverter::ToInt32(header, 4);
+
+			if (first && type != SectionHeaderBlock)
+				throw gcnew InvalidDataException("Stream is not a pcapng capture.");
+
+			if (length < 12 || (length & 3) != 0)
+				throw gcnew InvalidDataException("Invalid pcapng block length.");
+
+			cli::array<Byte>^ body = reader->ReadBytes(length - 8);
+
+			if (body->Length != length - 8)
+				throw gcnew InvalidDataException("Truncated pcapng block.");
+
+			first = false;
+
+			// Options end before the trailing block length
+			int end = body->Length - 4;
+
+			if (type == SectionHeaderBlock)
+			{
+				if (BitConverter::ToUInt32(body, 0) != ByteOrderMagic)
+					throw gcnew InvalidDataException("Only little endian pcapng captures are supported.");
+
+				resolutions->Clear();
+			}
+			else if (type == InterfaceDescriptionBlock)
+			{
+				Byte resolution = 6;
+
+				for (int offset = 8; offset + 4 <= end; )
+				{
+					int code = BitConverter::ToUInt16(body, offset);
+					int size = BitConverter::ToUInt16(body, offset + 2);
+
+					if (code == 0)
+						break;
+
+					if (code == 9 && size >= 1)
+						resolution = body[offset + 4];
+
+					offset += 4 + Pad4(size);
+				}
+
+				resolutions->Add(resolution);
+			}
+			else if (type == EnhancedPacketBlock)
+			{
+				int interfaceId = (int)BitConverter::ToUInt32(body, 0);
+
+				if (interfaceId != connection || interfaceId >= resolutions->Count)
+					continue;
+
+				unsigned __int64 timestamp = ((unsigned __int64)BitConverter::ToUInt32(body, 4) << 32) | BitConverter::ToUInt32(body, 8);
+				int capturedLength = (int)BitConverter::ToUInt32(body, 12);
+				int originalLength = (int)BitConverter::ToUInt32(body, 16);
+
+				if (20 + capturedLength > end || capturedLength < 1)
+					continue;
+
+				int version = body[20] >> 4;
+				int ipLength = version == 4 ? (body[20] & 0x0F) * 4 : version == 6 ? 40 : -1;
+				int udtOffset = ipLength + 8;
+
+				if (ipLength < 0 || udtOffset > capturedLength)
+					continue;
+
+				CaptureReplayRecord^ record = gcnew CaptureReplayRecord();
+				record->Time = ToTicks(timestamp, resolutions[interfaceId]);
+				record->Data = gcnew cli::array<Byte>(capturedLength - udtOffset);
+				record->OriginalLength = originalLength - udtOffset;
+				Buffer::BlockCopy(body, 20 + udtOffset, record->Data, 0, record->Data->Length);
+
+				for (int offset = 20 + Pad4(capturedLength); offset + 4 <= end; )
+				{
+					int code = BitConverter::ToUInt16(body, offset);
+					int size = BitConverter::ToUInt16(body, offset + 2);
+
+					if (code == 0)
+						break;
+
+					if (code == 1)
+						record->Comment = Encoding::UTF8->GetString(body, offset + 4, size);
+					else if (code == 2 && size == 4)
+						record->Outbound = (BitConverter::ToUInt32(body, offset + 4) & 3) == 2;
+
+					offset += 4 + Pad4(size);
+				}
+
+				records->Add(record);
+			}
+		}
+
+		return records;
+	}
+
+	/// <summary>
+	/// Read the controller state PacketCapture writes in the comment.
+	/// </summary>
+	void ParseComment(String^ comment, double& windowSize, double& packetSendPeriod)
+	{
+		windowSize = 0;
+		packetSendPeriod = 0;
+
+		if (comment == nullptr)
+			return;
+
+		for each (String^ field in comment->Split(' '))
+		{
+			if (field->StartsWith("cwnd=", StringComparison::Ordinal))
+				Double::TryParse(field->Substring(5), NumberStyles::Float, CultureInfo::InvariantCulture, windowSize);
+			else if (field->StartsWith("period=", StringComparison::Ordinal))
+				Double::TryParse(field->Substring(7), NumberStyles::Float, CultureInfo::InvariantCulture, packetSendPeriod);
+		}
+	}
+}
+
+IList<ReplaySample>^ CaptureReplay::Run(String^ path, ICongestionControlFactory^ factory)
+{
+	if (path == nullptr)
+		throw gcnew ArgumentNullException("path");
+
+	if (factory == nullptr)
+		throw gcnew ArgumentNullException("factory");
+
+	FileStream^ stream = gcnew FileStream(path, FileMode::Open, FileAccess::Read, FileShare::ReadWrite);
+
+	try
+	{
+		return Run(stream, 0, factory);
+	}
+	finally
+	{
+		stream->Close();
+	}
+}
+
+IList<ReplaySample>^ CaptureReplay::Run(Stream^ stream, int connection, ICongestionControlFactory^ factory)
+{
+	if (stream == nullptr)
+		throw gcnew ArgumentNullException("stream");
+
+	if (connection < 0)
+		throw gcnew ArgumentOutOfRangeException("connection", connection, "Value must be greater than or equal to 0.");
+
+	if (factory == nullptr)
+		throw gcnew ArgumentNullException("factory");
+
+	List<CaptureReplayRecord^>^ records = ReadConnection(stream, connection);
+	List<ReplaySample>^ samples = gcnew List<ReplaySample>();
+
+	// Initial state as CUDT sets it before CCC::init
+	int maxDataLength = 0;
+	int firstSent = -1;
+
+	for each (CaptureReplayRecord^ record in records)
+	{
+		if (record->Data->Length >= 16 && (record->Data[0] & 0x80) == 0)
+		{
+			maxDataLength = Math::Max(maxDataLength, record->OriginalLength);
+
+			if (record->Outbound && firstSent < 0)
+				firstSent = (int)ReadBigEndian32(record->Data, 0);
+		}
+	}
+
+	CCC* cc = CCCWrapperFactory::CreateOffline(factory);
+
+	try
+	{
+		CCCState::MaxPacketSize(cc) = maxDataLength > 0 ? maxDataLength + 28 : 1500;
+		CCCState::MaxWindowSize(cc) = FlowWindowSize;
+		CCCState::SendCurrentSequence(cc) = firstSent > 0 ? firstSent - 1 : 0;
+		CCCState::ReceiveRate(cc) = 16;
+		CCCState::RoundtripTime(cc) = 100000;
+		CCCState::Bandwidth(cc) = 1;
+		cc->init();
+
+		__int64 start = records->Count > 0 ? records[0]->Time : 0;
+		std::vector<int32_t> losses;
+		std::vector<char> payload;
+
+		for each (CaptureReplayRecord^ record in records)
+		{
+			cli::array<Byte>^ data = record->Data;
+			ReplayEvent replayed = ReplayEvent::Ack;
+
+			if (record->Comment != nullptr && record->Comment->StartsWith("timeout", StringComparison::Ordinal))
+			{
+				cc->onTimeout();
+				replayed = ReplayEvent::Timeout;
+			}
+			else if (data->Length < 16)
+			{
+				continue;
+			}
+			else if ((data[0] & 0x80) == 0)
+			{
+				int payloadLength = Math::Max(0, record->OriginalLength - 16);
+				payload.assign(payloadLength, 0);
+
+				for (int i = 16; i < data->Length && i - 16 < payloadLength; ++i)
+					payload[i - 16] = (char)data[i];
+
+				CPacket packet;
+				packet.m_iSeqNo = (int32_t)ReadBigEndian32(data, 0);
+				packet.m_iMsgNo = (int32_t)ReadBigEndian32(data, 4);
+				packet.m_iTimeStamp = (int32_t)ReadBigEndian32(data, 8);
+				packet.m_iID = (int32_t)ReadBigEndian32(data, 12);
+
+				if (payloadLength > 0)
+					packet.m_pcData = &payload[0];
+
+				packet.setLength(payloadLength);
+
+				if (record->Outbound)
+				{
+					if (packet.m_iSeqNo > CCCState::SendCurrentSequence(cc))
+						CCCState::SendCurrentSequence(cc) = packet.m_iSeqNo;
+
+					cc->onPktSent(&packet);
+				}
+				else
+				{
+					cc->onPktReceived(&packet);
+				}
+
+				packet.m_pcData = NULL;
+				continue;
+			}
+			else
+			{
+				int controlType = (int)(ReadBigEndian32(data, 0) >> 16) & 0x7FFF;
+
+				if (controlType == 2 && data->Length >= 40)
+				{
+					CCCState::RoundtripTime(cc) = (int)ReadBigEndian32(data, 20);
+					CCCState::ReceiveRate(cc) = (int)ReadBigEndian32(data, 32);
+					CCCState::Bandwidth(cc) = (int)ReadBigEndian32(data, 36);
+					cc->onACK((int32_t)ReadBigEndian32(data, 16));
+					replayed = ReplayEvent::Ack;
+				}
+				else if (controlType == 3 && data->Length >= 20)
+				{
+					losses.clear();
+
+					for (int offset = 16; offset + 4 <= data->Length; offset += 4)
+						losses.push_back((int32_t)ReadBigEndian32(data, offset));
+
+					cc->onLoss(&losses[0], (int)losses.size());
+					replayed = ReplayEvent::Loss;
+				}
+				else
+				{
+					continue;
+				}
+			}
+
+			double recordedWindow, recordedPeriod;
+			ParseComment(record->Comment, recordedWindow, recordedPeriod);
+
+			ReplaySample sample;
+			sample.Time = TimeSpan(record->Time - start);
+			sample.Event = replayed;
+			sample.WindowSize = CCCState::WindowSize(cc);
+			sample.PacketSendPeriod = TimeSpan((__int64)(CCCState::PacketSendPeriod(cc) * 10));
+			sample.RecordedWindowSize = recordedWindow;
+			sample.RecordedPacketSendPeriod = TimeSpan((__int64)(recordedPeriod * 10));
+			samples->Add(sample);
+		}
+	}
+	finally
+	{
+		cc->close();
+		delete cc;
+	}
+
+	return samples->AsReadOnly();
+}
@@ -0,0 +1,79 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+#include "ReplaySample.h"
+
+namespace Udt
+{
+	interface class ICongestionControlFactory;
+
+	/// <summary>
+	/// Feeds a <see cref="PacketCapture"/> file back into a congestion
+	/// control for offline analysis.
+	/// </summary>
+	/// <remarks>
+	/// Sent and received data packets, ACKs with the round trip time,
+	/// receive rate and bandwidth the socket reported, NAKs and timeouts
+	/// are delivered in capture order, with the state CUDT would have set.
+	/// Running the controller that was captured reproduces the recorded
+	/// window; running a modified one shows where it diverges. Loss lists
+	/// longer than the capture record are replayed truncated.
+	/// </remarks>
+	public ref class CaptureReplay abstract sealed
+	{
+	public:
+
+		/// <summary>
+		/// Replay the first connection of a capture file.
+		/// </summary>
+		/// <param name="path">Capture written by <see cref="PacketCapture"/>.</param>
+		/// <param name="factory">Creates the congestion control to replay into; native plug-ins and groups are replayed too.</param>
+		/// <returns>State after each ACK, NAK and timeout.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="path"/> or <paramref name="factory"/> is null.</exception>
+		/// <exception cref="System::IO::InvalidDataException">If the file is not a pcapng capture.</exception>
+		static System::Collections::Generic::IList<ReplaySample>^ Run(System::String^ path, ICongestionControlFactory^ factory);
+
+		/// <summary>
+		/// Replay one connection of a capture.
+		/// </summary>
+		/// <param name="stream">Capture written by <see cref="PacketCapture"/>.</param>
+		/// <param name="connection">Index of the connection (pcapng interface) to replay.</param>
+		/// <param name="factory">Creates the congestion control to replay into; native plug-ins and groups are replayed too.</param>
+		/// <returns>State after each ACK, NAK and timeout.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="stream"/> or <paramref name="factory"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="connection"/> is less than 0.</exception>
+		/// <exception cref="System::IO::InvalidDataException">If the stream is not a pcapng capture.</exception>
+		static System::Collections::Generic::IList<ReplaySample>^ Run(System::IO::Stream^ stream, int connection, ICongestionControlFactory^ factory);
+	};
+}
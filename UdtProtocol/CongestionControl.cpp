@@ -35,12 +35,19 @@
 #include "Packet.h"
 
 #include "CCCWrapper.h"
+#include "AsyncControlQueue.h"
+#include "AsyncCongestionControl.h"
 
 using namespace Udt;
 using namespace System;
 
 CongestionControl::CongestionControl(void)
-	: _cccWrapper(NULL), _isDisposed(false)
+	: _cccWrapper(NULL), _asyncQueue(NULL), _isDisposed(false), _isAsynchronous(false)
+{
+}
+
+CongestionControl::CongestionControl(bool asynchronous)
+	: _cccWrapper(NULL), _asyncQueue(NULL), _isDisposed(false), _isAsynchronous(asynchronous)
 {
 }
 
@@ -52,71 +59,251 @@ void CongestionControl::AssertNotDisposed()
 void CongestionControl::SetAckTimer(System::TimeSpan value)
 {
 	AssertNotDisposed();
-	_cccWrapper->setACKTimer(value);
+
+	AsyncControlQueue* queue = _asyncQueue;
+
+	if (queue == NULL)
+	{
+		_cccWrapper->setACKTimer(value);
+		return;
+	}
+
+	if (value.CompareTo(TimeSpan::Zero) < 0)
+		throw gcnew System::ArgumentOutOfRangeException("value", value, "Value must be greater than or equal to 0.");
+
+	AsyncCC* cc = queue->LockOwner();
+
+	try
+	{
+		if (cc != NULL)
+			cc->SetAckTimer((int)value.TotalMilliseconds);
+	}
+	finally
+	{
+		queue->UnlockOwner();
+	}
 }
 
 void CongestionControl::SetAckInterval(int value)
 {
 	AssertNotDisposed();
-	_cccWrapper->setACKInterval(value);
+
+	AsyncControlQueue* queue = _asyncQueue;
+
+	if (queue == NULL)
+	{
+		_cccWrapper->setACKInterval(value);
+		return;
+	}
+
+	if (value < 0)
+		throw gcnew System::ArgumentOutOfRangeException("value", value, "Value must be greater than or equal to 0.");
+
+	AsyncCC* cc = queue->LockOwner();
+
+	try
+	{
+		if (cc != NULL)
+			cc->SetAckInterval(value);
+	}
+	finally
+	{
+		queue->UnlockOwner();
+	}
 }
 
 void CongestionControl::SetReadTimeout(System::TimeSpan value)
 {
 	AssertNotDisposed();
-	_cccWrapper->setRTO(value);
+
+	AsyncControlQueue* queue = _asyncQueue;
+
+	if (queue == NULL)
+	{
+		_cccWrapper->setRTO(value);
+		return;
+	}
+
+	if (value.CompareTo(TimeSpan::Zero) < 0)
+		throw gcnew System::ArgumentOutOfRangeException("value", value, "Value must be greater than or equal to 0.");
+
+	AsyncCC* cc = queue->LockOwner();
+
+	try
+	{
+		if (cc != NULL)
+			cc->SetRto((int)(value.Ticks / 10));
+	}
+	finally
+	{
+		queue->UnlockOwner();
+	}
 }
 
 TraceInfo^ CongestionControl::PerformanceInfo::get(void)
 {
 	AssertNotDisposed();
-	return _cccWrapper->getPerfInfo();
+
+	AsyncControlQueue* queue = _asyncQueue;
+
+	if (queue == NULL)
+		return _cccWrapper->getPerfInfo();
+
+	AsyncCC* cc = queue->LockOwner();
+
+	try
+	{
+		if (cc == NULL)
+			throw gcnew ObjectDisposedException(this->ToString());
+
+		return gcnew TraceInfo(*cc->PerformanceInfo());
+	}
+	finally
+	{
+		queue->UnlockOwner();
+	}
 }
 
 void CongestionControl::PacketSendPeriod::set(System::TimeSpan value)
 {
 	AssertNotDisposed();
-	_cccWrapper->setPacketSendPeriod(value);
+
+	AsyncControlQueue* queue = _asyncQueue;
+
+	if (queue == NULL)
+	{
+		_cccWrapper->setPacketSendPeriod(value);
+		return;
+	}
+
+	if (value.CompareTo(TimeSpan::Zero) < 0)
+		throw gcnew System::ArgumentOutOfRangeException("value", value, "Value must be greater than or equal to 0.");
+
+	queue->PublishPacketSendPeriod(value.Ticks / 10.0);
 }
 
 System::TimeSpan CongestionControl::PacketSendPeriod::get(void)
 {
 	AssertNotDisposed();
-	return _cccWrapper->getPacketSendPeriod();
+
+	AsyncControlQueue* queue = _asyncQueue;
+
+	if (queue == NULL)
+		return _cccWrapper->getPacketSendPeriod();
+
+	return System::TimeSpan((__int64)(queue->PacketSendPeriod() * 10));
 }
 
 void CongestionControl::WindowSize::set(int value)
 {
 	AssertNotDisposed();
-	_cccWrapper->setWindowSize(value);
+
+	AsyncControlQueue* queue = _asyncQueue;
+
+	if (queue == NULL)
+	{
+		_cccWrapper->setWindowSize(value);
+		return;
+	}
+
+	if (value < 0)
+		throw gcnew System::ArgumentOutOfRangeException("value", value, "Value must be greater than or equal to 0.");
+
+	queue->PublishWindowSize(value);
 }
 
 int CongestionControl::WindowSize::get(void)
 {
 	AssertNotDisposed();
-	return _cccWrapper->getWindowSize();
+
+	AsyncControlQueue* queue = _asyncQueue;
+
+	if (queue == NULL)
+		return _cccWrapper->getWindowSize();
+
+	return (int)queue->WindowSize();
 }
 
 void CongestionControl::MaxPacketSize::set(int value)
 {
 	AssertNotDisposed();
-	_cccWrapper->setMaxPacketSize(value);
+
+	AsyncControlQueue* queue = _asyncQueue;
+
+	if (queue == NULL)
+	{
+		_cccWrapper->setMaxPacketSize(value);
+		return;
+	}
+
+	if (value < 0)
+		throw gcnew System::ArgumentOutOfRangeException("value", value, "Value must be greater than or equal to 0.");
+
+	AsyncCC* cc = queue->LockOwner();
+
+	try
+	{
+		if (cc != NULL)
+			cc->SetMaxPacketSize(value);
+	}
+	finally
+	{
+		queue->UnlockOwner();
+	}
+
+	queue->PublishMaxPacketSize(value);
 }
 
 int CongestionControl::MaxPacketSize::get(void)
 {
 	AssertNotDisposed();
-	return _cccWrapper->getMaxPacketSize();
+
+	AsyncControlQueue* queue = _asyncQueue;
+
+	if (queue == NULL)
+		return _cccWrapper->getMaxPacketSize();
+
+	return queue->MaxPacketSize();
 }
 
 void CongestionControl::RoundtripTime::set(System::TimeSpan value)
 {
 	AssertNotDisposed();
-	_cccWrapper->setRoundTripTime(value);
+
+	AsyncControlQueue* queue = _asyncQueue;
+
+	if (queue == NULL)
+	{
+		_cccWrapper->setRoundTripTime(value);
+		return;
+	}
+
+	if (value.CompareTo(TimeSpan::Zero) < 0)
+		throw gcnew System::ArgumentOutOfRangeException("value", value, "Value must be greater than or equal to 0.");
+
+	AsyncCC* cc = queue->LockOwner();
+
+	try
+	{
+		if (cc != NULL)
+			cc->SetRoundTripTime((int)(value.Ticks / 10));
+	}
+	finally
+	{
+		queue->UnlockOwner();
+	}
+
+	queue->PublishRoundTripTime((int)(value.Ticks / 10));
 }
 
 System::TimeSpan CongestionControl::RoundtripTime::get(void)
 {
 	AssertNotDisposed();
-	return _cccWrapper->getRoundTripTime();
+
+	AsyncControlQueue* queue = _asyncQueue;
+
+	if (queue == NULL)
+		return _cccWrapper->getRoundTripTime();
+
+	return System::TimeSpan((__int64)queue->RoundTripTime() * 10);
 }
@@ -33,34 +33,111 @@
 #pragma once
 
 #include "TraceInfo.h"
+#include "AckInfo.h"
+#include "DelayInfo.h"
 
 namespace Udt
 {
 	ref class Packet;
 	class CCCWrapper;
+	class AsyncControlQueue;
 
 	public ref class CongestionControl abstract
 	{
 	internal:
 		CCCWrapper* _cccWrapper;
+		AsyncControlQueue* _asyncQueue;
 		bool _isDisposed;
+		bool _isAsynchronous;
 
 	protected:
 		CongestionControl(void);
 
+		/// <summary>
+		/// Initialize a new instance, optionally running on its own thread.
+		/// </summary>
+		/// <remarks>
+		/// <para>
+		/// An asynchronous controller never runs on the UDT send and receive
+		/// threads, so garbage collection or JIT pauses in it do not stall
+		/// the connection. UDT drives a native congestion control that
+		/// queues ACKs, losses and timeouts without entering the CLR, and
+		/// applies the last <see cref="WindowSize"/> and
+		/// <see cref="PacketSendPeriod"/> set here after each packet sent
+		/// and each event. <see cref="Initialize"/>, the events and
+		/// <see cref="Close"/> are delivered in order on a dedicated
+		/// thread, after which the controller is disposed.
+		/// </para>
+		/// <para>
+		/// <see cref="OnPacketSent"/>, <see cref="OnPacketReceived"/>,
+		/// <see cref="OnDelay"/> and <see cref="ProcessCustomMessage"/> are
+		/// not called. Loss lists longer than 64 entries are truncated to at
+		/// most 64 entries without splitting a range, and events are
+		/// dropped if the controller falls 1024 events behind.
+		/// Simulations and capture replays run asynchronous controllers
+		/// synchronously.
+		/// </para>
+		/// </remarks>
+		/// <param name="asynchronous">True to deliver events on a separate thread.</param>
+		CongestionControl(bool asynchronous);
+
 	public:
 		virtual void Initialize() { }
 		virtual void Close() { }
 
 		property bool IsDisposed { bool get(void) { return _isDisposed; } }
 
+		/// <summary>
+		/// Get true if events are delivered on a separate thread.
+		/// </summary>
+		property bool IsAsynchronous { bool get(void) { return _isAsynchronous; } }
+
 		[System::Diagnostics::CodeAnalysis::SuppressMessageAttribute(
 			"Microsoft.Naming",
 			"CA1704:IdentifiersShouldBeSpelledCorrectly",
 			Justification = "ACK is the accepted abbreviation for acknowledgement in this context.")]
 		virtual void OnAck(int ack) { }
+
+		/// <summary>
+		/// Called on each ACK with the feedback the receiver reported.
+		/// </summary>
+		/// <remarks>
+		/// The default implementation calls <see cref="OnAck(int)"/>.
+		/// Override this overload instead when the algorithm needs the round
+		/// trip time, receive rate or bandwidth estimate; they are passed
+		/// without allocating.
+		/// </remarks>
+		/// <param name="ack">ACK sequence number and receiver feedback.</param>
+		[System::Diagnostics::CodeAnalysis::SuppressMessageAttribute(
+			"Microsoft.Naming",
+			"CA1704:IdentifiersShouldBeSpelledCorrectly",
+			Justification = "ACK is the accepted abbreviation for acknowledgement in this context.")]
+		virtual void OnAck(AckInfo ack) { OnAck(ack.AcknowledgedPacket); }
 		virtual void OnLoss(System::Collections::Generic::IList<int>^ lossList) { }
 		virtual void OnTimeout() { }
+		/// <summary>
+		/// Called with the one-way delay of data packets received by this
+		/// side of the connection, in batches.
+		/// </summary>
+		/// <remarks>
+		/// <para>
+		/// A batch is delivered when it holds 256 samples, or when a packet
+		/// arrives 10 milliseconds or more after the batch started. The
+		/// samples are measured where the data is received; the sending
+		/// side of a one-way transfer gets none, so a sender-side delay
+		/// controller such as LEDBAT has to get them from the receiver, for
+		/// example in custom control messages.
+		/// </para>
+		/// <para>
+		/// Delay tracking only runs for classes that override this method.
+		/// <paramref name="samples"/> holds the delay of each packet in
+		/// microseconds, in arrival order, and is only valid for the
+		/// duration of the call.
+		/// </para>
+		/// </remarks>
+		/// <param name="delay">Summary of the batch.</param>
+		/// <param name="samples">One-way delay of each packet in the batch.</param>
+		virtual void OnDelay(DelayInfo delay, System::Collections::Generic::IList<int>^ samples) { }
 		virtual void OnPacketSent(Packet^ packet) { }
 		virtual void OnPacketReceived(Packet^ packet) { }
 		virtual void ProcessCustomMessage(Packet^ packet) { }
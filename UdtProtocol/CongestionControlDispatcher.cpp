@@ -0,0 +1,118 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "CongestionControlDispatcher.h"
+
+#include "CongestionControl.h"
+#include "NativeIntArray.h"
+
+#include <udt.h>
+
+#include "AsyncControlQueue.h"
+
+using namespace Udt;
+using namespace System;
+using namespace System::Threading;
+
+CongestionControlDispatcher::CongestionControlDispatcher(CongestionControl^ controller, AsyncControlQueue* queue)
+	: _controller(controller), _queue(queue)
+{
+}
+
+void CongestionControlDispatcher::Start(void)
+{
+	_thread = gcnew Thread(gcnew ThreadStart(this, &CongestionControlDispatcher::Run));
+	_thread->IsBackground = true;
+	_thread->Name = "UDT congestion control";
+	_thread->Start();
+}
+
+void CongestionControlDispatcher::Run(void)
+{
+	AsyncControlEvent e;
+
+	try
+	{
+		while (true)
+		{
+			bool stopping = _queue->IsClosed();
+
+			while (_queue->TryDequeue(e))
+			{
+				switch (e.kind)
+				{
+				case AsyncInit:
+					_controller->Initialize();
+					break;
+
+				case AsyncAck:
+					_controller->OnAck(AckInfo(e.ack, e.rtt, e.rttVariance, e.receiveRate, e.bandwidth));
+					break;
+
+				case AsyncLoss:
+					{
+						NativeIntArray^ list = gcnew NativeIntArray(e.losses, e.lossCount);
+
+						try
+						{
+							_controller->OnLoss(list);
+						}
+						finally
+						{
+							delete list;
+						}
+					}
+					break;
+
+				case AsyncTimeout:
+					_controller->OnTimeout();
+					break;
+				}
+			}
+
+			if (stopping)
+				break;
+
+			WaitForSingleObject(_queue->Signal(), 100);
+		}
+
+		_controller->Close();
+	}
+	finally
+	{
+		_controller->_asyncQueue = NULL;
+		_controller->_isDisposed = true;
+		_queue->Release();
+		_queue = NULL;
+	}
+}
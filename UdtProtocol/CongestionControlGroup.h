@@ -0,0 +1,118 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+#include "ICongestionControlFactory.h"
+
+namespace Udt
+{
+	class CoupledGroupState;
+
+	/// <summary>
+	/// Couples the congestion control of sockets that share a bottleneck,
+	/// such as parallel connections to the same peer.
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Assign one group to <see cref="Socket::CongestionControl"/> of every
+	/// socket that should share it, before they connect. Sockets accepted
+	/// by a listener using the group join it too.
+	/// </para>
+	/// <para>
+	/// Each member runs slow start on its own, then contributes its
+	/// measured rate to one aggregate. The aggregate follows UDT's native
+	/// algorithm as if it were a single connection: one increase per
+	/// rate control interval and one decrease per round trip, however many
+	/// members report the ACK or loss. Each member sends an equal share of
+	/// the aggregate, so adding sockets adds parallelism without adding
+	/// aggressiveness. The whole controller is native; no member enters
+	/// the CLR.
+	/// </para>
+	/// </remarks>
+	public ref class CongestionControlGroup : public ICongestionControlFactory, public System::IDisposable
+	{
+	private:
+		CoupledGroupState* _state;
+		bool _isDisposed;
+
+	internal:
+		property CoupledGroupState* State { CoupledGroupState* get(void); }
+
+	public:
+
+		/// <summary>
+		/// Initialize a new empty group.
+		/// </summary>
+		CongestionControlGroup(void);
+
+		virtual ~CongestionControlGroup(void);
+		!CongestionControlGroup(void);
+
+		/// <summary>
+		/// Always throws; group members have no managed object.
+		/// </summary>
+		/// <exception cref="System::NotSupportedException">Always.</exception>
+		virtual CongestionControl^ CreateCongestionControl(void);
+
+		/// <summary>
+		/// Get the number of connections currently in the group.
+		/// </summary>
+		/// <exception cref="System::ObjectDisposedException">If the group is disposed.</exception>
+		property int MemberCount
+		{
+			int get(void);
+		}
+
+		/// <summary>
+		/// Get the aggregate sending rate of the members past slow start,
+		/// in packets per second.
+		/// </summary>
+		/// <exception cref="System::ObjectDisposedException">If the group is disposed.</exception>
+		property double SendRate
+		{
+			double get(void);
+		}
+
+		/// <summary>
+		/// Get true if the group has been disposed.
+		/// </summary>
+		/// <remarks>
+		/// Connections already in the group keep sharing it after it is
+		/// disposed.
+		/// </remarks>
+		property bool IsDisposed
+		{
+			bool get(void) { return _isDisposed; }
+		}
+	};
+}
@@ -0,0 +1,652 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "CongestionControlSimulator.h"
+
+#include "ICongestionControlFactory.h"
+#include "CCCWrapperFactory.h"
+#include "CCCState.h"
+#include "SimulationResult.h"
+
+#include <udt.h>
+#include <ccc.h>
+#include <packet.h>
+
+#include <deque>
+#include <queue>
+#include <set>
+#include <vector>
+
+using namespace Udt;
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace
+{
+	// UDT SYN interval, the period of ACKs and expiration checks
+	const __int64 SynInterval = 10000;
+
+	// Lower bound of the UDT expiration period
+	const __int64 MinExpInterval = 300000;
+
+	// IP, UDP and UDT data packet headers
+	const int PacketHeaderSize = 44;
+
+	// UDT default flow window (UDT_FC)
+	const int FlowWindowSize = 25600;
+
+	enum SimEventType
+	{
+		SendTimer,
+		DataArrival,
+		AckArrival,
+		NakArrival,
+		AckTimer,
+		ExpTimer,
+		SampleTimer
+	};
+
+	struct SimEvent
+	{
+		__int64 time;
+		__int64 order;
+		SimEventType type;
+		int32_t sequence;
+		__int64 forwardDelay;
+		int receiveRate;
+		std::vector<int32_t> losses;
+	};
+
+	struct SimEventLater
+	{
+		bool operator()(const SimEvent& x, const SimEvent& y) const
+		{
+			return x.time != y.time ? x.time > y.time : x.order > y.order;
+		}
+	};
+
+	struct SimSample
+	{
+		__int64 time;
+		double windowSize;
+		double packetSendPeriod;
+		int flightSize;
+		int queueLength;
+		__int64 roundtripTime;
+		__int64 delivered;
+	};
+
+	/// <summary>
+	/// xorshift64*, the same sequence for a seed on every runtime.
+	/// </summary>
+	class SimRandom
+	{
+	private:
+		unsigned __int64 _state;
+
+	public:
+		SimRandom(int seed)
+			: _state(((unsigned __int64)(unsigned int)seed + 1) * 0x9E3779B97F4A7C15ULL)
+		{
+		}
+
+		double NextDouble()
+		{
+			_state ^= _state >> 12;
+			_state ^= _state << 25;
+			_state ^= _state >> 27;
+			return ((_state * 0x2545F4914F6CDD1DULL) >> 11) * (1.0 / 9007199254740992.0);
+		}
+	};
+
+	class Simulation
+	{
+	private:
+		CCC* _cc;
+		double _serialization;
+		__int64 _delay;
+		size_t _queueLimit;
+		double _lossRate;
+		int _mss;
+		int _capacity;
+		SimRandom _random;
+
+		std::priority_queue<SimEvent, std::vector<SimEvent>, SimEventLater> _events;
+		__int64 _now;
+		__int64 _order;
+
+		// Sender
+		int32_t _nextSequence;
+		int32_t _lastAck;
+		std::set<int32_t> _lossList;
+		double _nextSendTime;
+		bool _sendScheduled;
+		__int64 _lastProgress;
+		int _expCount;
+		__int64 _rtt;
+		__int64 _rttVar;
+
+		// Link
+		double _linkFree;
+		std::deque<double> _departures;
+
+		// Receiver
+		int32_t _receiveNext;
+		int32_t _receiveLargest;
+		std::set<int32_t> _outOfOrder;
+		int32_t _lastAckSent;
+		__int64 _lastForwardDelay;
+		__int64 _lastNak;
+		int _arrivals;
+		int _arrivalHistory[16];
+		int _arrivalSlot;
+
+		void Schedule(SimEvent& e)
+		{
+			e.order = _order++;
+			_events.push(e);
+		}
+
+		void ScheduleTimer(SimEventType type, __int64 time)
+		{
+			SimEvent e;
+			e.time = time;
+			e.type = type;
+			e.sequence = 0;
+			e.forwardDelay = 0;
+			e.receiveRate = 0;
+			Schedule(e);
+		}
+
+		void ScheduleSend()
+		{
+			if (_sendScheduled)
+				return;
+
+			__int64 time = (__int64)_nextSendTime;
+			if (time < _nextSendTime) ++time;
+
+			ScheduleTimer(SendTimer, time > _now ? time : _now);
+			_sendScheduled = true;
+		}
+
+		int QueueLength()
+		{
+			while (!_departures.empty() && _departures.front() <= _now)
+				_departures.pop_front();
+
+			return (int)_departures.size();
+		}
+
+		void OnSendTimer()
+		{
+			_sendScheduled = false;
+
+			int32_t sequence;
+			bool retransmit = false;
+
+			if (!_lossList.empty())
+			{
+				sequence = *_lossList.begin();
+				_lossList.erase(_lossList.begin());
+				retransmit = true;
+			}
+			else
+			{
+				double window = CCCState::WindowSize(_cc);
+				double maxWindow = CCCState::MaxWindowSize(_cc);
+				int cwnd = (int)(window < maxWindow ? window : maxWindow);
+
+				// Same test as CUDT::packData
+				if (_nextSequence - _lastAck + 1 > cwnd)
+					return;
+
+				sequence = _nextSequence++;
+				CCCState::SendCurrentSequence(_cc) = sequence;
+			}
+
+			CPacket packet;
+			packet.m_iSeqNo = sequence;
+			packet.m_iMsgNo = (int32_t)0xC0000000 | (sequence & 0x1FFFFFFF);
+			packet.m_iTimeStamp = (int32_t)_now;
+			packet.m_iID = 0;
+			_cc->onPktSent(&packet);
+
+			++PacketsSent;
+			if (retransmit) ++PacketsRetransmitted;
+
+			Transmit(sequence);
+
+			double period = CCCState::PacketSendPeriod(_cc);
+			_nextSendTime = (_nextSendTime > _now ? _nextSendTime : _now) + (period > 0 ? period : 0);
+			ScheduleSend();
+		}
+
+		void Transmit(int32_t sequence)
+		{
+			if (_lossRate > 0 && _random.NextDouble() < _lossRate)
+			{
+				++PacketsLost;
+				return;
+			}
+
+			if ((size_t)QueueLength() >= _queueLimit)
+			{
+				++PacketsDropped;
+				return;
+			}
+
+			_linkFree = (_linkFree > _now ? _linkFree : _now) + _serialization;
+			_departures.push_back(_linkFree);
+
+			SimEvent e;
+			e.time = (__int64)_linkFree + _delay;
+			e.type = DataArrival;
+			e.sequence = sequence;
+			e.forwardDelay = e.time - _now;
+			e.receiveRate = 0;
+			Schedule(e);
+		}
+
+		void OnDataArrival(const SimEvent& e)
+		{
+			++_arrivals;
+			_lastForwardDelay = e.forwardDelay;
+
+			int32_t sequence = e.sequence;
+
+			if (sequence < _receiveNext || _outOfOrder.count(sequence) != 0)
+				return;
+
+			if (sequence > _receiveLargest + 1)
+			{
+				std::vector<int32_t> losses;
+				AddLossRange(losses, _receiveLargest + 1, sequence - 1);
+				SendNak(losses);
+			}
+
+			if (sequence > _receiveLargest)
+				_receiveLargest = sequence;
+
+			if (sequence == _receiveNext)
+			{
+				++_receiveNext;
+
+				while (!_outOfOrder.empty() && *_outOfOrder.begin() == _receiveNext)
+				{
+					_outOfOrder.erase(_outOfOrder.begin());
+					++_receiveNext;
+				}
+			}
+			else
+			{
+				_outOfOrder.insert(sequence);
+			}
+		}
+
+		static void AddLossRange(std::vector<int32_t>& losses, int32_t first, int32_t last)
+		{
+			// UDT loss list encoding, a range starts with the high bit set
+			if (first == last)
+			{
+				losses.push_back(first);
+			}
+			else
+			{
+				losses.push_back(first | 0x80000000);
+				losses.push_back(last);
+			}
+		}
+
+		void SendNak(std::vector<int32_t>& losses)
+		{
+			SimEvent e;
+			e.time = _now + _delay;
+			e.type = NakArrival;
+			e.sequence = 0;
+			e.forwardDelay = 0;
+			e.receiveRate = 0;
+			e.losses.swap(losses);
+			Schedule(e);
+
+			_lastNak = _now;
+		}
+
+		void OnAckTimer()
+		{
+			ScheduleTimer(AckTimer, _now + SynInterval);
+
+			_arrivalHistory[_arrivalSlot] = _arrivals;
+			_arrivalSlot = (_arrivalSlot + 1) % 16;
+			_arrivals = 0;
+
+			if (_receiveNext != _lastAckSent)
+			{
+				int arrivals = 0;
+				for (int i = 0; i < 16; ++i)
+					arrivals += _arrivalHistory[i];
+
+				SimEvent e;
+				e.time = _now + _delay;
+				e.type = AckArrival;
+				e.sequence = _receiveNext;
+				e.forwardDelay = _lastForwardDelay;
+				e.receiveRate = (int)(arrivals * 1000000LL / (16 * SynInterval));
+				Schedule(e);
+
+				_lastAckSent = _receiveNext;
+			}
+
+			// Periodic NAK for holes whose report or retransmission was lost
+			if (_receiveNext <= _receiveLargest && _now - _lastNak >= _rtt + 4 * _rttVar)
+			{
+				std::vector<int32_t> losses;
+				int32_t first = _receiveNext;
+
+				for (std::set<int32_t>::const_iterator it = _outOfOrder.begin(); it != _outOfOrder.end(); ++it)
+				{
+					if (*it > first)
+						AddLossRange(losses, first, *it - 1);
+
+					first = *it + 1;
+				}
+
+				if (first <= _receiveLargest)
+					AddLossRange(losses, first, _receiveLargest);
+
+				SendNak(losses);
+			}
+		}
+
+		void OnAckArrival(const SimEvent& e)
+		{
+			if (e.sequence <= _lastAck)
+				return;
+
+			_lastAck = e.sequence;
+			_lossList.erase(_lossList.begin(), _lossList.lower_bound(_lastAck));
+
+			__int64 sample = e.forwardDelay + _delay;
+			__int64 error = sample > _rtt ? sample - _rtt : _rtt - sample;
+			_rttVar = (_rttVar * 3 + error) / 4;
+			_rtt = (_rtt * 7 + sample) / 8;
+
+			CCCState::RoundtripTime(_cc) = (int)_rtt;
+			CCCState::ReceiveRate(_cc) = e.receiveRate;
+			CCCState::Bandwidth(_cc) = _capacity;
+			_cc->onACK(_lastAck);
+
+			_lastProgress = _now;
+			_expCount = 1;
+			ScheduleSend();
+		}
+
+		void OnNakArrival(SimEvent& e)
+		{
+			if (e.losses.empty())
+				return;
+
+			for (size_t i = 0; i < e.losses.size(); ++i)
+			{
+				int32_t first = e.losses[i] & 0x7FFFFFFF;
+				int32_t last = (e.losses[i] & 0x80000000) != 0 ? e.losses[++i] : first;
+
+				for (int32_t sequence = first; sequence <= last; ++sequence)
+				{
+					if (sequence >= _lastAck && sequence < _nextSequence)
+						_lossList.insert(sequence);
+				}
+			}
+
+			_cc->onLoss(&e.losses[0], (int)e.losses.size());
+			ScheduleSend();
+		}
+
+		void OnExpTimer()
+		{
+			ScheduleTimer(ExpTimer, _now + SynInterval);
+
+			if (_nextSequence == _lastAck)
+			{
+				_lastProgress = _now;
+				return;
+			}
+
+			__int64 period = _expCount * (_rtt + 4 * _rttVar) + SynInterval;
+			if (period < MinExpInterval) period = MinExpInterval;
+
+			if (_now - _lastProgress < period)
+				return;
+
+			++Timeouts;
+			++_expCount;
+			_lastProgress = _now;
+
+			for (int32_t sequence = _lastAck; sequence < _nextSequence; ++sequence)
+				_lossList.insert(sequence);
+
+			_cc->onTimeout();
+			ScheduleSend();
+		}
+
+		void OnSampleTimer(__int64 interval)
+		{
+			ScheduleTimer(SampleTimer, _now + interval);
+
+			SimSample sample;
+			sample.time = _now;
+			sample.windowSize = CCCState::WindowSize(_cc);
+			sample.packetSendPeriod = CCCState::PacketSendPeriod(_cc);
+			sample.flightSize = _nextSequence - _lastAck;
+			sample.queueLength = QueueLength();
+			sample.roundtripTime = _rtt;
+			sample.delivered = _receiveNext - 1;
+			Samples.push_back(sample);
+		}
+
+	public:
+		__int64 PacketsSent;
+		__int64 PacketsRetransmitted;
+		__int64 PacketsDropped;
+		__int64 PacketsLost;
+		int Timeouts;
+		std::vector<SimSample> Samples;
+
+		Simulation(CCC* cc, __int64 bandwidth, __int64 delay, int queueLimit, double lossRate, int mss, int seed)
+			: _cc(cc), _delay(delay), _queueLimit(queueLimit), _lossRate(lossRate), _mss(mss), _random(seed),
+			_now(0), _order(0),
+			_nextSequence(1), _lastAck(1), _nextSendTime(0), _sendScheduled(false), _lastProgress(0), _expCount(1),
+			_rtt(SynInterval * 10), _rttVar(SynInterval * 5),
+			_linkFree(0),
+			_receiveNext(1), _receiveLargest(0), _lastAckSent(1), _lastForwardDelay(0), _lastNak(0), _arrivals(0), _arrivalSlot(0),
+			PacketsSent(0), PacketsRetransmitted(0), PacketsDropped(0), PacketsLost(0), Timeouts(0)
+		{
+			_serialization = mss * 8 * 1000000.0 / bandwidth;
+			_capacity = (int)(bandwidth / (mss * 8));
+
+			for (int i = 0; i < 16; ++i)
+				_arrivalHistory[i] = 0;
+		}
+
+		/// <summary>
+		/// Packets delivered in order so far.
+		/// </summary>
+		__int64 Delivered() const { return _receiveNext - 1; }
+
+		void Run(__int64 duration, __int64 sampleInterval)
+		{
+			// Initial state set by CUDT before CCC::init
+			CCCState::MaxPacketSize(_cc) = _mss;
+			CCCState::MaxWindowSize(_cc) = FlowWindowSize;
+			CCCState::SendCurrentSequence(_cc) = _nextSequence - 1;
+			CCCState::ReceiveRate(_cc) = 16;
+			CCCState::RoundtripTime(_cc) = (int)_rtt;
+			CCCState::Bandwidth(_cc) = 1;
+			_cc->init();
+
+			ScheduleTimer(SampleTimer, 0);
+			ScheduleTimer(SendTimer, 0);
+			ScheduleTimer(AckTimer, SynInterval);
+			ScheduleTimer(ExpTimer, SynInterval);
+			_sendScheduled = true;
+
+			while (!_events.empty() && _events.top().time <= duration)
+			{
+				SimEvent e = _events.top();
+				_events.pop();
+				_now = e.time;
+
+				switch (e.type)
+				{
+				case SendTimer: OnSendTimer(); break;
+				case DataArrival: OnDataArrival(e); break;
+				case AckArrival: OnAckArrival(e); break;
+				case NakArrival: OnNakArrival(e); break;
+				case AckTimer: OnAckTimer(); break;
+				case ExpTimer: OnExpTimer(); break;
+				case SampleTimer: OnSampleTimer(sampleInterval); break;
+				}
+			}
+
+			_now = duration;
+		}
+	};
+}
+
+CongestionControlSimulator::CongestionControlSimulator(ICongestionControlFactory^ factory)
+	: _factory(factory), _bandwidth(10000000), _delay(TimeSpan::FromMilliseconds(25)), _queueLimit(100),
+	_lossRate(0), _maxPacketSize(1500), _sampleInterval(TimeSpan::FromMilliseconds(10)), _seed(0)
+{
+	if (factory == nullptr) throw gcnew ArgumentNullException("factory");
+}
+
+void CongestionControlSimulator::Bandwidth::set(__int64 value)
+{
+	if (value < 1)
+		throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than 0.");
+
+	_bandwidth = value;
+}
+
+void CongestionControlSimulator::Delay::set(TimeSpan value)
+{
+	if (value < TimeSpan::Zero)
+		throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than or equal to 0.");
+
+	_delay = value;
+}
+
+void CongestionControlSimulator::QueueLimit::set(int value)
+{
+	if (value < 1)
+		throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than 0.");
+
+	_queueLimit = value;
+}
+
+void CongestionControlSimulator::LossRate::set(double value)
+{
+	if (!(value >= 0 && value <= 1))
+		throw gcnew ArgumentOutOfRangeException("value", value, "Value must be between 0 and 1.");
+
+	_lossRate = value;
+}
+
+void CongestionControlSimulator::MaxPacketSize::set(int value)
+{
+	if (value <= PacketHeaderSize)
+		throw gcnew ArgumentOutOfRangeException("value", value, String::Concat("Value must be greater than ", PacketHeaderSize, "."));
+
+	_maxPacketSize = value;
+}
+
+void CongestionControlSimulator::SampleInterval::set(TimeSpan value)
+{
+	if (value <= TimeSpan::Zero)
+		throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than 0.");
+
+	_sampleInterval = value;
+}
+
+SimulationResult^ CongestionControlSimulator::Run(TimeSpan duration)
+{
+	if (duration <= TimeSpan::Zero)
+		throw gcnew ArgumentOutOfRangeException("duration", duration, "Value must be greater than 0.");
+
+	__int64 durationUs = ToMicroseconds(duration);
+	__int64 sampleUs = ToMicroseconds(_sampleInterval);
+	if (sampleUs < 1) sampleUs = 1;
+
+	CCC* cc = CCCWrapperFactory::CreateOffline(_factory);
+	SimulationResult^ result = gcnew SimulationResult();
+
+	try
+	{
+		Simulation simulation(cc, _bandwidth, ToMicroseconds(_delay), _queueLimit, _lossRate, _maxPacketSize, _seed);
+		simulation.Run(durationUs, sampleUs);
+
+		List<SimulationSample>^ samples = gcnew List<SimulationSample>((int)simulation.Samples.size());
+
+		for (size_t i = 0; i < simulation.Samples.size(); ++i)
+		{
+			const SimSample& native = simulation.Samples[i];
+			SimulationSample sample;
+			sample.Time = FromMicroseconds(native.time);
+			sample.WindowSize = native.windowSize;
+			sample.PacketSendPeriod = TimeSpan((__int64)(native.packetSendPeriod * 10));
+			sample.FlightSize = native.flightSize;
+			sample.QueueLength = native.queueLength;
+			sample.RoundtripTime = FromMicroseconds(native.roundtripTime);
+			sample.PacketsDelivered = native.delivered;
+			samples->Add(sample);
+		}
+
+		result->Duration = duration;
+		result->PacketsSent = simulation.PacketsSent;
+		result->PacketsRetransmitted = simulation.PacketsRetransmitted;
+		result->PacketsDropped = simulation.PacketsDropped;
+		result->PacketsLost = simulation.PacketsLost;
+		result->PacketsDelivered = simulation.Delivered();
+		result->Timeouts = simulation.Timeouts;
+		result->Goodput = simulation.Delivered() * (_maxPacketSize - PacketHeaderSize) * 8.0 / duration.TotalSeconds;
+		result->Utilization = result->Goodput / _bandwidth;
+		result->Samples = samples->AsReadOnly();
+	}
+	finally
+	{
+		cc->close();
+		delete cc;
+	}
+
+	return result;
+}
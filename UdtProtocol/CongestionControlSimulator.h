@@ -0,0 +1,168 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	interface class ICongestionControlFactory;
+	ref class SimulationResult;
+
+	/// <summary>
+	/// Discrete event simulation of a UDT sender, a bottleneck link and a
+	/// receiver, driving a <see cref="CongestionControl"/> without sockets.
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// The sender always has data. It sends when the flight size is below
+	/// <see cref="CongestionControl::WindowSize"/>, spaced by
+	/// <see cref="CongestionControl::PacketSendPeriod"/>, retransmitting lost
+	/// packets first. The link serializes packets at <see cref="Bandwidth"/>
+	/// through a drop-tail queue of <see cref="QueueLimit"/> packets, drops
+	/// packets at random with <see cref="LossRate"/> and delays them by
+	/// <see cref="Delay"/> in each direction.
+	/// </para>
+	/// <para>
+	/// The receiver reports gaps immediately (<see cref="CongestionControl::OnLoss"/>)
+	/// and acknowledges every 10 ms, the UDT SYN interval
+	/// (<see cref="CongestionControl::OnAck"/>). Unacknowledged data with no
+	/// progress for the UDT expiration period triggers
+	/// <see cref="CongestionControl::OnTimeout"/> and retransmission of all
+	/// outstanding packets. Acknowledgement timers and intervals requested
+	/// by the congestion control are not modeled.
+	/// </para>
+	/// <para>
+	/// Time is simulated, so a run of minutes completes in milliseconds, and
+	/// the same <see cref="Seed"/> always gives the same result.
+	/// </para>
+	/// </remarks>
+	public ref class CongestionControlSimulator
+	{
+	private:
+		ICongestionControlFactory^ _factory;
+		__int64 _bandwidth;
+		System::TimeSpan _delay;
+		int _queueLimit;
+		double _lossRate;
+		int _maxPacketSize;
+		System::TimeSpan _sampleInterval;
+		int _seed;
+
+	public:
+
+		/// <summary>
+		/// Initialize a new instance with a 10 Mbit/s, 50 ms round trip link.
+		/// </summary>
+		/// <param name="factory">Creates the congestion control for each run, including native plug-ins and groups.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="factory"/> is null.</exception>
+		CongestionControlSimulator(ICongestionControlFactory^ factory);
+
+		/// <summary>
+		/// Get or set the bottleneck rate, in bits per second.
+		/// </summary>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="value"/> is less than 1.</exception>
+		property __int64 Bandwidth
+		{
+			__int64 get(void) { return _bandwidth; }
+			void set(__int64 value);
+		}
+
+		/// <summary>
+		/// Get or set the one way propagation delay.
+		/// </summary>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="value"/> is less than <see cref="System::TimeSpan::Zero"/>.</exception>
+		property System::TimeSpan Delay
+		{
+			System::TimeSpan get(void) { return _delay; }
+			void set(System::TimeSpan value);
+		}
+
+		/// <summary>
+		/// Get or set the bottleneck queue capacity, in packets.
+		/// </summary>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="value"/> is less than 1.</exception>
+		property int QueueLimit
+		{
+			int get(void) { return _queueLimit; }
+			void set(int value);
+		}
+
+		/// <summary>
+		/// Get or set the probability that the link drops a packet, 0 to 1.
+		/// </summary>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="value"/> is not between 0 and 1.</exception>
+		property double LossRate
+		{
+			double get(void) { return _lossRate; }
+			void set(double value);
+		}
+
+		/// <summary>
+		/// Get or set the packet size on the link, in bytes, including the
+		/// UDT, UDP and IP headers. Default value is 1500.
+		/// </summary>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="value"/> is not greater than the 44 byte header size.</exception>
+		property int MaxPacketSize
+		{
+			int get(void) { return _maxPacketSize; }
+			void set(int value);
+		}
+
+		/// <summary>
+		/// Get or set the interval between entries of
+		/// <see cref="SimulationResult::Samples"/>. Default value is 10 ms.
+		/// </summary>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="value"/> is not greater than <see cref="System::TimeSpan::Zero"/>.</exception>
+		property System::TimeSpan SampleInterval
+		{
+			System::TimeSpan get(void) { return _sampleInterval; }
+			void set(System::TimeSpan value);
+		}
+
+		/// <summary>
+		/// Get or set the seed for random loss.
+		/// </summary>
+		property int Seed
+		{
+			int get(void) { return _seed; }
+			void set(int value) { _seed = value; }
+		}
+
+		/// <summary>
+		/// Run a new congestion control instance for the given simulated time.
+		/// </summary>
+		/// <param name="duration">Simulated time to run.</param>
+		/// <returns>Counters and sampled congestion control state.</returns>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="duration"/> is not greater than <see cref="System::TimeSpan::Zero"/>.</exception>
+		SimulationResult^ Run(System::TimeSpan duration);
+	};
+}
@@ -32,21 +32,67 @@
 
 #include "StdAfx.h"
 #include "ControlPacket.h"
+#include "PacketBufferPool.h"
 
 #include <udt.h>
 #include <packet.h>
 
 using namespace Udt;
+using namespace System;
 
 ControlPacket::ControlPacket(void)
+	: _ownsData(false)
 {
 }
 
 ControlPacket::ControlPacket(const CPacket* packet)
-	: Packet(packet)
+	: Packet(packet), _ownsData(false)
 {
 }
 
 ControlPacket::~ControlPacket(void)
 {
 }
+
+void ControlPacket::FreePacketData()
+{
+	if (_ownsData)
+		PacketBufferPool::Free(_packet->m_pcData);
+}
+
+void ControlPacket::SetControlInformation(const char* data, int length)
+{
+	int capacity;
+	char* buffer = PacketBufferPool::Allocate(length, capacity);
+
+	if (buffer == NULL)
+		throw gcnew OutOfMemoryException();
+
+	memcpy(buffer, data, length);
+	FreePacketData();
+
+	_packet->m_pcData = buffer;
+	_packet->setLength(length);
+	_ownsData = true;
+}
+
+int ControlPacket::ControlType::get(void)
+{
+	AssertNotDisposed();
+	return _packet->getType();
+}
+
+cli::array<int>^ ControlPacket::GetControlInformation(void)
+{
+	AssertNotDisposed();
+
+	cli::array<int>^ words = gcnew cli::array<int>(_packet->getLength() / 4);
+
+	if (words->Length > 0)
+	{
+		pin_ptr<int> wordsPin = &words[0];
+		memcpy(wordsPin, _packet->m_pcData, words->Length * 4);
+	}
+
+	return words;
+}
@@ -43,11 +43,36 @@ namespace Udt
 	/// </summary>
 	public ref class ControlPacket : public Packet
 	{
+	private:
+		bool _ownsData;
+
+	protected:
+
+		virtual void FreePacketData() override;
+
 	internal:
 		ControlPacket(void);
 		ControlPacket(const CPacket* packet);
 
+		void SetControlInformation(const char* data, int length);
+
 	public:
 		virtual ~ControlPacket(void);
+
+		/// <summary>
+		/// Get the control packet type code.
+		/// </summary>
+		/// <exception cref="System::ObjectDisposedException">If the object has been disposed.</exception>
+		property int ControlType {
+			int get(void);
+		}
+
+		/// <summary>
+		/// Get the control information words that follow the header, such
+		/// as the fields of an ACK or the loss list of a NAK.
+		/// </summary>
+		/// <returns>Copy of the control information, in host byte order.</returns>
+		/// <exception cref="System::ObjectDisposedException">If the object has been disposed.</exception>
+		cli::array<int>^ GetControlInformation(void);
 	};
 }
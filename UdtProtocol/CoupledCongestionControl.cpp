@@ -0,0 +1,353 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "CoupledCongestionControl.h"
+#include "PacketCaptureRing.h"
+#include "MicrosecondClock.h"
+
+#include <udt.h>
+#include <math.h>
+
+using namespace Udt;
+
+#pragma managed(push, off)
+
+namespace
+{
+	const int32_t MaxSequence = 0x7FFFFFFF;
+
+	// Same as CSeqNo::seqlen, which UDT does not export
+	int SequenceLength(int32_t first, int32_t last)
+	{
+		return (first <= last) ? (last - first + 1) : (last - first + MaxSequence + 2);
+	}
+}
+
+CoupledGroupState::CoupledGroupState(void)
+	: _references(1), _members(0), _active(0), _rate(0), _lastDecreaseRate(0), _lastIncrease(0), _lastDecrease(0)
+{
+	InitializeCriticalSection(&_lock);
+}
+
+CoupledGroupState::~CoupledGroupState(void)
+{
+	DeleteCriticalSection(&_lock);
+}
+
+void CoupledGroupState::AddRef(void)
+{
+	InterlockedIncrement(&_references);
+}
+
+void CoupledGroupState::Release(void)
+{
+	if (InterlockedDecrement(&_references) == 0)
+		delete this;
+}
+
+double CoupledGroupState::MemberPeriodLocked(void) const
+{
+	return _active * 1000000.0 / _rate;
+}
+
+void CoupledGroupState::Join(void)
+{
+	EnterCriticalSection(&_lock);
+	++_members;
+	LeaveCriticalSection(&_lock);
+}
+
+void CoupledGroupState::Leave(bool active)
+{
+	EnterCriticalSection(&_lock);
+	--_members;
+
+	// The remaining members take over the share; the bottleneck has not changed
+	if (active && --_active == 0)
+	{
+		_rate = 0;
+		_lastDecreaseRate = 0;
+	}
+
+	LeaveCriticalSection(&_lock);
+}
+
+double CoupledGroupState::Activate(double rate)
+{
+	EnterCriticalSection(&_lock);
+	++_active;
+	_rate += rate;
+	double period = MemberPeriodLocked();
+	LeaveCriticalSection(&_lock);
+
+	return period;
+}
+
+double CoupledGroupState::Increase(int bandwidth, int mss, int interval)
+{
+	const double minIncrease = 0.01;
+	__int64 now = MicrosecondClock::Now();
+
+	EnterCriticalSection(&_lock);
+
+	if (now - _lastIncrease >= interval)
+	{
+		_lastIncrease = now;
+
+		// CUDTCC's increase, applied to the aggregate
+		double period = 1000000.0 / _rate;
+		__int64 available = (__int64)(bandwidth - _rate);
+
+		if (_rate < _lastDecreaseRate && (bandwidth / 9) < available)
+			available = bandwidth / 9;
+
+		double increase = minIncrease;
+
+		if (available > 0)
+		{
+			increase = pow(10.0, ceil(log10(available * mss * 8.0))) * 0.0000015 / mss;
+
+			if (increase < minIncrease)
+				increase = minIncrease;
+		}
+
+		period = (period * interval) / (period * increase + interval);
+		_rate = 1000000.0 / period;
+	}
+
+	double memberPeriod = MemberPeriodLocked();
+	LeaveCriticalSection(&_lock);
+
+	return memberPeriod;
+}
+
+double CoupledGroupState::Decrease(int rtt)
+{
+	__int64 now = MicrosecondClock::Now();
+
+	EnterCriticalSection(&_lock);
+
+	// Members behind one bottleneck see the same congestion event
+	if (now - _lastDecrease >= rtt)
+	{
+		_lastDecrease = now;
+		_lastDecreaseRate = _rate;
+		_rate /= 1.125;
+	}
+
+	double memberPeriod = MemberPeriodLocked();
+	LeaveCriticalSection(&_lock);
+
+	return memberPeriod;
+}
+
+double CoupledGroupState::MemberPeriod(void)
+{
+	EnterCriticalSection(&_lock);
+	double period = MemberPeriodLocked();
+	LeaveCriticalSection(&_lock);
+
+	return period;
+}
+
+int CoupledGroupState::Members(void)
+{
+	EnterCriticalSection(&_lock);
+	int members = _members;
+	LeaveCriticalSection(&_lock);
+
+	return members;
+}
+
+double CoupledGroupState::Rate(void)
+{
+	EnterCriticalSection(&_lock);
+	double rate = _rate;
+	LeaveCriticalSection(&_lock);
+
+	return rate;
+}
+
+CoupledCC::CoupledCC(CoupledGroupState* group, PacketCaptureRing* capture)
+	: _group(group), _capture(capture), _rcInterval(0), _lastRCTime(0), _lastAck(0), _slowStart(true), _loss(false)
+{
+	_group->AddRef();
+	_group->Join();
+
+	if (_capture != NULL)
+		_capture->AddRef();
+}
+
+CoupledCC::~CoupledCC(void)
+{
+	_group->Leave(!_slowStart);
+	_group->Release();
+
+	if (_capture != NULL)
+		_capture->Release();
+}
+
+void CoupledCC::init(void)
+{
+	_rcInterval = m_iSYNInterval;
+	_lastRCTime = MicrosecondClock::Now();
+	setACKTimer(_rcInterval);
+
+	_slowStart = true;
+	_loss = false;
+	_lastAck = m_iSndCurrSeqNo;
+
+	m_dCWndSize = 16;
+	m_dPktSndPeriod = 1;
+}
+
+void CoupledCC::LeaveSlowStart(void)
+{
+	_slowStart = false;
+
+	double rate = m_iRcvRate > 0 ? m_iRcvRate : m_dCWndSize * 1000000.0 / (m_iRTT + _rcInterval);
+	m_dPktSndPeriod = _group->Activate(rate);
+}
+
+void CoupledCC::onACK(int32_t ack)
+{
+	__int64 now = MicrosecondClock::Now();
+
+	if (now - _lastRCTime >= _rcInterval)
+	{
+		_lastRCTime = now;
+
+		if (_slowStart)
+		{
+			m_dCWndSize += SequenceLength(_lastAck, ack);
+			_lastAck = ack;
+
+			if (m_dCWndSize > m_dMaxCWndSize)
+				LeaveSlowStart();
+		}
+		else
+		{
+			m_dCWndSize = m_iRcvRate / 1000000.0 * (m_iRTT + _rcInterval) + 16;
+		}
+
+		if (!_slowStart)
+		{
+			if (_loss)
+			{
+				_loss = false;
+				m_dPktSndPeriod = _group->MemberPeriod();
+			}
+			else
+			{
+				m_dPktSndPeriod = _group->Increase(m_iBandwidth, m_iMSS, _rcInterval);
+			}
+		}
+	}
+
+	if (_capture != NULL)
+		_capture->RecordAck(this, ack);
+}
+
+void CoupledCC::onLoss(const int32_t* losslist, int size)
+{
+	bool decrease = true;
+
+	if (_slowStart)
+	{
+		LeaveSlowStart();
+
+		// The measured rate already reflects the loss
+		decrease = m_iRcvRate <= 0;
+	}
+
+	if (decrease)
+	{
+		_loss = true;
+		m_dPktSndPeriod = _group->Decrease(m_iRTT);
+	}
+
+	if (_capture != NULL)
+		_capture->RecordLoss(this, losslist, size);
+}
+
+void CoupledCC::onTimeout(void)
+{
+	if (_slowStart)
+		LeaveSlowStart();
+	else
+		m_dPktSndPeriod = _group->MemberPeriod();
+
+	if (_capture != NULL)
+		_capture->RecordTimeout(this);
+}
+
+void CoupledCC::onPktSent(const CPacket* packet)
+{
+	if (_capture != NULL)
+		_capture->RecordPacket(this, CaptureDataSent, packet);
+}
+
+void CoupledCC::onPktReceived(const CPacket* packet)
+{
+	if (_capture != NULL)
+		_capture->RecordPacket(this, CaptureDataReceived, packet);
+}
+
+CoupledCCFactory::CoupledCCFactory(CoupledGroupState* group, PacketCaptureRing* capture)
+	: _group(group), _capture(capture)
+{
+	_group->AddRef();
+
+	if (_capture != NULL)
+		_capture->AddRef();
+}
+
+CoupledCCFactory::~CoupledCCFactory(void)
+{
+	_group->Release();
+
+	if (_capture != NULL)
+		_capture->Release();
+}
+
+CCC* CoupledCCFactory::create()
+{
+	return new CoupledCC(_group, _capture);
+}
+
+CCCVirtualFactory* CoupledCCFactory::clone()
+{
+	return new CoupledCCFactory(_group, _capture);
+}
+
+#pragma managed(pop)
@@ -0,0 +1,152 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+#include <ccc.h>
+
+namespace Udt
+{
+	class PacketCaptureRing;
+
+	/// <summary>
+	/// Aggregate sending rate shared by the members of a coupled
+	/// congestion control group.
+	/// </summary>
+	/// <remarks>
+	/// The group runs UDT's native rate control once for all members: at
+	/// most one increase per rate control interval and one decrease per
+	/// round trip, however many members see the ACK or loss. Each member
+	/// past slow start sends an equal share of the aggregate rate. Members
+	/// call in from their own UDT threads, so all state is under a lock.
+	/// Reference counted; the group outlives every member and factory
+	/// that holds it.
+	/// </remarks>
+	class CoupledGroupState
+	{
+	private:
+		CRITICAL_SECTION _lock;
+		volatile LONG _references;
+		int _members;
+		int _active;
+		double _rate;
+		double _lastDecreaseRate;
+		__int64 _lastIncrease;
+		__int64 _lastDecrease;
+
+		CoupledGroupState(const CoupledGroupState&);
+		CoupledGroupState& operator=(const CoupledGroupState&);
+
+		~CoupledGroupState(void);
+
+		double MemberPeriodLocked(void) const;
+
+	public:
+
+		CoupledGroupState(void);
+
+		void AddRef(void);
+		void Release(void);
+
+		void Join(void);
+		void Leave(bool active);
+
+		/// <summary>
+		/// Add a member leaving slow start with its measured rate.
+		/// </summary>
+		/// <returns>The member's packet send period, in microseconds.</returns>
+		double Activate(double rate);
+
+		/// <summary>
+		/// Apply one additive increase to the aggregate rate if the rate
+		/// control interval has passed since the last one.
+		/// </summary>
+		/// <returns>The member's packet send period, in microseconds.</returns>
+		double Increase(int bandwidth, int mss, int interval);
+
+		/// <summary>
+		/// Apply one multiplicative decrease to the aggregate rate unless
+		/// one was applied within the last round trip.
+		/// </summary>
+		/// <returns>The member's packet send period, in microseconds.</returns>
+		double Decrease(int rtt);
+
+		double MemberPeriod(void);
+		int Members(void);
+		double Rate(void);
+	};
+
+	/// <summary>
+	/// Member of a coupled group. Slow start is per connection, as in
+	/// CUDTCC; after it the member's rate comes from the group. The window
+	/// stays per connection since it tracks the member's own receive rate
+	/// and round trip.
+	/// </summary>
+	class CoupledCC : public CCC
+	{
+	private:
+		CoupledGroupState* _group;
+		PacketCaptureRing* _capture;
+		int _rcInterval;
+		__int64 _lastRCTime;
+		int32_t _lastAck;
+		bool _slowStart;
+		bool _loss;
+
+		void LeaveSlowStart(void);
+
+	public:
+		CoupledCC(CoupledGroupState* group, PacketCaptureRing* capture);
+		virtual ~CoupledCC(void);
+
+		virtual void init(void);
+		virtual void onACK(int32_t ack);
+		virtual void onLoss(const int32_t* losslist, int size);
+		virtual void onTimeout(void);
+		virtual void onPktSent(const CPacket* packet);
+		virtual void onPktReceived(const CPacket* packet);
+	};
+
+	class CoupledCCFactory : public CCCVirtualFactory
+	{
+	private:
+		CoupledGroupState* _group;
+		PacketCaptureRing* _capture;
+
+	public:
+		CoupledCCFactory(CoupledGroupState* group, PacketCaptureRing* capture);
+		virtual ~CoupledCCFactory(void);
+
+		virtual CCC* create();
+		virtual CCCVirtualFactory* clone();
+	};
+}
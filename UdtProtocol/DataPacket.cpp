@@ -32,6 +32,7 @@
 
 #include "StdAfx.h"
 #include "DataPacket.h"
+#include "PacketBufferPool.h"
 
 #include <udt.h>
 #include <packet.h>
@@ -55,7 +56,7 @@ DataPacket::~DataPacket(void)
 
 void DataPacket::FreePacketData()
 {
-	delete [] _packet->m_pcData;
+	PacketBufferPool::Free(_packet->m_pcData);
 }
 
 Udt::MessageBoundary DataPacket::MessageBoundary::get(void)
@@ -138,6 +139,20 @@ int DataPacket::DataCapacity::get(void)
 	return _capacity;
 }
 
+DataPacketHeader DataPacket::Header::get(void)
+{
+	AssertNotDisposed();
+
+	// m_iSeqNo aliases the first of the four contiguous header words
+	return DataPacketHeader(&_packet->m_iSeqNo, _packet->getLength());
+}
+
+IntPtr DataPacket::Data::get(void)
+{
+	AssertNotDisposed();
+	return IntPtr(_packet->m_pcData);
+}
+
 void DataPacket::EnsureCapacity(int value)
 {
 	if (value > _capacity)
@@ -149,9 +164,13 @@ void DataPacket::EnsureCapacity(int value)
 		else if (newCapacity < _capacity * 2)
 			newCapacity = _capacity * 2;
 
-		char* newBuf = new char[newCapacity];
+		char* newBuf = PacketBufferPool::Allocate(newCapacity, newCapacity);
+
+		if (newBuf == NULL)
+			throw gcnew OutOfMemoryException();
+
 		memcpy(newBuf, _packet->m_pcData, _packet->getLength());
-		delete [] _packet->m_pcData;
+		PacketBufferPool::Free(_packet->m_pcData);
 		_packet->m_pcData = newBuf;
 		_capacity = newCapacity;
 	}
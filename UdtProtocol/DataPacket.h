@@ -34,6 +34,7 @@
 
 #include "Packet.h"
 #include "MessageBoundary.h"
+#include "DataPacketHeader.h"
 
 namespace Udt
 {
@@ -123,11 +124,40 @@ namespace Udt
 		/// Get the space allocated to the packet payload. This may be greater
 		/// than or equal to <see cref="DataLength"/>.
 		/// </summary>
+		/// <remarks>
+		/// Payload buffers come from a shared pool and are rounded up to the
+		/// pool's size classes, the smallest of which is 128 bytes.
+		/// </remarks>
 		/// <exception cref="System::ObjectDisposedException">If the object has been disposed.</exception>
 		property int DataCapacity {
 			int get(void);
 		}
 
+		/// <summary>
+		/// Get all header fields in one call.
+		/// </summary>
+		/// <exception cref="System::ObjectDisposedException">If the object has been disposed.</exception>
+		property DataPacketHeader Header {
+			DataPacketHeader get(void);
+		}
+
+		/// <summary>
+		/// Get a pointer to the packet payload, <see cref="DataLength"/>
+		/// bytes long.
+		/// </summary>
+		/// <remarks>
+		/// The payload is read in place, without copying. The pointer is
+		/// valid until the packet is disposed; for packets passed to a
+		/// <see cref="CongestionControl"/> that means only for the duration
+		/// of the callback. Changing <see cref="DataLength"/> or calling
+		/// <see cref="Write"/> may move the payload. The value is
+		/// <see cref="System::IntPtr::Zero"/> if the packet has no payload.
+		/// </remarks>
+		/// <exception cref="System::ObjectDisposedException">If the object has been disposed.</exception>
+		property System::IntPtr Data {
+			System::IntPtr get(void);
+		}
+
 		/// <summary>
 		/// Read from the packet payload data.
 		/// </summary>
@@ -0,0 +1,116 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+#include "MessageBoundary.h"
+
+namespace Udt
+{
+	/// <summary>
+	/// Header fields of a <see cref="DataPacket"/>, read in one call.
+	/// </summary>
+	/// <remarks>
+	/// The struct holds the four UDT header words as UDT keeps them in host
+	/// byte order plus the payload length, so it is blittable and cheap to
+	/// copy; the properties decode the fields on demand.
+	/// </remarks>
+	[System::Runtime::InteropServices::StructLayout(System::Runtime::InteropServices::LayoutKind::Sequential)]
+	public value struct DataPacketHeader
+	{
+	private:
+
+		int _sequence;
+		int _message;
+		int _timeStamp;
+		int _destination;
+		int _dataLength;
+
+	internal:
+
+		DataPacketHeader(const int* header, int dataLength)
+			: _sequence(header[0]), _message(header[1]), _timeStamp(header[2]), _destination(header[3]), _dataLength(dataLength)
+		{
+		}
+
+	public:
+
+		/// <summary>
+		/// Get the packet sequence number.
+		/// </summary>
+		property int PacketNumber {
+			int get(void) { return _sequence; }
+		}
+
+		/// <summary>
+		/// Get the message sequence number.
+		/// </summary>
+		property int MessageNumber {
+			int get(void) { return _message & 0x1FFFFFFF; }
+		}
+
+		/// <summary>
+		/// Get the location of the packet in the stream.
+		/// </summary>
+		property Udt::MessageBoundary MessageBoundary {
+			Udt::MessageBoundary get(void) { return (Udt::MessageBoundary)((unsigned int)_message >> 30); }
+		}
+
+		/// <summary>
+		/// Get true if in-order delivery is required.
+		/// </summary>
+		property bool InOrder {
+			bool get(void) { return (_message & 0x20000000) != 0; }
+		}
+
+		/// <summary>
+		/// Get the time stamp of the packet.
+		/// </summary>
+		property System::TimeSpan TimeStamp {
+			System::TimeSpan get(void) { return FromMicroseconds((unsigned int)_timeStamp); }
+		}
+
+		/// <summary>
+		/// Get ID of the destination socket for the packet.
+		/// </summary>
+		property int DestinationId {
+			int get(void) { return _destination; }
+		}
+
+		/// <summary>
+		/// Get the length of the packet payload, in bytes.
+		/// </summary>
+		property int DataLength {
+			int get(void) { return _dataLength; }
+		}
+	};
+}
@@ -0,0 +1,106 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	/// <summary>
+	/// One-way delay of a batch of received data packets, delivered to
+	/// <see cref="CongestionControl::OnDelay"/>.
+	/// </summary>
+	/// <remarks>
+	/// Delays are the local receive time minus the sender's time stamp, so
+	/// <see cref="CurrentDelay"/> and <see cref="BaseDelay"/> include the
+	/// offset between the two clocks and may be negative.
+	/// <see cref="QueuingDelay"/> is their difference, in which the offset
+	/// cancels.
+	/// </remarks>
+	[System::Runtime::InteropServices::StructLayout(System::Runtime::InteropServices::LayoutKind::Sequential)]
+	public value struct DelayInfo
+	{
+	private:
+
+		int _count;
+		int _current;
+		int _base;
+		double _gradient;
+
+	internal:
+
+		DelayInfo(int count, int current, int base, double gradient)
+			: _count(count), _current(current), _base(base), _gradient(gradient)
+		{
+		}
+
+	public:
+
+		/// <summary>
+		/// Get the number of packets in the batch.
+		/// </summary>
+		property int SampleCount {
+			int get(void) { return _count; }
+		}
+
+		/// <summary>
+		/// Get the smallest one-way delay in the batch.
+		/// </summary>
+		property System::TimeSpan CurrentDelay {
+			System::TimeSpan get(void) { return FromMicroseconds(_current); }
+		}
+
+		/// <summary>
+		/// Get the smallest one-way delay seen in the last ten minutes.
+		/// </summary>
+		property System::TimeSpan BaseDelay {
+			System::TimeSpan get(void) { return FromMicroseconds(_base); }
+		}
+
+		/// <summary>
+		/// Get the delay added by queues along the path.
+		/// </summary>
+		property System::TimeSpan QueuingDelay {
+			System::TimeSpan get(void) { return FromMicroseconds((__int64)_current - _base); }
+		}
+
+		/// <summary>
+		/// Get the change of <see cref="CurrentDelay"/> since the previous
+		/// batch, in seconds of delay per second.
+		/// </summary>
+		/// <remarks>
+		/// Positive while queues build up, negative while they drain.
+		/// </remarks>
+		property double DelayGradient {
+			double get(void) { return _gradient; }
+		}
+	};
+}
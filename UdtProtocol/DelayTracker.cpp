@@ -0,0 +1,110 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+
+#include <udt.h>
+#include <limits.h>
+
+#include "DelayTracker.h"
+#include "MicrosecondClock.h"
+
+using namespace Udt;
+
+#pragma managed(push, off)
+
+DelayTracker::DelayTracker(void)
+	: _count(0), _batchMinimum(INT_MAX), _batchStart(0), _baseIndex(0), _baseStart(0), _lastCurrent(0), _lastTime(0)
+{
+	for (int i = 0; i < BaseHistory; ++i)
+		_baseMinima[i] = INT_MAX;
+}
+
+bool DelayTracker::Add(int32_t timeStamp)
+{
+	__int64 now = MicrosecondClock::Now();
+
+	// Both clocks are 32 bit microsecond counters; the difference survives wrap
+	int delay = (int)((uint32_t)now - (uint32_t)timeStamp);
+
+	if (_count == 0)
+		_batchStart = now;
+
+	if (_baseStart == 0)
+		_baseStart = now;
+
+	_samples[_count++] = delay;
+
+	if (delay < _batchMinimum)
+		_batchMinimum = delay;
+
+	if (now - _baseStart >= BaseInterval)
+	{
+		_baseIndex = (_baseIndex + 1) % BaseHistory;
+		_baseMinima[_baseIndex] = delay;
+		_baseStart = now;
+	}
+	else if (delay < _baseMinima[_baseIndex])
+	{
+		_baseMinima[_baseIndex] = delay;
+	}
+
+	return _count == Capacity || now - _batchStart >= BatchInterval;
+}
+
+DelaySummary DelayTracker::Flush(void)
+{
+	DelaySummary summary;
+	summary.count = _count;
+	summary.current = _batchMinimum;
+	summary.base = INT_MAX;
+	summary.gradient = 0;
+
+	for (int i = 0; i < BaseHistory; ++i)
+	{
+		if (_baseMinima[i] < summary.base)
+			summary.base = _baseMinima[i];
+	}
+
+	// Change of the batch minimum per unit of time since the previous batch
+	if (_lastTime != 0 && _batchStart > _lastTime)
+		summary.gradient = (double)(summary.current - _lastCurrent) / (double)(_batchStart - _lastTime);
+
+	_lastCurrent = summary.current;
+	_lastTime = _batchStart;
+	_count = 0;
+	_batchMinimum = INT_MAX;
+
+	return summary;
+}
+
+#pragma managed(pop)
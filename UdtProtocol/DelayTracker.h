@@ -0,0 +1,114 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	/// <summary>
+	/// Summary of one batch of one-way delay samples.
+	/// </summary>
+	struct DelaySummary
+	{
+		int count;
+		int current;
+		int base;
+		double gradient;
+	};
+
+	/// <summary>
+	/// Computes one-way delay samples from the time stamps of received data
+	/// packets and batches them for delivery to a congestion control.
+	/// </summary>
+	/// <remarks>
+	/// A sample is the local receive time minus the sender's time stamp, in
+	/// microseconds, so it includes the unknown offset between the two
+	/// clocks. The base delay is the minimum over the last ten minutes kept
+	/// as per-minute minima (LEDBAT's base history), which cancels the
+	/// offset when subtracted. Not thread safe; UDT delivers a socket's
+	/// congestion control callbacks on one thread at a time.
+	/// </remarks>
+	class DelayTracker
+	{
+	public:
+
+		/// <summary>
+		/// Samples per batch before it is delivered regardless of time.
+		/// </summary>
+		static const int Capacity = 256;
+
+		/// <summary>
+		/// Time a batch collects samples before it is delivered, in
+		/// microseconds.
+		/// </summary>
+		static const int BatchInterval = 10000;
+
+	private:
+		static const int BaseHistory = 10;
+		static const __int64 BaseInterval = 60000000;
+
+		int _samples[Capacity];
+		int _count;
+		int _batchMinimum;
+		__int64 _batchStart;
+
+		int _baseMinima[BaseHistory];
+		int _baseIndex;
+		__int64 _baseStart;
+
+		int _lastCurrent;
+		__int64 _lastTime;
+
+	public:
+
+		DelayTracker(void);
+
+		/// <summary>
+		/// Add the sample for a received data packet.
+		/// </summary>
+		/// <param name="timeStamp">Sender time stamp of the packet, in microseconds.</param>
+		/// <returns>True if the batch is due for delivery.</returns>
+		bool Add(int32_t timeStamp);
+
+		int Count(void) const { return _count; }
+		const int* Samples(void) const { return _samples; }
+
+		/// <summary>
+		/// Summarize the current batch and start a new one.
+		/// </summary>
+		/// <remarks>
+		/// The samples stay readable through <see cref="Samples"/> until
+		/// the next call to <see cref="Add"/>.
+		/// </remarks>
+		DelaySummary Flush(void);
+	};
+}
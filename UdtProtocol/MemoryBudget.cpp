@@ -0,0 +1,253 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "MemoryBudget.h"
+
+#include "Socket.h"
+#include "SocketException.h"
+
+using namespace Udt;
+using namespace System;
+using namespace System::Threading;
+
+MemoryBudget::MemoryBudget(__int64 limit)
+	: _lock(gcnew Object()),
+	_minimumBufferSize(DefaultMinimumBufferSize),
+	_reserved(0),
+	_socketCount(0),
+	_throttledCount(0),
+	_rejectedCount(0)
+{
+	if (limit < 0)
+		throw gcnew ArgumentOutOfRangeException("limit", limit, "Value must be greater than or equal to 0.");
+
+	_limit = limit;
+}
+
+bool MemoryBudget::Fit(Socket^ socket)
+{
+	// Half of what is left, split between the send and receive buffers
+	__int64 share = Math::Max(0LL, _limit - _reserved) / 4;
+	int size = (int)Math::Min((__int64)Int32::MaxValue, Math::Max((__int64)_minimumBufferSize, share));
+	bool shrunk = false;
+
+	if (socket->SendBufferSize > size)
+	{
+		socket->SendBufferSize = size;
+		shrunk = true;
+	}
+
+	if (socket->ReceiveBufferSize > size)
+	{
+		socket->ReceiveBufferSize = size;
+		shrunk = true;
+	}
+
+	if (shrunk)
+		_throttledCount++;
+
+	return shrunk;
+}
+
+bool MemoryBudget::Apply(Socket^ socket)
+{
+	if (socket == nullptr) throw gcnew ArgumentNullException("socket");
+
+	if (socket->State != SocketState::Initial)
+		throw gcnew SocketException("Socket buffers can not change once it is bound.", SocketError::BoundSocket);
+
+	Monitor::Enter(_lock);
+
+	try
+	{
+		return Fit(socket);
+	}
+	finally
+	{
+		Monitor::Exit(_lock);
+	}
+}
+
+__int64 MemoryBudget::Reserve(Socket^ socket)
+{
+	bool opened = (socket->State != SocketState::Initial);
+
+	Monitor::Enter(_lock);
+
+	try
+	{
+		if (!opened)
+			Fit(socket);
+
+		__int64 bytes = (__int64)socket->SendBufferSize + socket->ReceiveBufferSize;
+
+		// Buffers of an open socket are fixed, it either fits as it is or not at all
+		if (_reserved + bytes > _limit)
+		{
+			_rejectedCount++;
+			throw gcnew SocketException("Memory budget exhausted.", SocketError::NoBuffer);
+		}
+
+		_reserved += bytes;
+		_socketCount++;
+		return bytes;
+	}
+	finally
+	{
+		Monitor::Exit(_lock);
+	}
+}
+
+void MemoryBudget::Release(__int64 bytes)
+{
+	Monitor::Enter(_lock);
+
+	try
+	{
+		_reserved -= bytes;
+		_socketCount--;
+	}
+	finally
+	{
+		Monitor::Exit(_lock);
+	}
+}
+
+__int64 MemoryBudget::Limit::get(void)
+{
+	Monitor::Enter(_lock);
+
+	try
+	{
+		return _limit;
+	}
+	finally
+	{
+		Monitor::Exit(_lock);
+	}
+}
+
+void MemoryBudget::Limit::set(__int64 value)
+{
+	if (value < 0)
+		throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than or equal to 0.");
+
+	Monitor::Enter(_lock);
+
+	try
+	{
+		_limit = value;
+	}
+	finally
+	{
+		Monitor::Exit(_lock);
+	}
+}
+
+void MemoryBudget::MinimumBufferSize::set(int value)
+{
+	if (value < 1)
+		throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than 0.");
+
+	_minimumBufferSize = value;
+}
+
+__int64 MemoryBudget::Reserved::get(void)
+{
+	Monitor::Enter(_lock);
+
+	try
+	{
+		return _reserved;
+	}
+	finally
+	{
+		Monitor::Exit(_lock);
+	}
+}
+
+__int64 MemoryBudget::Available::get(void)
+{
+	Monitor::Enter(_lock);
+
+	try
+	{
+		return Math::Max(0LL, _limit - _reserved);
+	}
+	finally
+	{
+		Monitor::Exit(_lock);
+	}
+}
+
+int MemoryBudget::SocketCount::get(void)
+{
+	Monitor::Enter(_lock);
+
+	try
+	{
+		return _socketCount;
+	}
+	finally
+	{
+		Monitor::Exit(_lock);
+	}
+}
+
+__int64 MemoryBudget::ThrottledCount::get(void)
+{
+	Monitor::Enter(_lock);
+
+	try
+	{
+		return _throttledCount;
+	}
+	finally
+	{
+		Monitor::Exit(_lock);
+	}
+}
+
+__int64 MemoryBudget::RejectedCount::get(void)
+{
+	Monitor::Enter(_lock);
+
+	try
+	{
+		return _rejectedCount;
+	}
+	finally
+	{
+		Monitor::Exit(_lock);
+	}
+}
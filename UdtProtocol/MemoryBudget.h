@@ -0,0 +1,188 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	ref class Socket;
+
+	/// <summary>
+	/// Byte budget for the UDT buffers of a group of sockets, usually every
+	/// socket in the process.
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// UDT grows a socket's send and receive buffers on demand up to
+	/// <see cref="Socket::SendBufferSize"/> and
+	/// <see cref="Socket::ReceiveBufferSize"/>, and fixes both sizes when
+	/// the socket opens. A socket using a budget reserves the sum of the
+	/// two when it connects or is accepted, and releases it when it
+	/// closes. Before a socket connects or binds, its buffers are shrunk
+	/// to its share: half of the budget still available, split between
+	/// the two buffers, but not below <see cref="MinimumBufferSize"/>. As
+	/// the budget fills, new connections get smaller buffers and so a
+	/// smaller window. A connect that would go over
+	/// <see cref="Limit"/> fails with <see cref="SocketError::NoBuffer"/>.
+	/// </para>
+	/// <para>
+	/// Accepted sockets inherit the buffer sizes of the listener, which
+	/// were fitted when it was bound. An accepted socket that would go over
+	/// <see cref="Limit"/> is closed and <see cref="Socket::Accept"/> fails
+	/// with <see cref="SocketError::NoBuffer"/>; sockets bound before they
+	/// connect are checked the same way without being shrunk. Both count
+	/// in <see cref="RejectedCount"/>. UDP socket buffers belong to the
+	/// operating system and are not counted. All members are thread safe.
+	/// </para>
+	/// </remarks>
+	public ref class MemoryBudget
+	{
+	private:
+		System::Object^ _lock;
+		__int64 _limit;
+		int _minimumBufferSize;
+		__int64 _reserved;
+		int _socketCount;
+		__int64 _throttledCount;
+		__int64 _rejectedCount;
+
+		bool Fit(Socket^ socket);
+
+	internal:
+
+		/// <summary>
+		/// Fit an unopened socket to its share and reserve its buffers.
+		/// Buffers of an opened socket are reserved as they are.
+		/// </summary>
+		/// <returns>Number of bytes reserved.</returns>
+		/// <exception cref="SocketException">If the socket does not fit in the budget.</exception>
+		__int64 Reserve(Socket^ socket);
+
+		void Release(__int64 bytes);
+
+	public:
+
+		/// <summary>
+		/// Default value of <see cref="MinimumBufferSize"/>.
+		/// </summary>
+		literal int DefaultMinimumBufferSize = 64 * 1024;
+
+		/// <summary>
+		/// Initialize a new budget.
+		/// </summary>
+		/// <param name="limit">Total bytes of UDT buffers the sockets may reserve.</param>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="limit"/> is less than 0.</exception>
+		MemoryBudget(__int64 limit);
+
+		/// <summary>
+		/// Shrink the buffers of an unopened socket to its share of the
+		/// budget, without reserving them.
+		/// </summary>
+		/// <remarks>
+		/// Sockets using this budget are fitted automatically when they
+		/// bind or connect.
+		/// </remarks>
+		/// <param name="socket">Socket to fit.</param>
+		/// <returns>True if a buffer was shrunk.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="socket"/> is null.</exception>
+		/// <exception cref="SocketException">If the socket is already bound or connected.</exception>
+		bool Apply(Socket^ socket);
+
+		/// <summary>
+		/// Get or set the total bytes of UDT buffers the sockets may
+		/// reserve.
+		/// </summary>
+		/// <remarks>
+		/// Lowering the limit below <see cref="Reserved"/> affects new
+		/// sockets only.
+		/// </remarks>
+		/// <exception cref="System::ArgumentOutOfRangeException">If the value is less than 0.</exception>
+		property __int64 Limit
+		{
+			__int64 get(void);
+			void set(__int64 value);
+		}
+
+		/// <summary>
+		/// Get or set the smallest buffer size a socket is shrunk to, in
+		/// bytes.
+		/// </summary>
+		/// <exception cref="System::ArgumentOutOfRangeException">If the value is less than 1.</exception>
+		property int MinimumBufferSize
+		{
+			int get(void) { return _minimumBufferSize; }
+			void set(int value);
+		}
+
+		/// <summary>
+		/// Get the bytes reserved by open sockets.
+		/// </summary>
+		property __int64 Reserved
+		{
+			__int64 get(void);
+		}
+
+		/// <summary>
+		/// Get the bytes left before <see cref="Limit"/>, or 0 if the
+		/// budget is full or overcommitted.
+		/// </summary>
+		property __int64 Available
+		{
+			__int64 get(void);
+		}
+
+		/// <summary>
+		/// Get the number of open sockets holding a reservation.
+		/// </summary>
+		property int SocketCount
+		{
+			int get(void);
+		}
+
+		/// <summary>
+		/// Get the number of times a socket's buffers were shrunk to fit.
+		/// </summary>
+		property __int64 ThrottledCount
+		{
+			__int64 get(void);
+		}
+
+		/// <summary>
+		/// Get the number of connects and accepts refused because the
+		/// budget was full.
+		/// </summary>
+		property __int64 RejectedCount
+		{
+			__int64 get(void);
+		}
+	};
+}
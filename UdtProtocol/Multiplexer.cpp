@@ -0,0 +1,384 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "Multiplexer.h"
+
+#include "Socket.h"
+#include "SocketException.h"
+#include "TotalTraceInfo.h"
+
+#include <udt.h>
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Net;
+using namespace System::Threading;
+using namespace Udt;
+
+Multiplexer::Multiplexer(IPEndPoint^ localEP)
+{
+	if (localEP == nullptr)
+		throw gcnew ArgumentNullException("localEP");
+
+	_endPoint = localEP;
+	_receiveWorkerCount = 1;
+	_anchor = gcnew Udt::Socket(localEP->AddressFamily, System::Net::Sockets::SocketType::Stream);
+	_anchor->ReuseAddress = true;
+}
+
+Multiplexer::Multiplexer(System::Net::Sockets::Socket^ udpSocket)
+{
+	if (udpSocket == nullptr)
+		throw gcnew ArgumentNullException("udpSocket");
+
+	if (udpSocket->ProtocolType != System::Net::Sockets::ProtocolType::Udp)
+		throw gcnew ArgumentException(String::Concat("Socket must be a UDP Socket. Socket is ", udpSocket->ProtocolType), "udpSocket");
+
+	_udpSocket = udpSocket;
+	_receiveWorkerCount = 1;
+	_anchor = gcnew Udt::Socket(udpSocket->AddressFamily, System::Net::Sockets::SocketType::Stream);
+	_anchor->ReuseAddress = true;
+}
+
+Multiplexer::~Multiplexer(void)
+{
+	if (_workers == nullptr)
+	{
+		_anchor->Close();
+		return;
+	}
+
+	for each (Udt::Socket^ worker in _workers)
+	{
+		if (worker != nullptr)
+			worker->Close();
+	}
+}
+
+void Multiplexer::AssertNotDisposed(void)
+{
+	if (_anchor->IsDisposed)
+		throw gcnew ObjectDisposedException(this->ToString());
+}
+
+void Multiplexer::AssertNotOpen(void)
+{
+	AssertNotDisposed();
+
+	if (_isOpen)
+		throw gcnew InvalidOperationException("Value can not be changed once the multiplexer is open.");
+}
+
+void Multiplexer::AssertWorker(int worker)
+{
+	if (worker < 0 || worker >= _receiveWorkerCount)
+		throw gcnew ArgumentOutOfRangeException("worker", worker, String::Concat("Value must be between 0 and ", (Object^)(_receiveWorkerCount - 1), "."));
+}
+
+void Multiplexer::Open(void)
+{
+	AssertNotDisposed();
+
+	if (_isOpen)
+		return;
+
+	Monitor::Enter(_anchor);
+	try
+	{
+		if (!_isOpen)
+			OpenWorkers();
+	}
+	finally
+	{
+		Monitor::Exit(_anchor);
+	}
+}
+
+void Multiplexer::OpenWorkers(void)
+{
+	cli::array<Udt::Socket^>^ workers = gcnew cli::array<Udt::Socket^>(_receiveWorkerCount);
+	workers[0] = _anchor;
+
+	try
+	{
+		if (_udpSocket != nullptr)
+			_anchor->Bind(_udpSocket);
+		else
+			_anchor->Bind(_endPoint);
+
+		// Each extra worker is a separate UDP port, and so a separate UDT
+		// multiplexer with its own receive thread
+		for (int i = 1; i < workers->Length; i++)
+		{
+			workers[i] = gcnew Udt::Socket(_anchor->AddressFamily, System::Net::Sockets::SocketType::Stream);
+			workers[i]->ReuseAddress = true;
+			workers[i]->MaxPacketSize = _anchor->MaxPacketSize;
+			workers[i]->UdpSendBufferSize = _anchor->UdpSendBufferSize;
+			workers[i]->UdpReceiveBufferSize = _anchor->UdpReceiveBufferSize;
+			workers[i]->Bind(_endPoint->Address, 0);
+		}
+	}
+	catch (Exception^)
+	{
+		for (int i = 1; i < workers->Length; i++)
+		{
+			if (workers[i] != nullptr)
+				workers[i]->Close();
+		}
+
+		throw;
+	}
+
+	_sockets = gcnew cli::array<List<Udt::Socket^>^>(workers->Length);
+
+	for (int i = 0; i < _sockets->Length; i++)
+		_sockets[i] = gcnew List<Udt::Socket^>();
+
+	_workers = workers;
+	_isOpen = true;
+}
+
+void Multiplexer::Attach(Udt::Socket^ socket)
+{
+	if (socket == nullptr)
+		throw gcnew ArgumentNullException("socket");
+
+	AssertNotDisposed();
+	Open();
+
+	int worker = 0;
+
+	Monitor::Enter(_sockets);
+	try
+	{
+		PruneSockets();
+
+		for (int i = 1; i < _sockets->Length; i++)
+		{
+			if (_sockets[i]->Count < _sockets[worker]->Count)
+				worker = i;
+		}
+	}
+	finally
+	{
+		Monitor::Exit(_sockets);
+	}
+
+	Attach(socket, worker);
+}
+
+void Multiplexer::Attach(Udt::Socket^ socket, int worker)
+{
+	if (socket == nullptr)
+		throw gcnew ArgumentNullException("socket");
+
+	AssertWorker(worker);
+	AssertNotDisposed();
+
+	if (socket->AddressFamily != _anchor->AddressFamily)
+		throw gcnew ArgumentException(String::Concat("Value must be same as multiplexer address family (", _anchor->AddressFamily, ")."), "socket");
+
+	if (socket->State != Udt::SocketState::Initial)
+		throw gcnew ArgumentException("Socket is already bound.", "socket");
+
+	Open();
+
+	// UDT only shares a multiplexer between sockets bound to the same port
+	// with the same MSS and address reuse enabled
+	socket->MaxPacketSize = _anchor->MaxPacketSize;
+	socket->ReuseAddress = true;
+	socket->Bind(_workers[worker]->LocalEndPoint);
+
+	Monitor::Enter(_sockets);
+	try
+	{
+		_sockets[worker]->Add(socket);
+	}
+	finally
+	{
+		Monitor::Exit(_sockets);
+	}
+}
+
+IPEndPoint^ Multiplexer::GetWorkerEndPoint(int worker)
+{
+	AssertWorker(worker);
+	Open();
+
+	return _workers[worker]->LocalEndPoint;
+}
+
+int Multiplexer::PruneSockets(void)
+{
+	int count = 0;
+
+	for each (List<Udt::Socket^>^ sockets in _sockets)
+	{
+		for (int i = sockets->Count - 1; i >= 0; i--)
+		{
+			if (sockets[i]->IsDisposed)
+				sockets->RemoveAt(i);
+		}
+
+		count += sockets->Count;
+	}
+
+	return count;
+}
+
+TotalTraceInfo^ Multiplexer::GetPerformanceInfo(void)
+{
+	AssertNotDisposed();
+
+	UDT::TRACEINFO total;
+	memset(&total, 0, sizeof(total));
+
+	UDT::TRACEINFO info;
+
+	if (UDT::ERROR != UDT::perfmon(_anchor->Handle, &info, false))
+		total.msTimeStamp = info.msTimeStamp;
+
+	if (!_isOpen)
+		return gcnew TotalTraceInfo(total);
+
+	Monitor::Enter(_sockets);
+	try
+	{
+		PruneSockets();
+
+		for each (List<Udt::Socket^>^ sockets in _sockets)
+		{
+			for each (Udt::Socket^ socket in sockets)
+			{
+				// Closed since the prune, skip it
+				if (UDT::ERROR == UDT::perfmon(socket->Handle, &info, false))
+					continue;
+
+				total.pktSentTotal += info.pktSentTotal;
+				total.pktRecvTotal += info.pktRecvTotal;
+				total.pktSndLossTotal += info.pktSndLossTotal;
+				total.pktRcvLossTotal += info.pktRcvLossTotal;
+				total.pktRetransTotal += info.pktRetransTotal;
+				total.pktSentACKTotal += info.pktSentACKTotal;
+				total.pktRecvACKTotal += info.pktRecvACKTotal;
+				total.pktSentNAKTotal += info.pktSentNAKTotal;
+				total.pktRecvNAKTotal += info.pktRecvNAKTotal;
+				total.usSndDurationTotal += info.usSndDurationTotal;
+			}
+		}
+	}
+	finally
+	{
+		Monitor::Exit(_sockets);
+	}
+
+	return gcnew TotalTraceInfo(total);
+}
+
+IPEndPoint^ Multiplexer::LocalEndPoint::get(void)
+{
+	if (_isOpen)
+		return _anchor->LocalEndPoint;
+
+	if (_udpSocket != nullptr)
+		return (IPEndPoint^)_udpSocket->LocalEndPoint;
+
+	return _endPoint;
+}
+
+System::Net::Sockets::AddressFamily Multiplexer::AddressFamily::get(void)
+{
+	return _anchor->AddressFamily;
+}
+
+int Multiplexer::SocketCount::get(void)
+{
+	if (!_isOpen)
+		return 0;
+
+	Monitor::Enter(_sockets);
+	try
+	{
+		return PruneSockets();
+	}
+	finally
+	{
+		Monitor::Exit(_sockets);
+	}
+}
+
+void Multiplexer::ReceiveWorkerCount::set(int value)
+{
+	if (value < 1)
+		throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than 0.");
+
+	AssertNotOpen();
+
+	if (_udpSocket != nullptr && value != 1)
+		throw gcnew InvalidOperationException("Value must be 1 when the multiplexer uses an existing UDP socket.");
+
+	_receiveWorkerCount = value;
+}
+
+int Multiplexer::MaxPacketSize::get(void)
+{
+	return _anchor->MaxPacketSize;
+}
+
+void Multiplexer::MaxPacketSize::set(int value)
+{
+	AssertNotOpen();
+	_anchor->MaxPacketSize = value;
+}
+
+int Multiplexer::UdpSendBufferSize::get(void)
+{
+	return _anchor->UdpSendBufferSize;
+}
+
+void Multiplexer::UdpSendBufferSize::set(int value)
+{
+	AssertNotOpen();
+	_anchor->UdpSendBufferSize = value;
+}
+
+int Multiplexer::UdpReceiveBufferSize::get(void)
+{
+	return _anchor->UdpReceiveBufferSize;
+}
+
+void Multiplexer::UdpReceiveBufferSize::set(int value)
+{
+	AssertNotOpen();
+	_anchor->UdpReceiveBufferSize = value;
+}
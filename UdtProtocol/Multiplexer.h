@@ -0,0 +1,276 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	ref class Socket;
+	ref class TotalTraceInfo;
+
+	/// <summary>
+	/// Shares one bound UDP end point between many UDT sockets.
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// UDT runs every socket bound to the same UDP port, with the same
+	/// maximum packet size and address reuse enabled, over a single
+	/// multiplexer (one UDP socket, one send and one receive thread).
+	/// This class owns that UDP end point and attaches sockets to it, e.g.
+	/// so a listener and outgoing rendezvous connections can all use the
+	/// one public port a NAT mapping was created for.
+	/// </para>
+	/// <para>
+	/// The UDP end point is opened by the first call to <see cref="Attach"/>
+	/// or <see cref="Open"/>. The tuning properties can only be changed
+	/// before that.
+	/// </para>
+	/// <para>
+	/// Attached sockets keep the UDP end point alive; disposing the
+	/// multiplexer does not affect them.
+	/// </para>
+	/// <para>
+	/// A single UDT receive thread handles all traffic on a UDP port. Set
+	/// <see cref="ReceiveWorkerCount"/> above 1 to spread attached sockets
+	/// over several UDP ports on the same address, each with its own
+	/// receive thread. Worker 0 uses <see cref="LocalEndPoint"/>. The other
+	/// workers use ephemeral ports (see <see cref="GetWorkerEndPoint"/>),
+	/// since Windows does not distribute datagrams for a single port between
+	/// sockets. To spread incoming connections, attach one listening socket
+	/// per worker and give peers the worker end points.
+	/// </para>
+	/// </remarks>
+	public ref class Multiplexer
+	{
+	private:
+		Udt::Socket^ _anchor;
+		System::Net::IPEndPoint^ _endPoint;
+		System::Net::Sockets::Socket^ _udpSocket;
+		int _receiveWorkerCount;
+		cli::array<Udt::Socket^>^ _workers;
+		cli::array<System::Collections::Generic::List<Udt::Socket^>^>^ _sockets;
+		volatile bool _isOpen;
+
+		void AssertNotDisposed(void);
+		void AssertNotOpen(void);
+		void AssertWorker(int worker);
+		void OpenWorkers(void);
+		int PruneSockets(void);
+
+	public:
+
+		/// <summary>
+		/// Initialize a new instance that will bind to the specified local end point.
+		/// </summary>
+		/// <param name="localEP">Local end point. Port 0 selects an ephemeral port.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="localEP"/> is a null reference.</exception>
+		/// <exception cref="Udt::SocketException">If an error occurs creating the socket.</exception>
+		Multiplexer(System::Net::IPEndPoint^ localEP);
+
+		/// <summary>
+		/// Initialize a new instance that will use an existing UDP socket.
+		/// </summary>
+		/// <remarks>
+		/// Ownership of <paramref name="udpSocket"/> passes to UDT when the
+		/// multiplexer is opened, see <see cref="Udt::Socket::Bind(System::Net::Sockets::Socket^)"/>.
+		/// </remarks>
+		/// <param name="udpSocket">Bound UDP socket.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="udpSocket"/> is a null reference.</exception>
+		/// <exception cref="System::ArgumentException">If <paramref name="udpSocket"/> is not a UDP socket.</exception>
+		/// <exception cref="Udt::SocketException">If an error occurs creating the socket.</exception>
+		Multiplexer(System::Net::Sockets::Socket^ udpSocket);
+
+		/// <summary>
+		/// Release the multiplexer's reference to the UDP end point.
+		/// </summary>
+		~Multiplexer(void);
+
+		/// <summary>
+		/// Open the UDP end point.
+		/// </summary>
+		/// <remarks>
+		/// Does nothing if the multiplexer is already open.
+		/// </remarks>
+		/// <exception cref="Udt::SocketException">If an error occurs binding.</exception>
+		/// <exception cref="System::ObjectDisposedException">If the multiplexer has been disposed.</exception>
+		void Open(void);
+
+		/// <summary>
+		/// Bind an unbound socket to the multiplexer's UDP end point.
+		/// </summary>
+		/// <remarks>
+		/// The socket's <see cref="Udt::Socket::MaxPacketSize"/> and
+		/// <see cref="Udt::Socket::ReuseAddress"/> are changed to match the
+		/// multiplexer. It can then be used to listen or connect as normal.
+		/// </remarks>
+		/// <param name="socket">Socket to attach.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="socket"/> is a null reference.</exception>
+		/// <exception cref="System::ArgumentException">
+		/// If <paramref name="socket"/> is not the same address family as the multiplexer<br/>
+		/// <b>- or -</b><br/>
+		/// <paramref name="socket"/> is already bound.
+		/// </exception>
+		/// <exception cref="Udt::SocketException">If an error occurs binding.</exception>
+		/// <exception cref="System::ObjectDisposedException">If the multiplexer has been disposed.</exception>
+		void Attach(Udt::Socket^ socket);
+
+		/// <summary>
+		/// Bind an unbound socket to the UDP end point of a specific receive worker.
+		/// </summary>
+		/// <remarks>
+		/// <see cref="Attach(Udt::Socket^)"/> picks the worker with the fewest
+		/// open sockets. Use this overload to steer a socket explicitly, e.g.
+		/// to place one listener on each worker.
+		/// </remarks>
+		/// <param name="socket">Socket to attach.</param>
+		/// <param name="worker">Index of the receive worker.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="socket"/> is a null reference.</exception>
+		/// <exception cref="System::ArgumentException">
+		/// If <paramref name="socket"/> is not the same address family as the multiplexer<br/>
+		/// <b>- or -</b><br/>
+		/// <paramref name="socket"/> is already bound.
+		/// </exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">
+		/// If <paramref name="worker"/> is less than 0 or not less than <see cref="ReceiveWorkerCount"/>.
+		/// </exception>
+		/// <exception cref="Udt::SocketException">If an error occurs binding.</exception>
+		/// <exception cref="System::ObjectDisposedException">If the multiplexer has been disposed.</exception>
+		void Attach(Udt::Socket^ socket, int worker);
+
+		/// <summary>
+		/// Get the UDP end point of a receive worker.
+		/// </summary>
+		/// <param name="worker">Index of the receive worker.</param>
+		/// <returns>Bound end point of the worker.</returns>
+		/// <exception cref="System::ArgumentOutOfRangeException">
+		/// If <paramref name="worker"/> is less than 0 or not less than <see cref="ReceiveWorkerCount"/>.
+		/// </exception>
+		/// <exception cref="Udt::SocketException">If an error occurs opening the multiplexer.</exception>
+		/// <exception cref="System::ObjectDisposedException">If the multiplexer has been disposed.</exception>
+		System::Net::IPEndPoint^ GetWorkerEndPoint(int worker);
+
+		/// <summary>
+		/// Get performance totals summed over all open attached sockets.
+		/// </summary>
+		/// <remarks>
+		/// Sockets that have been closed no longer contribute.
+		/// <see cref="Udt::TotalTraceInfo::SocketCreated"/> is the age of the multiplexer.
+		/// </remarks>
+		/// <exception cref="System::ObjectDisposedException">If the multiplexer has been disposed.</exception>
+		Udt::TotalTraceInfo^ GetPerformanceInfo(void);
+
+		/// <summary>
+		/// Get the local end point of worker 0, which is the actual bound end point once open.
+		/// </summary>
+		[System::Diagnostics::CodeAnalysis::SuppressMessageAttribute(
+			"Microsoft.Naming",
+			"CA1702:CompoundWordsShouldBeCasedCorrectly",
+			Justification = "EndPoint is the casing used in IPEndPoint")]
+		property System::Net::IPEndPoint^ LocalEndPoint
+		{
+			System::Net::IPEndPoint^ get(void);
+		}
+
+		/// <summary>
+		/// Get the address family of the UDP end point.
+		/// </summary>
+		property System::Net::Sockets::AddressFamily AddressFamily
+		{
+			System::Net::Sockets::AddressFamily get(void);
+		}
+
+		/// <summary>
+		/// Get if the UDP end point has been opened.
+		/// </summary>
+		property bool IsOpen
+		{
+			bool get(void) { return _isOpen; }
+		}
+
+		/// <summary>
+		/// Get the number of attached sockets that are still open.
+		/// </summary>
+		property int SocketCount
+		{
+			int get(void);
+		}
+
+		/// <summary>
+		/// Get or set the number of UDP ports, each with its own UDT receive
+		/// thread, that attached sockets are spread over.
+		/// </summary>
+		/// <remarks>
+		/// Defaults to 1. Must be 1 when the multiplexer uses an existing UDP socket.
+		/// </remarks>
+		/// <exception cref="System::ArgumentOutOfRangeException">If set to less than 1.</exception>
+		/// <exception cref="System::InvalidOperationException">
+		/// If set once the multiplexer is open<br/>
+		/// <b>- or -</b><br/>
+		/// the multiplexer uses an existing UDP socket and the value is not 1.
+		/// </exception>
+		property int ReceiveWorkerCount
+		{
+			int get(void) { return _receiveWorkerCount; }
+			void set(int value);
+		}
+
+		/// <summary>
+		/// Get or set the maximum packet size used by every attached socket.
+		/// </summary>
+		/// <exception cref="System::InvalidOperationException">If set once the multiplexer is open.</exception>
+		property int MaxPacketSize
+		{
+			int get(void);
+			void set(int value);
+		}
+
+		/// <summary>
+		/// Get or set the UDP socket send buffer size.
+		/// </summary>
+		/// <exception cref="System::InvalidOperationException">If set once the multiplexer is open.</exception>
+		property int UdpSendBufferSize
+		{
+			int get(void);
+			void set(int value);
+		}
+
+		/// <summary>
+		/// Get or set the UDP socket receive buffer size.
+		/// </summary>
+		/// <exception cref="System::InvalidOperationException">If set once the multiplexer is open.</exception>
+		property int UdpReceiveBufferSize
+		{
+			int get(void);
+			void set(int value);
+		}
+	};
+}
@@ -0,0 +1,134 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "NativeCongestionControlFactory.h"
+
+#include <udt.h>
+#include <ccc.h>
+
+#include <vcclr.h>
+
+using namespace Udt;
+using namespace System;
+
+namespace
+{
+	typedef CCCVirtualFactory* (__cdecl *CreateFactoryProc)(void);
+}
+
+#pragma managed(push, off)
+
+// UDT's own algorithm behind the plug-in interface, see BuiltInEntryPoint
+extern "C" __declspec(dllexport) CCCVirtualFactory* __cdecl CreateUdtCongestionControlFactory(void)
+{
+	return new CCCFactory<CUDTCC>;
+}
+
+#pragma managed(pop)
+
+NativeCongestionControlFactory::NativeCongestionControlFactory(String^ path)
+	: _factory(NULL), _isDisposed(false)
+{
+	Load(path, DefaultEntryPoint);
+}
+
+NativeCongestionControlFactory::NativeCongestionControlFactory(String^ path, String^ entryPoint)
+	: _factory(NULL), _isDisposed(false)
+{
+	Load(path, entryPoint);
+}
+
+NativeCongestionControlFactory::~NativeCongestionControlFactory(void)
+{
+	if (_isDisposed)
+		return;
+
+	this->!NativeCongestionControlFactory();
+	_isDisposed = true;
+}
+
+NativeCongestionControlFactory::!NativeCongestionControlFactory(void)
+{
+	// Sockets hold their own clones
+	delete _factory;
+	_factory = NULL;
+}
+
+void NativeCongestionControlFactory::Load(String^ path, String^ entryPoint)
+{
+	if (path == nullptr) throw gcnew ArgumentNullException("path");
+	if (entryPoint == nullptr) throw gcnew ArgumentNullException("entryPoint");
+
+	HMODULE module;
+
+	{
+		pin_ptr<const wchar_t> pathChars = PtrToStringChars(path);
+		module = LoadLibraryW(pathChars);
+	}
+
+	if (module == NULL)
+		throw gcnew DllNotFoundException(String::Concat("Unable to load congestion control library '", path, "'."), gcnew ComponentModel::Win32Exception());
+
+	// Plug-in code may outlive this object inside socket clones. The pin
+	// replaces the LoadLibrary reference; without it that reference is
+	// kept instead, so the module is never unloaded either way.
+	HMODULE pinned;
+
+	if (GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_PIN, (LPCWSTR)module, &pinned))
+		FreeLibrary(module);
+
+	IntPtr name = Runtime::InteropServices::Marshal::StringToHGlobalAnsi(entryPoint);
+	CreateFactoryProc create = (CreateFactoryProc)GetProcAddress(module, (LPCSTR)name.ToPointer());
+	Runtime::InteropServices::Marshal::FreeHGlobal(name);
+
+	if (create == NULL)
+		throw gcnew EntryPointNotFoundException(String::Concat("Unable to find entry point '", entryPoint, "' in congestion control library '", path, "'."));
+
+	_factory = create();
+
+	if (_factory == NULL)
+		throw gcnew InvalidOperationException(String::Concat("Entry point '", entryPoint, "' in congestion control library '", path, "' returned null."));
+
+	_path = path;
+}
+
+CCCVirtualFactory* NativeCongestionControlFactory::Factory::get(void)
+{
+	if (_isDisposed) throw gcnew ObjectDisposedException(ToString());
+	return _factory;
+}
+
+CongestionControl^ NativeCongestionControlFactory::CreateCongestionControl(void)
+{
+	throw gcnew NotSupportedException("Native congestion control plug-ins do not create managed congestion control objects.");
+}
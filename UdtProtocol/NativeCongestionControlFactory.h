@@ -0,0 +1,140 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+#include "ICongestionControlFactory.h"
+
+class CCCVirtualFactory;
+
+namespace Udt
+{
+	/// <summary>
+	/// Congestion control factory implemented by a native plug-in library.
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// The library must export a C entry point that takes no arguments and
+	/// returns a new <c>CCCVirtualFactory*</c>:
+	/// <code>
+	/// extern "C" __declspec(dllexport) CCCVirtualFactory* CreateCongestionControlFactory(void)
+	/// {
+	///     return new CCCFactory&lt;MyCC&gt;;
+	/// }
+	/// </code>
+	/// Assign the factory to <see cref="Socket::CongestionControl"/> and
+	/// UDT calls the plug-in's <c>CCC</c> directly, without entering the
+	/// CLR. The plug-in must be built against the same UDT headers and
+	/// C++ runtime as this assembly, since <c>CCC</c> objects cross the
+	/// library boundary by their C++ layout.
+	/// </para>
+	/// <para>
+	/// A library stays loaded for the life of the process once loaded,
+	/// because sockets may still hold its objects after the factory is
+	/// disposed. <see cref="Socket::PacketCapture"/> does not record
+	/// congestion control events for native plug-ins.
+	/// </para>
+	/// </remarks>
+	public ref class NativeCongestionControlFactory : public ICongestionControlFactory, public System::IDisposable
+	{
+	private:
+		CCCVirtualFactory* _factory;
+		System::String^ _path;
+		bool _isDisposed;
+
+		void Load(System::String^ path, System::String^ entryPoint);
+
+	internal:
+		property CCCVirtualFactory* Factory { CCCVirtualFactory* get(void); }
+
+	public:
+
+		/// <summary>
+		/// Name of the entry point resolved when none is specified.
+		/// </summary>
+		literal System::String^ DefaultEntryPoint = "CreateCongestionControlFactory";
+
+		/// <summary>
+		/// Entry point exported by this assembly that creates UDT's own
+		/// congestion control, to run it where a plug-in is expected, such
+		/// as in <see cref="CongestionControlSimulator"/>.
+		/// </summary>
+		literal System::String^ BuiltInEntryPoint = "CreateUdtCongestionControlFactory";
+
+		/// <summary>
+		/// Initialize a new instance using the library's
+		/// <see cref="DefaultEntryPoint"/>.
+		/// </summary>
+		/// <param name="path">Path of the library to load.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="path"/> is null.</exception>
+		/// <exception cref="System::DllNotFoundException">If the library could not be loaded.</exception>
+		/// <exception cref="System::EntryPointNotFoundException">If the library does not export <see cref="DefaultEntryPoint"/>.</exception>
+		/// <exception cref="System::InvalidOperationException">If the entry point returned null.</exception>
+		NativeCongestionControlFactory(System::String^ path);
+
+		/// <summary>
+		/// Initialize a new instance using a named entry point.
+		/// </summary>
+		/// <param name="path">Path of the library to load.</param>
+		/// <param name="entryPoint">Exported function that creates the factory.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="path"/> or <paramref name="entryPoint"/> is null.</exception>
+		/// <exception cref="System::DllNotFoundException">If the library could not be loaded.</exception>
+		/// <exception cref="System::EntryPointNotFoundException">If the library does not export <paramref name="entryPoint"/>.</exception>
+		/// <exception cref="System::InvalidOperationException">If the entry point returned null.</exception>
+		NativeCongestionControlFactory(System::String^ path, System::String^ entryPoint);
+
+		virtual ~NativeCongestionControlFactory(void);
+		!NativeCongestionControlFactory(void);
+
+		/// <summary>
+		/// Always throws; native congestion control has no managed object.
+		/// </summary>
+		/// <exception cref="System::NotSupportedException">Always.</exception>
+		virtual CongestionControl^ CreateCongestionControl(void);
+
+		/// <summary>
+		/// Get the path of the loaded library.
+		/// </summary>
+		property System::String^ Path
+		{
+			System::String^ get(void) { return _path; }
+		}
+
+		/// <summary>
+		/// Get true if the factory has been disposed.
+		/// </summary>
+		property bool IsDisposed
+		{
+			bool get(void) { return _isDisposed; }
+		}
+	};
+}
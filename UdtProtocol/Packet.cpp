@@ -40,9 +40,11 @@
 #include "CongestionPacket.h"
 #include "ErrorPacket.h"
 #include "Ack2Packet.h"
+#include "PacketBufferPool.h"
 
 #include <udt.h>
 #include <packet.h>
+#include <new>
 
 using namespace Udt;
 using namespace System;
@@ -89,8 +91,15 @@ Packet^ Packet::Wrap(const CPacket* packet)
 }
 
 Packet::Packet()
-	: _packet(new CPacket()), _deletePacket(true)
+	: _deletePacket(true)
 {
+	int capacity;
+	void* memory = PacketBufferPool::Allocate(sizeof(CPacket), capacity);
+
+	if (memory == NULL)
+		throw gcnew OutOfMemoryException();
+
+	_packet = new(memory) CPacket();
 }
 
 Packet::Packet(const CPacket* packet)
@@ -103,7 +112,8 @@ Packet::~Packet()
 	if (_deletePacket)
 	{
 		FreePacketData();
-		delete _packet;
+		_packet->~CPacket();
+		PacketBufferPool::Free(_packet);
 	}
 
 	_packet = NULL;
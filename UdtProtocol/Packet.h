@@ -55,6 +55,10 @@ namespace Udt
 
 		static Packet^ Wrap(const CPacket* packet);
 
+		property CPacket* NativePacket {
+			CPacket* get(void) { return _packet; }
+		}
+
 		Packet(void);
 		Packet(const CPacket* packet);
 
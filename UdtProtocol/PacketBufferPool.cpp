@@ -0,0 +1,223 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "PacketBufferPool.h"
+
+#include <udt.h>
+#include <malloc.h>
+#include <new>
+
+using namespace Udt;
+
+#pragma managed(push, off)
+
+namespace
+{
+	const int SizeClasses[] = { 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 65536 };
+	const int SizeClassCount = sizeof(SizeClasses) / sizeof(SizeClasses[0]);
+	const int Unpooled = -1;
+
+	// Free blocks a thread keeps per class before returning half
+	const int ThreadCacheLimit = 64;
+
+	/// <summary>
+	/// Precedes every block; links the block while it is free.
+	/// </summary>
+	union DECLSPEC_ALIGN(MEMORY_ALLOCATION_ALIGNMENT) BlockHeader
+	{
+		SLIST_ENTRY entry;
+		int sizeClass;
+	};
+
+	struct ThreadCache
+	{
+		PSLIST_ENTRY heads[SizeClassCount];
+		int counts[SizeClassCount];
+	};
+
+	// Zero filled is an empty list, so no dynamic initialization is needed
+	SLIST_HEADER g_shared[SizeClassCount];
+	volatile LONG g_cacheIndex = (LONG)FLS_OUT_OF_INDEXES;
+
+	void WINAPI FlushThreadCache(PVOID value)
+	{
+		ThreadCache* cache = (ThreadCache*)value;
+
+		if (cache == NULL)
+			return;
+
+		for (int i = 0; i < SizeClassCount; ++i)
+		{
+			while (cache->heads[i] != NULL)
+			{
+				PSLIST_ENTRY entry = cache->heads[i];
+				cache->heads[i] = entry->Next;
+				InterlockedPushEntrySList(&g_shared[i], entry);
+			}
+		}
+
+		delete cache;
+	}
+
+	ThreadCache* GetThreadCache(void)
+	{
+		DWORD index = (DWORD)g_cacheIndex;
+
+		if (index == FLS_OUT_OF_INDEXES)
+		{
+			DWORD allocated = FlsAlloc(FlushThreadCache);
+
+			if (allocated == FLS_OUT_OF_INDEXES)
+				return NULL;
+
+			index = (DWORD)InterlockedCompareExchange(&g_cacheIndex, (LONG)allocated, (LONG)FLS_OUT_OF_INDEXES);
+
+			if (index == FLS_OUT_OF_INDEXES)
+				index = allocated;
+			else
+				FlsFree(allocated);
+		}
+
+		ThreadCache* cache = (ThreadCache*)FlsGetValue(index);
+
+		if (cache == NULL)
+		{
+			cache = new(std::nothrow) ThreadCache();
+
+			if (cache != NULL && !FlsSetValue(index, cache))
+			{
+				delete cache;
+				cache = NULL;
+			}
+		}
+
+		return cache;
+	}
+
+	int GetSizeClass(int size)
+	{
+		for (int i = 0; i < SizeClassCount; ++i)
+		{
+			if (size <= SizeClasses[i])
+				return i;
+		}
+
+		return Unpooled;
+	}
+}
+
+char* PacketBufferPool::Allocate(int size, int& capacity)
+{
+	int sizeClass = GetSizeClass(size);
+	BlockHeader* block = NULL;
+
+	if (sizeClass == Unpooled)
+	{
+		capacity = size;
+	}
+	else
+	{
+		capacity = SizeClasses[sizeClass];
+		ThreadCache* cache = GetThreadCache();
+
+		if (cache != NULL && cache->heads[sizeClass] != NULL)
+		{
+			block = (BlockHeader*)cache->heads[sizeClass];
+			cache->heads[sizeClass] = block->entry.Next;
+			--cache->counts[sizeClass];
+		}
+		else
+		{
+			block = (BlockHeader*)InterlockedPopEntrySList(&g_shared[sizeClass]);
+		}
+	}
+
+	if (block == NULL)
+	{
+		block = (BlockHeader*)_aligned_malloc(sizeof(BlockHeader) + capacity, MEMORY_ALLOCATION_ALIGNMENT);
+
+		if (block == NULL)
+			return NULL;
+	}
+
+	block->sizeClass = sizeClass;
+	return (char*)(block + 1);
+}
+
+void PacketBufferPool::Free(void* buffer)
+{
+	if (buffer == NULL)
+		return;
+
+	BlockHeader* block = (BlockHeader*)buffer - 1;
+	int sizeClass = block->sizeClass;
+
+	if (sizeClass == Unpooled)
+	{
+		_aligned_free(block);
+		return;
+	}
+
+	ThreadCache* cache = GetThreadCache();
+
+	if (cache == NULL)
+	{
+		InterlockedPushEntrySList(&g_shared[sizeClass], &block->entry);
+		return;
+	}
+
+	block->entry.Next = cache->heads[sizeClass];
+	cache->heads[sizeClass] = &block->entry;
+
+	if (++cache->counts[sizeClass] > ThreadCacheLimit)
+	{
+		// Keep the most recently used half, which is still warm in cache
+		PSLIST_ENTRY keep = cache->heads[sizeClass];
+
+		for (int i = 1; i < ThreadCacheLimit / 2; ++i)
+			keep = keep->Next;
+
+		PSLIST_ENTRY release = keep->Next;
+		keep->Next = NULL;
+		cache->counts[sizeClass] = ThreadCacheLimit / 2;
+
+		while (release != NULL)
+		{
+			PSLIST_ENTRY next = release->Next;
+			InterlockedPushEntrySList(&g_shared[sizeClass], release);
+			release = next;
+		}
+	}
+}
+
+#pragma managed(pop)
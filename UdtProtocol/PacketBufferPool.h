@@ -0,0 +1,69 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	/// <summary>
+	/// Size-class pool for native packet memory.
+	/// </summary>
+	/// <remarks>
+	/// Blocks are rounded up to a size class (the largest common one holds
+	/// a full 1500 byte MSS payload) and recycled instead of returned to
+	/// the CRT heap. Each thread keeps a small cache per class, overflowing
+	/// into a lock-free list shared by all threads, so steady state packet
+	/// creation and disposal touch neither the global allocator nor a lock.
+	/// Blocks larger than the biggest class are allocated directly.
+	/// </remarks>
+	class PacketBufferPool
+	{
+	private:
+		PacketBufferPool(void);
+
+	public:
+
+		/// <summary>
+		/// Allocate a block of at least <paramref name="size"/> bytes.
+		/// </summary>
+		/// <param name="size">Minimum block size.</param>
+		/// <param name="capacity">Receives the usable size of the block.</param>
+		/// <returns>The block, or NULL if memory is exhausted.</returns>
+		static char* Allocate(int size, int& capacity);
+
+		/// <summary>
+		/// Return a block from <see cref="Allocate"/> to the pool.
+		/// </summary>
+		/// <param name="buffer">Block to free; may be NULL.</param>
+		static void Free(void* buffer);
+	};
+}
@@ -0,0 +1,427 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "PacketCapture.h"
+
+#include "PacketCaptureRing.h"
+#include "Socket.h"
+
+#include <udt.h>
+
+using namespace Udt;
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Globalization;
+using namespace System::IO;
+using namespace System::Net;
+using namespace System::Text;
+using namespace System::Threading;
+
+namespace
+{
+	// pcapng block types and options
+	const unsigned int SectionHeaderBlock = 0x0A0D0D0A;
+	const unsigned int InterfaceDescriptionBlock = 1;
+	const unsigned int EnhancedPacketBlock = 6;
+	const unsigned int ByteOrderMagic = 0x1A2B3C4D;
+	const int OptionComment = 1;
+	const int OptionInterfaceName = 2;
+	const int OptionTimestampResolution = 9;
+	const int OptionPacketFlags = 2;
+
+	// Raw IPv4/IPv6 packets
+	const int LinkTypeRaw = 101;
+
+	int Pad4(int length)
+	{
+		return (length + 3) & ~3;
+	}
+
+	void WriteBigEndian16(cli::array<Byte>^ buffer, int offset, int value)
+	{
+		buffer[offset] = (Byte)(value >> 8);
+		buffer[offset + 1] = (Byte)value;
+	}
+
+	/// <summary>
+	/// Wrap a UDT packet in IP and UDP headers for the given end points.
+	/// </summary>
+	cli::array<Byte>^ BuildDatagram(IPEndPoint^ source, IPEndPoint^ destination, const unsigned char* udt, int length, int originalLength, int& originalDatagramLength)
+	{
+		bool ipv6 = source->AddressFamily == System::Net::Sockets::AddressFamily::InterNetworkV6;
+		int ipLength = ipv6 ? 40 : 20;
+		cli::array<Byte>^ datagram = gcnew cli::array<Byte>(ipLength + 8 + length);
+		cli::array<Byte>^ sourceBytes = source->Address->GetAddressBytes();
+		cli::array<Byte>^ destinationBytes = destination->Address->GetAddressBytes();
+
+		originalDatagramLength = ipLength + 8 + originalLength;
+		int udpLength = Math::Min(8 + originalLength, 0xFFFF);
+
+		if (ipv6)
+		{
+			datagram[0] = 0x60;
+			WriteBigEndian16(datagram, 4, udpLength);
+			datagram[6] = 17;
+			datagram[7] = 64;
+			Buffer::BlockCopy(sourceBytes, 0, datagram, 8, 16);
+			Buffer::BlockCopy(destinationBytes, 0, datagram, 24, 16);
+		}
+		else
+		{
+			datagram[0] = 0x45;
+			WriteBigEndian16(datagram, 2, Math::Min(originalDatagramLength, 0xFFFF));
+			datagram[8] = 64;
+			datagram[9] = 17;
+			Buffer::BlockCopy(sourceBytes, 0, datagram, 12, 4);
+			Buffer::BlockCopy(destinationBytes, 0, datagram, 16, 4);
+
+			unsigned int sum = 0;
+			for (int i = 0; i < 20; i += 2)
+				sum += (datagram[i] << 8) | datagram[i + 1];
+
+			while (sum > 0xFFFF)
+				sum = (sum & 0xFFFF) + (sum >> 16);
+
+			WriteBigEndian16(datagram, 10, ~sum & 0xFFFF);
+		}
+
+		// UDP checksum left 0, the payload may be truncated
+		WriteBigEndian16(datagram, ipLength, source->Port);
+		WriteBigEndian16(datagram, ipLength + 2, destination->Port);
+		WriteBigEndian16(datagram, ipLength + 4, udpLength);
+
+		for (int i = 0; i < length; ++i)
+			datagram[ipLength + 8 + i] = udt[i];
+
+		return datagram;
+	}
+}
+
+PacketCapture::PacketCapture(String^ path)
+{
+	if (path == nullptr)
+		throw gcnew ArgumentNullException("path");
+
+	Initialize(gcnew FileStream(path, FileMode::Create, FileAccess::Write, FileShare::Read), true, 0);
+}
+
+PacketCapture::PacketCapture(String^ path, int payloadPrefixLength)
+{
+	if (path == nullptr)
+		throw gcnew ArgumentNullException("path");
+
+	if (payloadPrefixLength < 0 || payloadPrefixLength > MaxPayloadPrefixLength)
+		throw gcnew ArgumentOutOfRangeException("payloadPrefixLength", payloadPrefixLength, String::Concat("Value must be between 0 and ", MaxPayloadPrefixLength, "."));
+
+	Initialize(gcnew FileStream(path, FileMode::Create, FileAccess::Write, FileShare::Read), true, payloadPrefixLength);
+}
+
+PacketCapture::PacketCapture(Stream^ stream, int payloadPrefixLength)
+{
+	if (stream == nullptr)
+		throw gcnew ArgumentNullException("stream");
+
+	if (!stream->CanWrite)
+		throw gcnew ArgumentException("Stream must be writable.", "stream");
+
+	if (payloadPrefixLength < 0 || payloadPrefixLength > MaxPayloadPrefixLength)
+		throw gcnew ArgumentOutOfRangeException("payloadPrefixLength", payloadPrefixLength, String::Concat("Value must be between 0 and ", MaxPayloadPrefixLength, "."));
+
+	Initialize(stream, false, payloadPrefixLength);
+}
+
+void PacketCapture::Initialize(Stream^ stream, bool ownsStream, int payloadPrefixLength)
+{
+	_stream = stream;
+	_ownsStream = ownsStream;
+	_payloadPrefixLength = payloadPrefixLength;
+	_writer = gcnew BinaryWriter(stream);
+	_endPoints = gcnew Dictionary<IntPtr, KeyValuePair<IPEndPoint^, IPEndPoint^> >();
+	_interfaces = gcnew Dictionary<IntPtr, int>();
+
+	// Records carry the raw performance counter, converted when written
+	_counterBase = System::Diagnostics::Stopwatch::GetTimestamp();
+	_counterFrequency = System::Diagnostics::Stopwatch::Frequency;
+	_timeBase = (DateTime::UtcNow - DateTime(1970, 1, 1, 0, 0, 0, DateTimeKind::Utc)).Ticks / 10;
+
+	WriteSectionHeader();
+
+	_ring = new PacketCaptureRing(DefaultRingCapacity, payloadPrefixLength);
+	_stop = gcnew ManualResetEvent(false);
+
+	_writerThread = gcnew Thread(gcnew ThreadStart(this, &PacketCapture::WriteLoop));
+	_writerThread->Name = "UDT packet capture";
+	_writerThread->IsBackground = true;
+	_writerThread->Start();
+}
+
+PacketCapture::~PacketCapture(void)
+{
+	Close();
+}
+
+PacketCapture::!PacketCapture(void)
+{
+	if (_ring != NULL)
+	{
+		_ring->Close();
+		_ring->Release();
+		_ring = NULL;
+	}
+}
+
+void PacketCapture::Close(void)
+{
+	if (_isDisposed)
+		return;
+
+	_isDisposed = true;
+	_ring->Close();
+	_stop->Set();
+	_writerThread->Join();
+
+	try
+	{
+		if (_writeError == nullptr)
+		{
+			Drain();
+			_writer->Flush();
+		}
+	}
+	finally
+	{
+		if (_ownsStream)
+			_stream->Close();
+
+		_stop->Close();
+		_ring->Release();
+		_ring = NULL;
+	}
+
+	if (_writeError != nullptr)
+		throw gcnew IOException("Error writing packet capture.", _writeError);
+}
+
+int PacketCapture::RecordsDropped::get(void)
+{
+	PacketCaptureRing* ring = _ring;
+	return ring == NULL ? 0 : ring->Dropped();
+}
+
+void PacketCapture::Register(Udt::Socket^ socket)
+{
+	CCC* cc = NULL;
+	int size = sizeof(CCC*);
+
+	if (UDT::ERROR == UDT::getsockopt(socket->Handle, 0, UDT_CC, &cc, &size) || cc == NULL)
+		return;
+
+	KeyValuePair<IPEndPoint^, IPEndPoint^> endPoints(socket->LocalEndPoint, socket->RemoteEndPoint);
+
+	Monitor::Enter(_endPoints);
+	try
+	{
+		_endPoints[IntPtr(cc)] = endPoints;
+	}
+	finally
+	{
+		Monitor::Exit(_endPoints);
+	}
+}
+
+void PacketCapture::WriteLoop(void)
+{
+	try
+	{
+		while (!_stop->WaitOne(WriterPollMilliseconds))
+			Drain();
+	}
+	catch (Exception^ ex)
+	{
+		_writeError = ex;
+		_ring->Close();
+	}
+}
+
+void PacketCapture::Drain(void)
+{
+	CaptureRecord record;
+	bool wrote = false;
+
+	while (_ring->TryDequeue(record))
+	{
+		WriteRecord(record);
+		wrote = true;
+	}
+
+	if (wrote)
+		_writer->Flush();
+}
+
+int PacketCapture::OptionLength(int valueLength)
+{
+	return 4 + Pad4(valueLength);
+}
+
+void PacketCapture::WriteOption(int code, cli::array<Byte>^ value)
+{
+	_writer->Write((UInt16)code);
+	_writer->Write((UInt16)value->Length);
+	_writer->Write(value);
+
+	for (int i = value->Length; i < Pad4(value->Length); ++i)
+		_writer->Write((Byte)0);
+}
+
+void PacketCapture::WriteSectionHeader(void)
+{
+	int length = 28;
+
+	_writer->Write(SectionHeaderBlock);
+	_writer->Write(length);
+	_writer->Write(ByteOrderMagic);
+	_writer->Write((UInt16)1);
+	_writer->Write((UInt16)0);
+	_writer->Write((__int64)-1);
+	_writer->Write(length);
+}
+
+int PacketCapture::GetInterface(IntPtr connection)
+{
+	int id;
+
+	if (_interfaces->TryGetValue(connection, id))
+		return id;
+
+	id = _interfaces->Count;
+	_interfaces->Add(connection, id);
+
+	String^ name = String::Concat("udt connection ", id.ToString(CultureInfo::InvariantCulture));
+	KeyValuePair<IPEndPoint^, IPEndPoint^> endPoints;
+
+	Monitor::Enter(_endPoints);
+	try
+	{
+		if (_endPoints->TryGetValue(connection, endPoints))
+			name = String::Concat("udt ", endPoints.Key, " - ", endPoints.Value);
+	}
+	finally
+	{
+		Monitor::Exit(_endPoints);
+	}
+
+	cli::array<Byte>^ nameBytes = Encoding::UTF8->GetBytes(name);
+	cli::array<Byte>^ resolution = { 6 };
+	int length = 20 + OptionLength(nameBytes->Length) + OptionLength(1) + 4;
+
+	_writer->Write(InterfaceDescriptionBlock);
+	_writer->Write(length);
+	_writer->Write((UInt16)LinkTypeRaw);
+	_writer->Write((UInt16)0);
+	_writer->Write((UInt32)0xFFFF);
+	WriteOption(OptionInterfaceName, nameBytes);
+	WriteOption(OptionTimestampResolution, resolution);
+	_writer->Write((UInt32)0);
+	_writer->Write(length);
+
+	return id;
+}
+
+void PacketCapture::WriteRecord(const CaptureRecord& record)
+{
+	IntPtr connection((void*)record.connection);
+	int interfaceId = GetInterface(connection);
+
+	KeyValuePair<IPEndPoint^, IPEndPoint^> endPoints;
+	bool known;
+
+	Monitor::Enter(_endPoints);
+	try
+	{
+		known = _endPoints->TryGetValue(connection, endPoints);
+	}
+	finally
+	{
+		Monitor::Exit(_endPoints);
+	}
+
+	IPEndPoint^ local = known ? endPoints.Key : gcnew IPEndPoint(IPAddress::Any, 0);
+	IPEndPoint^ remote = known ? endPoints.Value : gcnew IPEndPoint(IPAddress::Any, 0);
+	bool outbound = record.kind == CaptureDataSent;
+
+	int originalLength;
+	cli::array<Byte>^ datagram = BuildDatagram(outbound ? local : remote, outbound ? remote : local, record.data, record.length, record.originalLength, originalLength);
+
+	// Controller state after the event, read back by CaptureReplay
+	String^ eventName = nullptr;
+
+	switch (record.kind)
+	{
+	case CaptureAck: eventName = "ack"; break;
+	case CaptureLoss: eventName = "loss"; break;
+	case CaptureTimeout: eventName = "timeout"; break;
+	}
+
+	cli::array<Byte>^ comment = nullptr;
+
+	if (eventName != nullptr)
+	{
+		comment = Encoding::UTF8->GetBytes(String::Format(CultureInfo::InvariantCulture,
+			"{0} cwnd={1:R} period={2:R}", eventName, record.windowSize, record.packetSendPeriod));
+	}
+
+	cli::array<Byte>^ flags = BitConverter::GetBytes((UInt32)(outbound ? 2 : 1));
+	int length = 28 + Pad4(datagram->Length) + OptionLength(4) + (comment == nullptr ? 0 : OptionLength(comment->Length)) + 4 + 4;
+
+	__int64 microseconds = _timeBase + (record.timestamp - _counterBase) * 1000000 / _counterFrequency;
+
+	_writer->Write(EnhancedPacketBlock);
+	_writer->Write(length);
+	_writer->Write((UInt32)interfaceId);
+	_writer->Write((UInt32)(microseconds >> 32));
+	_writer->Write((UInt32)microseconds);
+	_writer->Write((UInt32)datagram->Length);
+	_writer->Write((UInt32)originalLength);
+	_writer->Write(datagram);
+
+	for (int i = datagram->Length; i < Pad4(datagram->Length); ++i)
+		_writer->Write((Byte)0);
+
+	WriteOption(OptionPacketFlags, flags);
+
+	if (comment != nullptr)
+		WriteOption(OptionComment, comment);
+
+	_writer->Write((UInt32)0);
+	_writer->Write(length);
+}
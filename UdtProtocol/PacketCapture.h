@@ -0,0 +1,171 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	class PacketCaptureRing;
+	struct CaptureRecord;
+	ref class Socket;
+
+	/// <summary>
+	/// Records the packets and congestion control events of one or more
+	/// sockets to a pcapng file.
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Assign the capture to <see cref="Socket::PacketCapture"/> before the
+	/// socket connects or listens. Every data packet sent and received is
+	/// written with its UDT header and, optionally, the first
+	/// <see cref="PayloadPrefixLength"/> bytes of payload. Each ACK, NAK and
+	/// timeout delivered to the congestion control is written as a UDT
+	/// control packet carrying the values the controller saw, with the
+	/// resulting window and send period in the packet comment.
+	/// </para>
+	/// <para>
+	/// Packets are wrapped in synthetic IP and UDP headers for the socket
+	/// end points, so Wireshark's UDT dissector decodes them. Each
+	/// connection is a separate pcapng interface.
+	/// </para>
+	/// <para>
+	/// Recording from the UDT threads only copies the record into a
+	/// lock-free ring; a background thread writes the file. When the ring
+	/// is full, records are dropped and counted in
+	/// <see cref="RecordsDropped"/> rather than slowing the connection.
+	/// </para>
+	/// </remarks>
+	public ref class PacketCapture : public System::IDisposable
+	{
+	private:
+		PacketCaptureRing* _ring;
+		System::IO::Stream^ _stream;
+		System::IO::BinaryWriter^ _writer;
+		bool _ownsStream;
+		int _payloadPrefixLength;
+		System::Threading::Thread^ _writerThread;
+		System::Threading::ManualResetEvent^ _stop;
+		System::Collections::Generic::Dictionary<System::IntPtr, System::Collections::Generic::KeyValuePair<System::Net::IPEndPoint^, System::Net::IPEndPoint^> >^ _endPoints;
+		System::Collections::Generic::Dictionary<System::IntPtr, int>^ _interfaces;
+		__int64 _timeBase;
+		__int64 _counterBase;
+		__int64 _counterFrequency;
+		System::Exception^ _writeError;
+		bool _isDisposed;
+
+		literal int DefaultRingCapacity = 16384;
+		literal int WriterPollMilliseconds = 10;
+
+		void Initialize(System::IO::Stream^ stream, bool ownsStream, int payloadPrefixLength);
+		void WriteLoop(void);
+		void Drain(void);
+		void WriteSectionHeader(void);
+		void WriteOption(int code, cli::array<System::Byte>^ value);
+		static int OptionLength(int valueLength);
+		int GetInterface(System::IntPtr connection);
+		void WriteRecord(const CaptureRecord& record);
+
+	internal:
+		property PacketCaptureRing* Ring { PacketCaptureRing* get(void) { return _ring; } }
+
+		void Register(Udt::Socket^ socket);
+
+	public:
+
+		/// <summary>
+		/// Largest supported <see cref="PayloadPrefixLength"/>.
+		/// </summary>
+		literal int MaxPayloadPrefixLength = 128;
+
+		/// <summary>
+		/// Initialize a new instance that writes headers only to a new file.
+		/// </summary>
+		/// <param name="path">File to create or overwrite.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="path"/> is null.</exception>
+		PacketCapture(System::String^ path);
+
+		/// <summary>
+		/// Initialize a new instance that writes to a new file.
+		/// </summary>
+		/// <param name="path">File to create or overwrite.</param>
+		/// <param name="payloadPrefixLength">Payload bytes to keep from each data packet.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="path"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="payloadPrefixLength"/> is less than 0 or greater than <see cref="MaxPayloadPrefixLength"/>.</exception>
+		PacketCapture(System::String^ path, int payloadPrefixLength);
+
+		/// <summary>
+		/// Initialize a new instance that writes to a stream.
+		/// </summary>
+		/// <remarks>
+		/// The stream is flushed but not closed when the capture is disposed.
+		/// </remarks>
+		/// <param name="stream">Writable stream.</param>
+		/// <param name="payloadPrefixLength">Payload bytes to keep from each data packet.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="stream"/> is null.</exception>
+		/// <exception cref="System::ArgumentException">If <paramref name="stream"/> is not writable.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="payloadPrefixLength"/> is less than 0 or greater than <see cref="MaxPayloadPrefixLength"/>.</exception>
+		PacketCapture(System::IO::Stream^ stream, int payloadPrefixLength);
+
+		virtual ~PacketCapture(void);
+		!PacketCapture(void);
+
+		/// <summary>
+		/// Stop capturing, write the remaining records and close the file.
+		/// </summary>
+		/// <exception cref="System::IO::IOException">If writing the capture failed.</exception>
+		void Close(void);
+
+		/// <summary>
+		/// Get the number of payload bytes kept from each data packet.
+		/// </summary>
+		property int PayloadPrefixLength
+		{
+			int get(void) { return _payloadPrefixLength; }
+		}
+
+		/// <summary>
+		/// Get the number of records dropped because the writer fell behind.
+		/// </summary>
+		property int RecordsDropped
+		{
+			int get(void);
+		}
+
+		/// <summary>
+		/// Get true if the capture has been closed.
+		/// </summary>
+		property bool IsDisposed
+		{
+			bool get(void) { return _isDisposed; }
+		}
+	};
+}
@@ -0,0 +1,298 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "PacketCaptureRing.h"
+#include "CCCState.h"
+
+#include <udt.h>
+#include <packet.h>
+
+using namespace Udt;
+
+#pragma managed(push, off)
+
+namespace
+{
+	void WriteUInt32(unsigned char* data, int offset, unsigned int value)
+	{
+		// Network byte order, as on the wire
+		data[offset] = (unsigned char)(value >> 24);
+		data[offset + 1] = (unsigned char)(value >> 16);
+		data[offset + 2] = (unsigned char)(value >> 8);
+		data[offset + 3] = (unsigned char)value;
+	}
+}
+
+PacketCaptureRing::PacketCaptureRing(int capacity, int payloadPrefix)
+	: _enqueuePosition(0), _dequeuePosition(0), _dropped(0), _references(1), _closed(0), _payloadPrefix(payloadPrefix)
+{
+	int size = 2;
+	while (size < capacity) size <<= 1;
+
+	_cells = new Cell[size];
+	_mask = size - 1;
+
+	for (int i = 0; i < size; ++i)
+		_cells[i].sequence = i;
+}
+
+PacketCaptureRing::~PacketCaptureRing(void)
+{
+	delete[] _cells;
+}
+
+void PacketCaptureRing::AddRef(void)
+{
+	InterlockedIncrement(&_references);
+}
+
+void PacketCaptureRing::Release(void)
+{
+	if (InterlockedDecrement(&_references) == 0)
+		delete this;
+}
+
+void PacketCaptureRing::Enqueue(const CaptureRecord& record)
+{
+	LONG position = _enqueuePosition;
+	Cell* cell;
+
+	while (true)
+	{
+		cell = &_cells[position & _mask];
+		LONG difference = cell->sequence - position;
+
+		if (difference == 0)
+		{
+			LONG observed = InterlockedCompareExchange(&_enqueuePosition, position + 1, position);
+
+			if (observed == position)
+				break;
+
+			position = observed;
+		}
+		else if (difference < 0)
+		{
+			InterlockedIncrement(&_dropped);
+			return;
+		}
+		else
+		{
+			position = _enqueuePosition;
+		}
+	}
+
+	cell->record = record;
+	InterlockedExchange(&cell->sequence, position + 1);
+}
+
+bool PacketCaptureRing::TryDequeue(CaptureRecord& record)
+{
+	Cell* cell = &_cells[_dequeuePosition & _mask];
+
+	if (cell->sequence - (_dequeuePosition + 1) < 0)
+		return false;
+
+	record = cell->record;
+	InterlockedExchange(&cell->sequence, _dequeuePosition + _mask + 1);
+	++_dequeuePosition;
+	return true;
+}
+
+void PacketCaptureRing::Fill(CaptureRecord& record, const CCC* cc, CaptureRecordKind kind)
+{
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+
+	CCC* state = const_cast<CCC*>(cc);
+
+	record.timestamp = now.QuadPart;
+	record.connection = cc;
+	record.kind = kind;
+	record.originalLength = 0;
+	record.length = 0;
+	record.windowSize = CCCState::WindowSize(state);
+	record.packetSendPeriod = CCCState::PacketSendPeriod(state);
+}
+
+void PacketCaptureRing::RecordPacket(const CCC* cc, CaptureRecordKind kind, const CPacket* packet)
+{
+	if (_closed)
+		return;
+
+	CaptureRecord record;
+	Fill(record, cc, kind);
+
+	WriteUInt32(record.data, 0, packet->m_iSeqNo);
+	WriteUInt32(record.data, 4, packet->m_iMsgNo);
+	WriteUInt32(record.data, 8, packet->m_iTimeStamp);
+	WriteUInt32(record.data, 12, packet->m_iID);
+
+	int payload = packet->getLength();
+	int prefix = payload < _payloadPrefix ? payload : _payloadPrefix;
+
+	if (prefix > 0 && packet->m_pcData != NULL)
+		memcpy(record.data + 16, packet->m_pcData, prefix);
+
+	record.originalLength = 16 + payload;
+	record.length = 16 + prefix;
+	Enqueue(record);
+}
+
+void PacketCaptureRing::RecordAck(const CCC* cc, int32_t ack)
+{
+	if (_closed)
+		return;
+
+	CCC* state = const_cast<CCC*>(cc);
+
+	CaptureRecord record;
+	Fill(record, cc, CaptureAck);
+
+	// UDT ACK control packet with the values CUDT gave the controller
+	WriteUInt32(record.data, 0, 0x80020000);
+	WriteUInt32(record.data, 4, 0);
+	WriteUInt32(record.data, 8, 0);
+	WriteUInt32(record.data, 12, 0);
+	WriteUInt32(record.data, 16, ack);
+	WriteUInt32(record.data, 20, CCCState::RoundtripTime(state));
+	WriteUInt32(record.data, 24, 0);
+	WriteUInt32(record.data, 28, 0);
+	WriteUInt32(record.data, 32, CCCState::ReceiveRate(state));
+	WriteUInt32(record.data, 36, CCCState::Bandwidth(state));
+
+	record.originalLength = record.length = 40;
+	Enqueue(record);
+}
+
+void PacketCaptureRing::RecordLoss(const CCC* cc, const int32_t* losslist, int size)
+{
+	if (_closed)
+		return;
+
+	CaptureRecord record;
+	Fill(record, cc, CaptureLoss);
+
+	// UDT NAK control packet, long loss lists are truncated
+	WriteUInt32(record.data, 0, 0x80030000);
+	WriteUInt32(record.data, 4, 0);
+	WriteUInt32(record.data, 8, 0);
+	WriteUInt32(record.data, 12, 0);
+
+	int count = size < (CaptureRecord::DataSize - 16) / 4 ? size : (CaptureRecord::DataSize - 16) / 4;
+
+	// Keep a range start with its end
+	if (count < size && (losslist[count - 1] & 0x80000000) != 0)
+		--count;
+
+	for (int i = 0; i < count; ++i)
+		WriteUInt32(record.data, 16 + i * 4, losslist[i]);
+
+	record.originalLength = 16 + size * 4;
+	record.length = 16 + count * 4;
+	Enqueue(record);
+}
+
+void PacketCaptureRing::RecordTimeout(const CCC* cc)
+{
+	if (_closed)
+		return;
+
+	CaptureRecord record;
+	Fill(record, cc, CaptureTimeout);
+	Enqueue(record);
+}
+
+CapturingUDTCC::CapturingUDTCC(PacketCaptureRing* capture)
+	: _capture(capture)
+{
+	_capture->AddRef();
+}
+
+CapturingUDTCC::~CapturingUDTCC(void)
+{
+	_capture->Release();
+}
+
+void CapturingUDTCC::onACK(int32_t ack)
+{
+	CUDTCC::onACK(ack);
+	_capture->RecordAck(this, ack);
+}
+
+void CapturingUDTCC::onLoss(const int32_t* losslist, int size)
+{
+	CUDTCC::onLoss(losslist, size);
+	_capture->RecordLoss(this, losslist, size);
+}
+
+void CapturingUDTCC::onTimeout(void)
+{
+	CUDTCC::onTimeout();
+	_capture->RecordTimeout(this);
+}
+
+void CapturingUDTCC::onPktSent(const CPacket* packet)
+{
+	CUDTCC::onPktSent(packet);
+	_capture->RecordPacket(this, CaptureDataSent, packet);
+}
+
+void CapturingUDTCC::onPktReceived(const CPacket* packet)
+{
+	CUDTCC::onPktReceived(packet);
+	_capture->RecordPacket(this, CaptureDataReceived, packet);
+}
+
+CapturingUDTCCFactory::CapturingUDTCCFactory(PacketCaptureRing* capture)
+	: _capture(capture)
+{
+	_capture->AddRef();
+}
+
+CapturingUDTCCFactory::~CapturingUDTCCFactory(void)
+{
+	_capture->Release();
+}
+
+CCC* CapturingUDTCCFactory::create()
+{
+	return new CapturingUDTCC(_capture);
+}
+
+CCCVirtualFactory* CapturingUDTCCFactory::clone()
+{
+	return new CapturingUDTCCFactory(_capture);
+}
+
+#pragma managed(pop)
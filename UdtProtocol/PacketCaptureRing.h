@@ -0,0 +1,164 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+#include <ccc.h>
+
+namespace Udt
+{
+	/// <summary>
+	/// Kind of <see cref="CaptureRecord"/>.
+	/// </summary>
+	enum CaptureRecordKind
+	{
+		CaptureDataSent,
+		CaptureDataReceived,
+		CaptureAck,
+		CaptureLoss,
+		CaptureTimeout
+	};
+
+	/// <summary>
+	/// One captured packet or congestion control event.
+	/// </summary>
+	struct CaptureRecord
+	{
+		// Room for the UDT header and the largest payload prefix
+		static const int DataSize = 16 + 128;
+
+		LONGLONG timestamp;
+		const CCC* connection;
+		CaptureRecordKind kind;
+		int originalLength;
+		int length;
+		double windowSize;
+		double packetSendPeriod;
+		unsigned char data[DataSize];
+	};
+
+	/// <summary>
+	/// Bounded lock-free queue of capture records, filled from the UDT send
+	/// and receive threads and drained by a single writer.
+	/// </summary>
+	/// <remarks>
+	/// Producers never block; a record that finds the ring full is counted
+	/// in <see cref="Dropped"/> and discarded. The ring is reference counted
+	/// because congestion control objects can outlive the capture that
+	/// created them.
+	/// </remarks>
+	class PacketCaptureRing
+	{
+	private:
+		struct Cell
+		{
+			volatile LONG sequence;
+			CaptureRecord record;
+		};
+
+		Cell* _cells;
+		LONG _mask;
+		volatile LONG _enqueuePosition;
+		LONG _dequeuePosition;
+		volatile LONG _dropped;
+		volatile LONG _references;
+		volatile LONG _closed;
+		int _payloadPrefix;
+
+		PacketCaptureRing(const PacketCaptureRing&);
+		PacketCaptureRing& operator=(const PacketCaptureRing&);
+
+		~PacketCaptureRing(void);
+
+		void Enqueue(const CaptureRecord& record);
+		void Fill(CaptureRecord& record, const CCC* cc, CaptureRecordKind kind);
+
+	public:
+
+		/// <param name="capacity">Number of records, rounded up to a power of 2.</param>
+		/// <param name="payloadPrefix">Payload bytes to keep from each data packet.</param>
+		PacketCaptureRing(int capacity, int payloadPrefix);
+
+		void AddRef(void);
+		void Release(void);
+
+		/// <summary>
+		/// Stop accepting records.
+		/// </summary>
+		void Close(void) { InterlockedExchange(&_closed, 1); }
+
+		int Dropped(void) const { return _dropped; }
+
+		bool TryDequeue(CaptureRecord& record);
+
+		void RecordPacket(const CCC* cc, CaptureRecordKind kind, const CPacket* packet);
+		void RecordAck(const CCC* cc, int32_t ack);
+		void RecordLoss(const CCC* cc, const int32_t* losslist, int size);
+		void RecordTimeout(const CCC* cc);
+	};
+
+	/// <summary>
+	/// The default UDT congestion control with capture of its events.
+	/// </summary>
+	class CapturingUDTCC : public CUDTCC
+	{
+	private:
+		PacketCaptureRing* _capture;
+
+	public:
+		CapturingUDTCC(PacketCaptureRing* capture);
+		virtual ~CapturingUDTCC(void);
+
+		virtual void onACK(int32_t ack);
+		virtual void onLoss(const int32_t* losslist, int size);
+		virtual void onTimeout(void);
+		virtual void onPktSent(const CPacket* packet);
+		virtual void onPktReceived(const CPacket* packet);
+	};
+
+	/// <summary>
+	/// Factory for <see cref="CapturingUDTCC"/>, used when a socket has a
+	/// capture but no custom congestion control.
+	/// </summary>
+	class CapturingUDTCCFactory : public CCCVirtualFactory
+	{
+	private:
+		PacketCaptureRing* _capture;
+
+	public:
+		CapturingUDTCCFactory(PacketCaptureRing* capture);
+		virtual ~CapturingUDTCCFactory(void);
+
+		virtual CCC* create();
+		virtual CCCVirtualFactory* clone();
+	};
+}
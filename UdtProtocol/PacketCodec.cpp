@@ -0,0 +1,249 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "PacketCodec.h"
+
+#include "Packet.h"
+#include "DataPacket.h"
+#include "ControlPacket.h"
+#include "KeepAlivePacket.h"
+#include "ShutdownPacket.h"
+#include "CongestionPacket.h"
+#include "ErrorPacket.h"
+#include "Ack2Packet.h"
+
+#include <udt.h>
+#include <packet.h>
+#include <emmintrin.h>
+
+using namespace Udt;
+using namespace System;
+
+#pragma managed(push, off)
+
+namespace
+{
+	/// <summary>
+	/// Reverse the bytes of each 32 bit word.
+	/// </summary>
+	inline __m128i ByteSwap32(__m128i value)
+	{
+		// Swap the bytes of each 16 bit lane, then the lanes of each word
+		value = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+		value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+		return _mm_shufflehi_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+	}
+
+	inline void SwapHeader(const char* source, void* destination)
+	{
+		_mm_storeu_si128((__m128i*)destination, ByteSwap32(_mm_loadu_si128((const __m128i*)source)));
+	}
+
+	/// <summary>
+	/// Copy 32 bit words between network and host byte order.
+	/// </summary>
+	void SwapWords(const char* source, char* destination, int length)
+	{
+		int i = 0;
+
+		for (; i + 16 <= length; i += 16)
+			SwapHeader(source + i, destination + i);
+
+		for (; i + 4 <= length; i += 4)
+			*(unsigned long*)(destination + i) = _byteswap_ulong(*(const unsigned long*)(source + i));
+	}
+
+	struct RawHeader
+	{
+		int words[4];
+		int dataLength;
+	};
+
+	void SwapHeaders(const char* buffer, const int* offsets, const int* lengths, int count, RawHeader* headers)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			SwapHeader(buffer + offsets[i], headers[i].words);
+			headers[i].dataLength = lengths[i] - PacketCodec::HeaderSize;
+		}
+	}
+}
+
+#pragma managed(pop)
+
+Packet^ PacketCodec::Decode(cli::array<Byte>^ buffer, int offset, int count)
+{
+	if (buffer == nullptr) throw gcnew ArgumentNullException("buffer");
+	if (offset < 0) throw gcnew ArgumentOutOfRangeException("offset", offset, "Value must be greater than or equal to 0.");
+	if (count < 0) throw gcnew ArgumentOutOfRangeException("count", count, "Value must be greater than or equal to 0.");
+	if (offset + count > buffer->Length) throw gcnew ArgumentException("Invalid buffer offset and count.");
+	if (count < HeaderSize) throw gcnew ArgumentException("Datagram is shorter than a UDT header.", "count");
+
+	pin_ptr<Byte> bufferPin = &buffer[0];
+	const char* datagram = (const char*)bufferPin + offset;
+	int dataLength = count - HeaderSize;
+
+	int header[4];
+	SwapHeader(datagram, header);
+
+	if (header[0] >= 0)
+	{
+		DataPacket^ packet = gcnew DataPacket();
+		packet->DataLength = dataLength;
+
+		CPacket* native = packet->NativePacket;
+		memcpy(&native->m_iSeqNo, header, HeaderSize);
+
+		if (dataLength > 0)
+			memcpy(native->m_pcData, datagram + HeaderSize, dataLength);
+
+		return packet;
+	}
+
+	if ((dataLength & 3) != 0)
+		throw gcnew ArgumentException("Control information must be a multiple of 4 bytes.", "count");
+
+	ControlPacket^ packet;
+	bool padded = true;
+
+	switch ((header[0] >> 16) & 0x7FFF)
+	{
+	case Ack2Packet::TypeCode:
+		packet = gcnew Ack2Packet();
+		break;
+
+	case ErrorPacket::TypeCode:
+		packet = gcnew ErrorPacket();
+		break;
+
+	case CongestionPacket::TypeCode:
+		packet = gcnew CongestionPacket();
+		break;
+
+	case ShutdownPacket::TypeCode:
+		packet = gcnew ShutdownPacket();
+		break;
+
+	case KeepAlivePacket::TypeCode:
+		packet = gcnew KeepAlivePacket();
+		break;
+
+	default:
+		packet = gcnew ControlPacket();
+		padded = false;
+		break;
+	}
+
+	CPacket* native = packet->NativePacket;
+	memcpy(&native->m_iSeqNo, header, HeaderSize);
+
+	// The typed packets only carry a 4 byte pad after the header
+	if (!padded && dataLength > 0)
+	{
+		char info[1024];
+		char* swapped = dataLength <= (int)sizeof(info) ? info : new char[dataLength];
+
+		try
+		{
+			SwapWords(datagram + HeaderSize, swapped, dataLength);
+			packet->SetControlInformation(swapped, dataLength);
+		}
+		finally
+		{
+			if (swapped != info)
+				delete [] swapped;
+		}
+	}
+
+	return packet;
+}
+
+int PacketCodec::Encode(Packet^ packet, cli::array<Byte>^ buffer, int offset)
+{
+	if (packet == nullptr) throw gcnew ArgumentNullException("packet");
+	if (buffer == nullptr) throw gcnew ArgumentNullException("buffer");
+	if (offset < 0) throw gcnew ArgumentOutOfRangeException("offset", offset, "Value must be greater than or equal to 0.");
+	if (packet->IsDisposed) throw gcnew ObjectDisposedException(packet->ToString());
+
+	CPacket* native = packet->NativePacket;
+	int dataLength = native->getLength();
+	int count = HeaderSize + dataLength;
+
+	if (offset + count > buffer->Length)
+		throw gcnew ArgumentException("Buffer is too small for the packet.", "buffer");
+
+	pin_ptr<Byte> bufferPin = &buffer[0];
+	char* datagram = (char*)bufferPin + offset;
+
+	SwapHeader((const char*)&native->m_iSeqNo, datagram);
+
+	if (dataLength > 0)
+	{
+		if (native->getFlag())
+			SwapWords(native->m_pcData, datagram + HeaderSize, dataLength);
+		else
+			memcpy(datagram + HeaderSize, native->m_pcData, dataLength);
+	}
+
+	return count;
+}
+
+void PacketCodec::DecodeHeaders(cli::array<Byte>^ buffer, cli::array<int>^ offsets, cli::array<int>^ lengths, int count, cli::array<PacketHeader>^ headers)
+{
+	if (buffer == nullptr) throw gcnew ArgumentNullException("buffer");
+	if (offsets == nullptr) throw gcnew ArgumentNullException("offsets");
+	if (lengths == nullptr) throw gcnew ArgumentNullException("lengths");
+	if (headers == nullptr) throw gcnew ArgumentNullException("headers");
+
+	if (count < 0 || count > offsets->Length || count > lengths->Length || count > headers->Length)
+		throw gcnew ArgumentOutOfRangeException("count", count, "Value must be between 0 and the length of offsets, lengths and headers.");
+
+	for (int i = 0; i < count; ++i)
+	{
+		int offset = offsets[i];
+		int length = lengths[i];
+
+		if (length < HeaderSize || offset < 0 || offset > buffer->Length - length)
+			throw gcnew ArgumentException(String::Concat("Datagram ", (Object^)i, " is shorter than a UDT header or outside the buffer."));
+	}
+
+	if (count == 0)
+		return;
+
+	pin_ptr<Byte> bufferPin = &buffer[0];
+	pin_ptr<int> offsetsPin = &offsets[0];
+	pin_ptr<int> lengthsPin = &lengths[0];
+	pin_ptr<PacketHeader> headersPin = &headers[0];
+
+	SwapHeaders((const char*)bufferPin, offsetsPin, lengthsPin, count, (RawHeader*)headersPin);
+}
@@ -0,0 +1,108 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+#include "PacketHeader.h"
+
+namespace Udt
+{
+	ref class Packet;
+
+	/// <summary>
+	/// Encodes and decodes raw UDT datagrams.
+	/// </summary>
+	/// <remarks>
+	/// For tools that read or write UDT traffic without a socket, such as
+	/// capture analysis and relays. Headers are byte swapped 16 bytes at a
+	/// time with SSE2; <see cref="DecodeHeaders"/> processes a whole batch
+	/// of datagrams in one native call.
+	/// </remarks>
+	public ref class PacketCodec abstract sealed
+	{
+	public:
+
+		/// <summary>
+		/// Size of the UDT header, in bytes.
+		/// </summary>
+		literal int HeaderSize = 16;
+
+		/// <summary>
+		/// Decode a datagram into a new packet.
+		/// </summary>
+		/// <remarks>
+		/// Data packets are returned as <see cref="DataPacket"/>; ACK2,
+		/// error, congestion warning, shutdown and keep-alive packets as the
+		/// matching <see cref="ControlPacket"/> subclass; other control
+		/// packets as <see cref="ControlPacket"/> with their control
+		/// information attached. The caller owns and disposes the packet.
+		/// </remarks>
+		/// <param name="buffer">Buffer holding the datagram.</param>
+		/// <param name="offset">Offset of the datagram in <paramref name="buffer"/>.</param>
+		/// <param name="count">Length of the datagram.</param>
+		/// <returns>Decoded packet.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="buffer"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="offset"/> or <paramref name="count"/> is less than 0.</exception>
+		/// <exception cref="System::ArgumentException">
+		/// If the sum of <paramref name="offset"/> and <paramref name="count"/> is larger than the <paramref name="buffer"/> length.
+		/// - or -
+		/// If <paramref name="count"/> is less than <see cref="HeaderSize"/>, or the control information is not a multiple of 4 bytes.
+		/// </exception>
+		static Packet^ Decode(cli::array<System::Byte>^ buffer, int offset, int count);
+
+		/// <summary>
+		/// Encode a packet into its wire format.
+		/// </summary>
+		/// <param name="packet">Packet to encode.</param>
+		/// <param name="buffer">Buffer to write the datagram to.</param>
+		/// <param name="offset">Offset into <paramref name="buffer"/> to start writing at.</param>
+		/// <returns>Number of bytes written.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="packet"/> or <paramref name="buffer"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="offset"/> is less than 0.</exception>
+		/// <exception cref="System::ArgumentException">If the datagram does not fit in <paramref name="buffer"/>.</exception>
+		/// <exception cref="System::ObjectDisposedException">If <paramref name="packet"/> has been disposed.</exception>
+		static int Encode(Packet^ packet, cli::array<System::Byte>^ buffer, int offset);
+
+		/// <summary>
+		/// Decode the headers of a batch of datagrams.
+		/// </summary>
+		/// <param name="buffer">Buffer holding the datagrams.</param>
+		/// <param name="offsets">Offset of each datagram in <paramref name="buffer"/>.</param>
+		/// <param name="lengths">Length of each datagram.</param>
+		/// <param name="count">Number of datagrams to decode.</param>
+		/// <param name="headers">Receives one header per datagram.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="buffer"/>, <paramref name="offsets"/>, <paramref name="lengths"/> or <paramref name="headers"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="count"/> is less than 0 or greater than the length of <paramref name="offsets"/>, <paramref name="lengths"/> or <paramref name="headers"/>.</exception>
+		/// <exception cref="System::ArgumentException">If a datagram is shorter than <see cref="HeaderSize"/> or lies outside <paramref name="buffer"/>.</exception>
+		static void DecodeHeaders(cli::array<System::Byte>^ buffer, cli::array<int>^ offsets, cli::array<int>^ lengths, int count, cli::array<PacketHeader>^ headers);
+	};
+}
@@ -0,0 +1,134 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+#include "MessageBoundary.h"
+
+namespace Udt
+{
+	/// <summary>
+	/// Header of a raw UDT datagram decoded by <see cref="PacketCodec"/>.
+	/// </summary>
+	/// <remarks>
+	/// The struct holds the four header words in host byte order plus the
+	/// length of what follows them, so batches decode straight into an
+	/// array. Data packet properties are only meaningful if
+	/// <see cref="IsControl"/> is false, control properties only if it is
+	/// true.
+	/// </remarks>
+	[System::Runtime::InteropServices::StructLayout(System::Runtime::InteropServices::LayoutKind::Sequential)]
+	public value struct PacketHeader
+	{
+	private:
+
+		int _word0;
+		int _word1;
+		int _timeStamp;
+		int _destination;
+		int _dataLength;
+
+	public:
+
+		/// <summary>
+		/// Get true for a control packet, false for a data packet.
+		/// </summary>
+		property bool IsControl {
+			bool get(void) { return _word0 < 0; }
+		}
+
+		/// <summary>
+		/// Get the data packet sequence number.
+		/// </summary>
+		property int PacketNumber {
+			int get(void) { return _word0; }
+		}
+
+		/// <summary>
+		/// Get the data packet message sequence number.
+		/// </summary>
+		property int MessageNumber {
+			int get(void) { return _word1 & 0x1FFFFFFF; }
+		}
+
+		/// <summary>
+		/// Get the location of the data packet in the stream.
+		/// </summary>
+		property Udt::MessageBoundary MessageBoundary {
+			Udt::MessageBoundary get(void) { return (Udt::MessageBoundary)((unsigned int)_word1 >> 30); }
+		}
+
+		/// <summary>
+		/// Get true if in-order delivery of the data packet is required.
+		/// </summary>
+		property bool InOrder {
+			bool get(void) { return (_word1 & 0x20000000) != 0; }
+		}
+
+		/// <summary>
+		/// Get the control packet type code.
+		/// </summary>
+		property int ControlType {
+			int get(void) { return (_word0 >> 16) & 0x7FFF; }
+		}
+
+		/// <summary>
+		/// Get the control packet additional info word (the ACK sequence
+		/// number of an ACK or ACK2, the error code of an error packet).
+		/// </summary>
+		property int AdditionalInfo {
+			int get(void) { return _word1; }
+		}
+
+		/// <summary>
+		/// Get the time stamp of the packet.
+		/// </summary>
+		property System::TimeSpan TimeStamp {
+			System::TimeSpan get(void) { return FromMicroseconds((unsigned int)_timeStamp); }
+		}
+
+		/// <summary>
+		/// Get ID of the destination socket for the packet.
+		/// </summary>
+		property int DestinationId {
+			int get(void) { return _destination; }
+		}
+
+		/// <summary>
+		/// Get the length of the payload or control information after the
+		/// header, in bytes.
+		/// </summary>
+		property int DataLength {
+			int get(void) { return _dataLength; }
+		}
+	};
+}
@@ -0,0 +1,97 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <iphlpapi.h>
+#include <limits.h>
+
+#include "PathMtu.h"
+
+#pragma managed(push, off)
+
+int Udt::GetPathMtu(const sockaddr_storage& destination)
+{
+	SOCKADDR_INET address;
+	memset(&address, 0, sizeof(address));
+
+	if (destination.ss_family == AF_INET)
+		address.Ipv4 = *(const sockaddr_in*)&destination;
+	else if (destination.ss_family == AF_INET6)
+		address.Ipv6 = *(const sockaddr_in6*)&destination;
+	else
+		return 0;
+
+	DWORD index;
+
+	if (NO_ERROR != GetBestInterfaceEx((sockaddr*)&destination, &index))
+		return 0;
+
+	MIB_IPPATH_ROW path;
+	memset(&path, 0, sizeof(path));
+	path.Destination = address;
+	path.InterfaceIndex = index;
+
+	if (NO_ERROR == GetIpPathEntry(&path) && path.PathMtu > 0)
+		return path.PathMtu > INT_MAX ? INT_MAX : (int)path.PathMtu;
+
+	MIB_IPINTERFACE_ROW row;
+	InitializeIpInterfaceEntry(&row);
+	row.Family = destination.ss_family;
+	row.InterfaceIndex = index;
+
+	if (NO_ERROR == GetIpInterfaceEntry(&row) && row.NlMtu > 0)
+		return row.NlMtu > MaxInterfaceMtu ? MaxInterfaceMtu : (int)row.NlMtu;
+
+	return 0;
+}
+
+int Udt::GetPathPacketSize(const sockaddr_storage& destination)
+{
+	int mtu = GetPathMtu(destination);
+
+	if (mtu <= 0)
+		return 0;
+
+	// Loopback reports an unlimited MTU
+	if (mtu > MaxPathPacketSize)
+		mtu = MaxPathPacketSize;
+
+	if (destination.ss_family == AF_INET6)
+		mtu -= 20;
+
+	return mtu;
+}
+
+#pragma managed(pop)
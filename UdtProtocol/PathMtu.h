@@ -0,0 +1,70 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+#include <winsock2.h>
+
+namespace Udt
+{
+	/// <summary>
+	/// Largest packet size chosen from a path MTU, in bytes.
+	/// </summary>
+	const int MaxPathPacketSize = 9000;
+
+	/// <summary>
+	/// Largest MTU taken from an interface when no path MTU is known, in
+	/// bytes; a link past the first hop may be smaller than a jumbo frame
+	/// interface.
+	/// </summary>
+	const int MaxInterfaceMtu = 1500;
+
+	/// <summary>
+	/// Get the MTU towards a destination, in bytes, or 0 if unknown.
+	/// </summary>
+	/// <remarks>
+	/// Uses the path MTU Windows has discovered for the destination when
+	/// there is one, otherwise the MTU of the interface the destination
+	/// is routed through, up to <see cref="MaxInterfaceMtu"/>.
+	/// </remarks>
+	int GetPathMtu(const sockaddr_storage& destination);
+
+	/// <summary>
+	/// Get the UDT packet size that fills an MTU without fragmenting, or
+	/// 0 if the MTU is unknown.
+	/// </summary>
+	/// <remarks>
+	/// UDT_MSS counts 28 bytes of IPv4 and UDP headers; IPv6 headers are
+	/// 20 bytes longer. The result is at most <see cref="MaxPathPacketSize"/>.
+	/// </remarks>
+	int GetPathPacketSize(const sockaddr_storage& destination);
+}
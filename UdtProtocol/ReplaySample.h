@@ -0,0 +1,75 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+#include "ReplayEvent.h"
+
+namespace Udt
+{
+	/// <summary>
+	/// Congestion control state after one replayed event, next to the state
+	/// recorded in the capture.
+	/// </summary>
+	public value struct ReplaySample
+	{
+		/// <summary>
+		/// Time since the first packet of the connection.
+		/// </summary>
+		property System::TimeSpan Time;
+
+		/// <summary>
+		/// Event that was replayed.
+		/// </summary>
+		property ReplayEvent Event;
+
+		/// <summary>
+		/// Congestion window of the replayed controller, in packets.
+		/// </summary>
+		property double WindowSize;
+
+		/// <summary>
+		/// Send period of the replayed controller.
+		/// </summary>
+		property System::TimeSpan PacketSendPeriod;
+
+		/// <summary>
+		/// Congestion window recorded in the capture, in packets.
+		/// </summary>
+		property double RecordedWindowSize;
+
+		/// <summary>
+		/// Send period recorded in the capture.
+		/// </summary>
+		property System::TimeSpan RecordedPacketSendPeriod;
+	};
+}
@@ -0,0 +1,204 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "SendCompletionQueue.h"
+
+using namespace Udt;
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Threading;
+
+namespace
+{
+	// IP, UDP and UDT data packet headers
+	const int PacketHeaderSize = 44;
+}
+
+SendCompletionQueue::SendCompletionQueue(UDTSOCKET socket, int maxPacketSize)
+	: _socket(socket), _blockSize(maxPacketSize - PacketHeaderSize), _blocksQueued(0)
+{
+	_pending = gcnew Queue<PendingSend>();
+}
+
+void SendCompletionQueue::Count(int sent)
+{
+	if (sent > 0)
+		Interlocked::Add(_blocksQueued, (sent + _blockSize - 1) / _blockSize);
+}
+
+void SendCompletionQueue::Add(Action<bool>^ acknowledged)
+{
+	PendingSend send;
+	send.Acknowledged = acknowledged;
+
+	bool start;
+
+	Monitor::Enter(_pending);
+	try
+	{
+		send.EndBlock = Interlocked::Read(_blocksQueued);
+		start = (_pending->Count == 0);
+		_pending->Enqueue(send);
+	}
+	finally
+	{
+		Monitor::Exit(_pending);
+	}
+
+	if (!start)
+		return;
+
+	Monitor::Enter(_active);
+	try
+	{
+		if (!_active->Contains(this))
+			_active->Add(this);
+
+		if (_timer == nullptr)
+			_timer = gcnew Timer(gcnew TimerCallback(OnTimer), nullptr, PollInterval, PollInterval);
+		else if (_active->Count == 1)
+			_timer->Change(PollInterval, PollInterval);
+	}
+	finally
+	{
+		Monitor::Exit(_active);
+	}
+}
+
+void SendCompletionQueue::Cancel(void)
+{
+	List<PendingSend>^ sends = gcnew List<PendingSend>();
+
+	Monitor::Enter(_pending);
+	try
+	{
+		sends->AddRange(_pending);
+		_pending->Clear();
+	}
+	finally
+	{
+		Monitor::Exit(_pending);
+	}
+
+	Complete(sends, false);
+}
+
+bool SendCompletionQueue::Poll(void)
+{
+	List<PendingSend>^ sends = gcnew List<PendingSend>();
+	bool acknowledged = true;
+	bool more;
+
+	Monitor::Enter(_pending);
+	try
+	{
+		int queued;
+		int len = sizeof(int);
+
+		if (UDT::ERROR == UDT::getsockopt(_socket, 0, UDT_SNDDATA, &queued, &len))
+		{
+			// Connection is gone, the data will never be acknowledged
+			acknowledged = false;
+			sends->AddRange(_pending);
+			_pending->Clear();
+		}
+		else
+		{
+			__int64 acked = Interlocked::Read(_blocksQueued) - queued;
+
+			while (_pending->Count > 0 && _pending->Peek().EndBlock <= acked)
+				sends->Add(_pending->Dequeue());
+		}
+
+		more = (_pending->Count > 0);
+	}
+	finally
+	{
+		Monitor::Exit(_pending);
+	}
+
+	Complete(sends, acknowledged);
+	return more;
+}
+
+void SendCompletionQueue::Complete(List<PendingSend>^ sends, bool acknowledged)
+{
+	for each (PendingSend send in sends)
+	{
+		send.Acknowledged(acknowledged);
+	}
+}
+
+void SendCompletionQueue::OnTimer(Object^ state)
+{
+	cli::array<SendCompletionQueue^>^ queues;
+
+	Monitor::Enter(_active);
+	try
+	{
+		queues = _active->ToArray();
+	}
+	finally
+	{
+		Monitor::Exit(_active);
+	}
+
+	for each (SendCompletionQueue^ queue in queues)
+	{
+		if (queue->Poll())
+			continue;
+
+		Monitor::Enter(_active);
+		try
+		{
+			// Check again, a send may have been added since polling
+			Monitor::Enter(queue->_pending);
+			try
+			{
+				if (queue->_pending->Count == 0)
+					_active->Remove(queue);
+			}
+			finally
+			{
+				Monitor::Exit(queue->_pending);
+			}
+
+			if (_active->Count == 0)
+				_timer->Change(Timeout::Infinite, Timeout::Infinite);
+		}
+		finally
+		{
+			Monitor::Exit(_active);
+		}
+	}
+}
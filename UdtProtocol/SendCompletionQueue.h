@@ -0,0 +1,96 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+#include <udt.h>
+
+namespace Udt
+{
+	/// <summary>
+	/// Tracks data sent with <see cref="Socket::Send(System::IntPtr, int, System::Action&lt;bool&gt;^)"/>
+	/// until the peer has acknowledged it.
+	/// </summary>
+	/// <remarks>
+	/// UDT keeps sent data in its send buffer, one block per packet payload,
+	/// until it is acknowledged. The queue counts the blocks queued on the
+	/// socket and compares them with the blocks still in the send buffer.
+	/// Data sent without being counted only delays completion. One timer
+	/// polls every socket with sends pending.
+	/// </remarks>
+	ref class SendCompletionQueue
+	{
+	private:
+		value struct PendingSend
+		{
+			__int64 EndBlock;
+			System::Action<bool>^ Acknowledged;
+		};
+
+		UDTSOCKET _socket;
+		int _blockSize;
+		__int64 _blocksQueued;
+		System::Collections::Generic::Queue<PendingSend>^ _pending;
+
+		static System::Collections::Generic::List<SendCompletionQueue^>^ _active = gcnew System::Collections::Generic::List<SendCompletionQueue^>();
+		static System::Threading::Timer^ _timer;
+
+		bool Poll(void);
+		static void Complete(System::Collections::Generic::List<PendingSend>^ sends, bool acknowledged);
+		static void OnTimer(System::Object^ state);
+
+	internal:
+
+		/// <summary>
+		/// Time between checks of the send buffers, in milliseconds.
+		/// </summary>
+		literal int PollInterval = 10;
+
+		SendCompletionQueue(UDTSOCKET socket, int maxPacketSize);
+
+		/// <summary>
+		/// Count the blocks added to the send buffer by one UDT send call.
+		/// </summary>
+		void Count(int sent);
+
+		/// <summary>
+		/// Call <paramref name="acknowledged"/> once everything counted so
+		/// far has been acknowledged.
+		/// </summary>
+		void Add(System::Action<bool>^ acknowledged);
+
+		/// <summary>
+		/// Complete the pending sends as not acknowledged.
+		/// </summary>
+		void Cancel(void);
+	};
+}
@@ -0,0 +1,100 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+#include "SimulationSample.h"
+
+namespace Udt
+{
+	/// <summary>
+	/// Outcome of a <see cref="CongestionControlSimulator"/> run.
+	/// </summary>
+	public ref class SimulationResult
+	{
+	internal:
+		SimulationResult(void);
+
+	public:
+
+		/// <summary>
+		/// Simulated duration of the run.
+		/// </summary>
+		property System::TimeSpan Duration;
+
+		/// <summary>
+		/// Data packets sent, including retransmissions.
+		/// </summary>
+		property __int64 PacketsSent;
+
+		/// <summary>
+		/// Data packets sent more than once.
+		/// </summary>
+		property __int64 PacketsRetransmitted;
+
+		/// <summary>
+		/// Packets dropped because the bottleneck queue was full.
+		/// </summary>
+		property __int64 PacketsDropped;
+
+		/// <summary>
+		/// Packets dropped by random loss on the link.
+		/// </summary>
+		property __int64 PacketsLost;
+
+		/// <summary>
+		/// Packets delivered in order to the receiver.
+		/// </summary>
+		property __int64 PacketsDelivered;
+
+		/// <summary>
+		/// Number of times <see cref="CongestionControl::OnTimeout"/> was called.
+		/// </summary>
+		property int Timeouts;
+
+		/// <summary>
+		/// Delivered payload rate, in bits per second.
+		/// </summary>
+		property double Goodput;
+
+		/// <summary>
+		/// <see cref="Goodput"/> divided by the bottleneck bandwidth.
+		/// </summary>
+		property double Utilization;
+
+		/// <summary>
+		/// Congestion control state sampled at
+		/// <see cref="CongestionControlSimulator::SampleInterval"/>.
+		/// </summary>
+		property System::Collections::Generic::IList<SimulationSample>^ Samples;
+	};
+}
@@ -0,0 +1,78 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	/// <summary>
+	/// Congestion control state at one point of a
+	/// <see cref="CongestionControlSimulator"/> run.
+	/// </summary>
+	public value struct SimulationSample
+	{
+		/// <summary>
+		/// Simulated time since the start of the run.
+		/// </summary>
+		property System::TimeSpan Time;
+
+		/// <summary>
+		/// Congestion window, in packets.
+		/// </summary>
+		property double WindowSize;
+
+		/// <summary>
+		/// Interval between packets set by the congestion control.
+		/// </summary>
+		property System::TimeSpan PacketSendPeriod;
+
+		/// <summary>
+		/// Packets sent but not yet acknowledged.
+		/// </summary>
+		property int FlightSize;
+
+		/// <summary>
+		/// Packets waiting in the bottleneck queue.
+		/// </summary>
+		property int QueueLength;
+
+		/// <summary>
+		/// Smoothed round trip time seen by the sender.
+		/// </summary>
+		property System::TimeSpan RoundtripTime;
+
+		/// <summary>
+		/// Packets delivered in order to the receiver so far.
+		/// </summary>
+		property __int64 PacketsDelivered;
+	};
+}
@@ -38,6 +38,17 @@
 #include "Socket.h"
 #include "SocketException.h"
 #include "CCCWrapperFactory.h"
+#include "NativeCongestionControlFactory.h"
+#include "CongestionControlGroup.h"
+#include "CoupledCongestionControl.h"
+#include "BandwidthShaper.h"
+#include "TokenBucketNode.h"
+#include "BufferAutotuner.h"
+#include "MemoryBudget.h"
+#include "PathMtu.h"
+#include "PacketCapture.h"
+#include "PacketCaptureRing.h"
+#include "SendCompletionQueue.h"
 #include "StdFileStream.h"
 
 #include <fstream>
@@ -133,14 +144,152 @@ void ToSockAddr(System::Net::IPAddress^ address, int port, sockaddr_storage& soc
 	}
 }
 
-Udt::Socket::Socket(UDTSOCKET socket, System::Net::Sockets::AddressFamily family, System::Net::Sockets::SocketType type, ICongestionControlFactory^ congestionControl)
+#pragma managed(push, off)
+
+// One end of a splice. Either a UDT socket or an operating system socket.
+struct SpliceEndPoint
+{
+	bool isUdt;
+	UDTSOCKET udtSocket;
+	SOCKET sysSocket;
+};
+
+enum SpliceStatus
+{
+	SpliceComplete,
+	SpliceReceiveFailed,
+	SpliceSendFailed
+};
+
+// Returns the number of bytes received, 0 if the connection was closed,
+// or -1 on error.
+static int SpliceReceive(const SpliceEndPoint& endPoint, char* buffer, int size, int& sysError)
+{
+	if (endPoint.isUdt)
+	{
+		int received = UDT::recv(endPoint.udtSocket, buffer, size, 0);
+
+		if (UDT::ERROR == received)
+		{
+			// UDT reports a connection closed by the peer as lost once the
+			// receive buffer has been drained.
+			int errorCode = UDT::getlasterror().getErrorCode();
+			return (errorCode == CUDTException::ECONNLOST || errorCode == CUDTException::ENOCONN) ? 0 : -1;
+		}
+
+		return received;
+	}
+	else
+	{
+		int received = ::recv(endPoint.sysSocket, buffer, size, 0);
+
+		if (SOCKET_ERROR == received)
+		{
+			sysError = ::WSAGetLastError();
+			return -1;
+		}
+
+		return received;
+	}
+}
+
+static bool SpliceSend(const SpliceEndPoint& endPoint, const char* buffer, int size, int& sysError)
+{
+	int sent = 0;
+
+	while (sent < size)
+	{
+		int result;
+
+		if (endPoint.isUdt)
+		{
+			result = UDT::send(endPoint.udtSocket, buffer + sent, size - sent, 0);
+			if (UDT::ERROR == result) return false;
+		}
+		else
+		{
+			result = ::send(endPoint.sysSocket, buffer + sent, size - sent, 0);
+
+			if (SOCKET_ERROR == result)
+			{
+				sysError = ::WSAGetLastError();
+				return false;
+			}
+		}
+
+		sent += result;
+	}
+
+	return true;
+}
+
+static SpliceStatus SpliceLoop(const SpliceEndPoint& source, const SpliceEndPoint& destination, char* buffer, int bufferSize, __int64 count, __int64& moved, int& sysError)
+{
+	moved = 0;
+
+	while (count < 0 || moved < count)
+	{
+		int chunk = bufferSize;
+
+		if (count >= 0 && (count - moved) < chunk)
+			chunk = (int)(count - moved);
+
+		int received = SpliceReceive(source, buffer, chunk, sysError);
+
+		if (received < 0) return SpliceReceiveFailed;
+		if (received == 0) break;
+
+		if (!SpliceSend(destination, buffer, received, sysError))
+			return SpliceSendFailed;
+
+		moved += received;
+	}
+
+	return SpliceComplete;
+}
+
+#pragma managed(pop)
+
+System::Exception^ GetSpliceError(const SpliceEndPoint& endPoint, int sysError, String^ message)
+{
+	if (endPoint.isUdt)
+		return Udt::SocketException::GetLastError(message);
+	else
+		return gcnew System::Net::Sockets::SocketException(sysError);
+}
+
+__int64 RunSplice(const SpliceEndPoint& source, const SpliceEndPoint& destination, __int64 count, int bufferSize)
+{
+	std::vector<char> buffer(bufferSize);
+	__int64 moved;
+	int sysError = 0;
+
+	switch (SpliceLoop(source, destination, &buffer[0], bufferSize, count, moved, sysError))
+	{
+	case SpliceReceiveFailed:
+		throw GetSpliceError(source, sysError, "Error receiving data to splice.");
+
+	case SpliceSendFailed:
+		throw GetSpliceError(destination, sysError, "Error sending spliced data.");
+	}
+
+	return moved;
+}
+
+Udt::Socket::Socket(UDTSOCKET socket, System::Net::Sockets::AddressFamily family, System::Net::Sockets::SocketType type, ICongestionControlFactory^ congestionControl, Udt::PacketCapture^ packetCapture)
 {
 	_socket = socket;
 	_isDisposed = false;
 	_addressFamily = family;
 	_socketType = type;
 	_congestionControl = congestionControl;
+	_packetCapture = packetCapture;
 	_blockingSend = GetSocketOptionBoolean(Udt::SocketOptionName::BlockingSend);
+	_connectStagger = DefaultConnectStagger;
+	_shaperNode = NULL;
+	_shaperLock = gcnew Object();
+	_discoverPacketSize = false;
+	_budgetReserved = 0;
 }
 
 Udt::Socket::Socket(System::Net::Sockets::AddressFamily family, System::Net::Sockets::SocketType type)
@@ -149,6 +298,11 @@ Udt::Socket::Socket(System::Net::Sockets::AddressFamily family, System::Net::Soc
 	_addressFamily = family;
 	_socketType = type;
 	_blockingSend = true;
+	_connectStagger = DefaultConnectStagger;
+	_shaperNode = NULL;
+	_shaperLock = gcnew Object();
+	_discoverPacketSize = false;
+	_budgetReserved = 0;
 
 	int socketFamily;
 	int socketType;
@@ -204,7 +358,25 @@ void Udt::Socket::Close(void)
 {
 	if (!_isDisposed)
 	{
+		if (_autotuner != nullptr)
+		{
+			try
+			{
+				_autotuner->Observe(this);
+			}
+			catch (Udt::SocketException^)
+			{
+				// Ignore, the connection is already gone
+			}
+		}
+
 		_isDisposed = true;
+		ReplaceShaper(NULL);
+
+		if (_completions != nullptr)
+			_completions->Cancel();
+
+		ReleaseBudget();
 
 		if (UDT::ERROR == UDT::close(_socket))
 		{
@@ -241,6 +413,9 @@ void Udt::Socket::Bind(IPAddress^ address, int port)
 
 	ToSockAddr(address, port, bind_addr, size);
 
+	if (_budget != nullptr && State == Udt::SocketState::Initial)
+		_budget->Apply(this);
+
 	if (UDT::ERROR == UDT::bind(_socket, (sockaddr*)&bind_addr, size))
 	{
 		if (address->AddressFamily == System::Net::Sockets::AddressFamily::InterNetworkV6)
@@ -271,6 +446,9 @@ void Udt::Socket::Bind(System::Net::Sockets::Socket^ udpSocket)
 	if (udpSocket->ProtocolType != ProtocolType::Udp)
 		throw gcnew ArgumentException(String::Concat("Socket must be a UDP Socket. Socket is ", udpSocket->ProtocolType), "udpSocket");
 
+	if (_budget != nullptr && State == Udt::SocketState::Initial)
+		_budget->Apply(this);
+
 	if (UDT::ERROR == UDT::bind2(_socket, INTPTR_TO_UDTSOCKET(udpSocket->Handle)))
 	{
 		throw Udt::SocketException::GetLastError("Error binding to existing UDP socket.");
@@ -301,7 +479,23 @@ Udt::Socket^ Udt::Socket::Accept()
 	if (client == UDT::INVALID_SOCK)
 		throw Udt::SocketException::GetLastError("Error accepting new connection.");
 
-	return gcnew Socket(client, _addressFamily, _socketType, _congestionControl);
+	Socket^ accepted = gcnew Socket(client, _addressFamily, _socketType, _congestionControl, _packetCapture);
+	accepted->_budget = _budget;
+
+	try
+	{
+		accepted->ReserveBudget();
+	}
+	catch (Udt::SocketException^)
+	{
+		// Drops the connection, the peer sees it closed
+		accepted->Close();
+		throw;
+	}
+
+	accepted->_autotuner = _autotuner;
+	accepted->RegisterCapture();
+	return accepted;
 }
 
 void Udt::Socket::Connect(System::String^ host, int port)
@@ -327,13 +521,25 @@ void Udt::Socket::Connect(System::Net::IPAddress^ address, int port)
 
 	ToSockAddr(address, port, connect_addr, size);
 
+	if (_autotuner != nullptr)
+		_autotuner->Apply(this, address);
+
+	if (_discoverPacketSize)
+		ApplyPathPacketSize(connect_addr);
+
+	ReserveBudget();
+
 	if (UDT::ERROR == UDT::connect(_socket, (sockaddr*)&connect_addr, size))
 	{
+		ReleaseBudget();
+
 		if (address->AddressFamily == System::Net::Sockets::AddressFamily::InterNetworkV6)
 			throw Udt::SocketException::GetLastError(String::Concat("Error connecting to [", address, "]:", (Object^)port));
 		else
 			throw Udt::SocketException::GetLastError(String::Concat("Error connecting to ", address, ":", (Object^)port));
 	}
+
+	RegisterCapture();
 }
 
 void Udt::Socket::Connect(cli::array<System::Net::IPAddress^>^ addresses, int port)
@@ -344,7 +550,311 @@ void Udt::Socket::Connect(cli::array<System::Net::IPAddress^>^ addresses, int po
 	if (addresses->Length == 0)
 		throw gcnew ArgumentException("Value can not be empty.", "addresses");
 
-	Connect(addresses[0], port);
+	AssertNotDisposed();
+
+	if (port < IPEndPoint::MinPort || port > IPEndPoint::MaxPort)
+		throw gcnew ArgumentOutOfRangeException("port", port, String::Concat("Value must be between ", (Object^)IPEndPoint::MinPort, " and ", (Object^)IPEndPoint::MaxPort, "."));
+
+	if (addresses->Length == 1 || Rendezvous)
+	{
+		Connect(addresses[0], port);
+		return;
+	}
+
+	// A bound socket is stuck with its address family
+	bool anyFamily = (State == Udt::SocketState::Initial);
+	List<IPAddress^>^ targets = gcnew List<IPAddress^>(addresses->Length);
+
+	for each (IPAddress^ address in addresses)
+	{
+		if (address == nullptr)
+			throw gcnew ArgumentException("Value can not contain null addresses.", "addresses");
+
+		if (anyFamily || address->AddressFamily == _addressFamily)
+			targets->Add(address);
+	}
+
+	if (targets->Count == 0)
+		throw gcnew ArgumentException(String::Concat("No address is in the socket address family (", _addressFamily, ")."), "addresses");
+
+	// Candidates are unbound, one of them winning would lose the local end point
+	if (targets->Count == 1 || !anyFamily)
+	{
+		Connect(targets[0], port);
+		return;
+	}
+
+	// Candidates copy this socket's options, tune for the first known host
+	if (_autotuner != nullptr)
+	{
+		for each (IPAddress^ address in targets)
+		{
+			if (_autotuner->Apply(this, address))
+				break;
+		}
+	}
+
+	// Candidates copy the fitted buffers, the winner keeps the reservation
+	ReserveBudget();
+
+	try
+	{
+		ConnectParallel(targets, port);
+	}
+	catch (Exception^)
+	{
+		ReleaseBudget();
+		throw;
+	}
+}
+
+String^ FormatEndPoint(IPAddress^ address, int port)
+{
+	if (address->AddressFamily == System::Net::Sockets::AddressFamily::InterNetworkV6)
+		return String::Concat("[", address, "]:", (Object^)port);
+	else
+		return String::Concat(address, ":", (Object^)port);
+}
+
+Udt::Socket^ Udt::Socket::CreateConnectCandidate(System::Net::Sockets::AddressFamily family)
+{
+	cli::array<Udt::SocketOptionName>^ int32Options = {
+		Udt::SocketOptionName::MaxPacketSize,
+		Udt::SocketOptionName::MaxWindowSize,
+		Udt::SocketOptionName::SendBuffer,
+		Udt::SocketOptionName::ReceiveBuffer,
+		Udt::SocketOptionName::UdpSendBuffer,
+		Udt::SocketOptionName::UdpReceiveBuffer,
+		Udt::SocketOptionName::SendTimeout,
+		Udt::SocketOptionName::ReceiveTimeout
+	};
+
+	Udt::Socket^ candidate = gcnew Udt::Socket(family, _socketType);
+
+	try
+	{
+		for each (Udt::SocketOptionName name in int32Options)
+			candidate->SetSocketOptionInt32(name, GetSocketOptionInt32(name));
+
+		candidate->SetSocketOptionInt64(Udt::SocketOptionName::MaxBandwidth, GetSocketOptionInt64(Udt::SocketOptionName::MaxBandwidth));
+		candidate->SetSocketOptionBoolean(Udt::SocketOptionName::ReuseAddress, GetSocketOptionBoolean(Udt::SocketOptionName::ReuseAddress));
+		candidate->SetSocketOptionBoolean(Udt::SocketOptionName::BlockingSend, _blockingSend);
+		candidate->SetSocketOptionBoolean(Udt::SocketOptionName::BlockingReceive, false);
+		candidate->LingerState = LingerState;
+
+		if (_congestionControl != nullptr || _packetCapture != nullptr)
+			candidate->ApplyCongestionControl(_congestionControl, _packetCapture);
+	}
+	catch (Exception^)
+	{
+		candidate->Close();
+		throw;
+	}
+
+	return candidate;
+}
+
+void Udt::Socket::ConnectParallel(IList<IPAddress^>^ addresses, int port)
+{
+	int count = addresses->Count;
+	cli::array<Udt::Socket^>^ candidates = gcnew cli::array<Udt::Socket^>(count);
+	cli::array<__int64>^ deadlines = gcnew cli::array<__int64>(count);
+	cli::array<bool>^ inFlight = gcnew cli::array<bool>(count);
+	Exception^ lastError = nullptr;
+	Udt::Socket^ winner = nullptr;
+	bool selfUsed = false;
+	int started = 0;
+	int pending = 0;
+
+	__int64 staggerMs = (__int64)_connectStagger.TotalMilliseconds;
+	__int64 nextStart = 0;
+	System::Diagnostics::Stopwatch^ clock = System::Diagnostics::Stopwatch::StartNew();
+
+	bool blockingReceive = BlockingReceive;
+	SetSocketOptionBoolean(Udt::SocketOptionName::BlockingReceive, false);
+
+	int epollId = UDT::epoll_create();
+
+	if (epollId < 0)
+	{
+		SetSocketOptionBoolean(Udt::SocketOptionName::BlockingReceive, blockingReceive);
+		throw Udt::SocketException::GetLastError("Error creating epoll id.");
+	}
+
+	try
+	{
+		while (winner == nullptr)
+		{
+			// Start the next attempt when its turn comes, or straight away
+			// when every attempt started so far has failed
+			while (started < count && (pending == 0 || clock->ElapsedMilliseconds >= nextStart))
+			{
+				int i = started++;
+				IPAddress^ address = addresses[i];
+
+				if (!selfUsed && address->AddressFamily == _addressFamily)
+				{
+					candidates[i] = this;
+					selfUsed = true;
+				}
+				else
+				{
+					candidates[i] = CreateConnectCandidate(address->AddressFamily);
+				}
+
+				nextStart = clock->ElapsedMilliseconds + staggerMs;
+				deadlines[i] = clock->ElapsedMilliseconds + ConnectAttemptTimeout;
+
+				sockaddr_storage connect_addr;
+				int size;
+
+				ToSockAddr(address, port, connect_addr, size);
+
+				if (_discoverPacketSize)
+					candidates[i]->ApplyPathPacketSize(connect_addr);
+
+				if (UDT::ERROR == UDT::connect(candidates[i]->_socket, (sockaddr*)&connect_addr, size))
+				{
+					lastError = Udt::SocketException::GetLastError(String::Concat("Error connecting to ", FormatEndPoint(address, port)));
+					continue;
+				}
+
+				int events = UDT_EPOLL_OUT;
+				if (UDT::epoll_add_usock(epollId, candidates[i]->_socket, &events) < 0)
+					throw Udt::SocketException::GetLastError("Error adding UDT socket to epoll.");
+
+				inFlight[i] = true;
+				pending++;
+			}
+
+			if (pending == 0)
+				throw lastError;
+
+			__int64 waitMs = 100;
+
+			if (started < count)
+				waitMs = Math::Max(0LL, Math::Min(waitMs, nextStart - clock->ElapsedMilliseconds));
+
+			// The socket becomes writable when the handshake completes,
+			// failed attempts are picked up from the state checks below
+			std::set<UDTSOCKET> writeSockets;
+
+			if (UDT::epoll_wait(epollId, NULL, &writeSockets, waitMs) < 0 && UDT::getlasterror().getErrorCode() != CUDTException::ETIMEOUT)
+				throw Udt::SocketException::GetLastError("Error waiting for socket epoll.");
+
+			for (int i = 0; i < started && winner == nullptr; i++)
+			{
+				if (!inFlight[i])
+					continue;
+
+				Udt::SocketState state = candidates[i]->State;
+
+				if (state == Udt::SocketState::Connected)
+				{
+					winner = candidates[i];
+				}
+				else if (state != Udt::SocketState::Connecting || clock->ElapsedMilliseconds >= deadlines[i])
+				{
+					inFlight[i] = false;
+					pending--;
+					UDT::epoll_remove_usock(epollId, candidates[i]->_socket);
+
+					lastError = gcnew Udt::SocketException(
+						String::Concat("Error connecting to ", FormatEndPoint(addresses[i], port)),
+						state == Udt::SocketState::Connecting ? Udt::SocketError::NoServer : Udt::SocketError::ConnectionRejected);
+				}
+			}
+		}
+	}
+	catch (Exception^)
+	{
+		try
+		{
+			SetSocketOptionBoolean(Udt::SocketOptionName::BlockingReceive, blockingReceive);
+		}
+		catch (Udt::SocketException^)
+		{
+			// Socket was broken by the failed connect
+		}
+
+		throw;
+	}
+	finally
+	{
+		UDT::epoll_release(epollId);
+
+		for each (Udt::Socket^ candidate in candidates)
+		{
+			if (candidate != nullptr && candidate != this && candidate != winner)
+			{
+				try
+				{
+					candidate->Close();
+				}
+				catch (Udt::SocketException^)
+				{
+					// Ignore, the attempt is abandoned
+				}
+			}
+		}
+	}
+
+	if (winner != this)
+	{
+		// Take over the winning connection and drop our own attempt
+		UDT::close(_socket);
+		_socket = winner->_socket;
+		_addressFamily = winner->_addressFamily;
+		winner->_isDisposed = true;
+	}
+
+	SetSocketOptionBoolean(Udt::SocketOptionName::BlockingReceive, blockingReceive);
+	RegisterCapture();
+}
+
+void Udt::Socket::ApplyPathPacketSize(const sockaddr_storage& destination)
+{
+	// UDT fixes the packet size once the socket is opened by bind
+	if (State != SocketState::Initial)
+		return;
+
+	int packetSize = GetPathPacketSize(destination);
+
+	if (packetSize > 0)
+		SetSocketOptionInt32(Udt::SocketOptionName::MaxPacketSize, packetSize);
+}
+
+void Udt::Socket::ReserveBudget(void)
+{
+	if (_budget != nullptr && _budgetReserved == 0)
+		_budgetReserved = _budget->Reserve(this);
+}
+
+void Udt::Socket::ReleaseBudget(void)
+{
+	if (_budgetReserved != 0)
+	{
+		_budget->Release(_budgetReserved);
+		_budgetReserved = 0;
+	}
+}
+
+void Udt::Socket::Budget::set(MemoryBudget^ value)
+{
+	AssertNotDisposed();
+
+	if (_budgetReserved != 0)
+		throw gcnew InvalidOperationException("Can not change the budget of a socket holding a reservation.");
+
+	_budget = value;
+}
+
+void Udt::Socket::ConnectStagger::set(System::TimeSpan value)
+{
+	if (value < TimeSpan::Zero)
+		throw gcnew ArgumentOutOfRangeException("value", value, "Value must be greater than or equal to 0.");
+
+	_connectStagger = value;
 }
 
 UDT::UDSET* Udt::Socket::CreateUDSet(String^ paramName, System::Collections::Generic::ICollection<Udt::Socket^>^ fds)
@@ -574,39 +1084,95 @@ int Udt::Socket::Send(cli::array<System::Byte>^ buffer, int offset, int size)
 		throw gcnew ArgumentException("Buffer is smaller than specified segment (count + size).", "buffer");
 
 	cli::pin_ptr<unsigned char> buffer_pin = &buffer[0];
-	char* buffer_pin_ptr = (char*)&buffer_pin[offset];
+	return SendBytes((const char*)&buffer_pin[offset], size);
+}
+
+int Udt::Socket::Send(IntPtr data, int size)
+{
+	return Send(data, size, nullptr);
+}
+
+int Udt::Socket::Send(IntPtr data, int size, Action<bool>^ acknowledged)
+{
+	AssertNotDisposed();
+
+	if (data == IntPtr::Zero)
+		throw gcnew ArgumentNullException("data");
+
+	if (size < 0)
+		throw gcnew ArgumentOutOfRangeException("size", size, "Value must be greater than or equal to 0.");
+
+	if (acknowledged != nullptr && _completions == nullptr)
+		_completions = gcnew SendCompletionQueue(_socket, GetSocketOptionInt32(Udt::SocketOptionName::MaxPacketSize));
+
+	int sent = SendBytes((const char*)data.ToPointer(), size);
+
+	if (acknowledged != nullptr && sent > 0)
+		_completions->Add(acknowledged);
+
+	return sent;
+}
+
+int Udt::Socket::SendBytes(const char* data, int size)
+{
 	int sent = 0;
+	TokenBucketNode* shaper = AcquireShaper();
 
-	if (_blockingSend) {
-		// Socket is blocking, but may not send the entire buffer in one send call.
-		// Loop until the entire buffer is sent or an error occurs.
+	try
+	{
+		if (_blockingSend) {
+			// Socket is blocking, but may not send the entire buffer in one send call.
+			// Loop until the entire buffer is sent or an error occurs.
 
-		do {
-			int send_result = UDT::send(_socket, buffer_pin_ptr + sent, size - sent, 0);
+			do {
+				int chunk = size - sent;
 
-			if (UDT::ERROR == send_result)
-			{
-				throw Udt::SocketException::GetLastError("Error sending data.");
-			}
+				if (shaper != NULL)
+				{
+					BandwidthShaper::Wait(shaper);
+					chunk = Math::Min(chunk, (int)BandwidthShaper::SendChunkSize);
+				}
 
-			sent += send_result;
-		} while (sent < size);
-	} else {
-		sent = UDT::send(_socket, buffer_pin_ptr, size, 0);
+				int send_result = UDT::send(_socket, data + sent, chunk, 0);
 
-		if (UDT::ERROR == sent)
-		{
-			if (UDT::getlasterror().getErrorCode() == UDT::ERRORINFO::EASYNCSND)
+				if (UDT::ERROR == send_result)
+				{
+					throw Udt::SocketException::GetLastError("Error sending data.");
+				}
+
+				AccountSent(shaper, send_result);
+				sent += send_result;
+			} while (sent < size);
+		} else {
+			if (shaper != NULL)
 			{
-				// Socket is non-blocking and send queue is full
-				sent = 0;
+				// Shaper has no tokens, same as a full send queue
+				if (shaper->Delay() > 0)
+					return 0;
+
+				size = Math::Min(size, (int)BandwidthShaper::SendChunkSize);
 			}
-			else
+
+			sent = AccountSent(shaper, UDT::send(_socket, data, size, 0));
+
+			if (UDT::ERROR == sent)
 			{
-				throw Udt::SocketException::GetLastError("Error sending data.");
+				if (UDT::getlasterror().getErrorCode() == UDT::ERRORINFO::EASYNCSND)
+				{
+					// Socket is non-blocking and send queue is full
+					sent = 0;
+				}
+				else
+				{
+					throw Udt::SocketException::GetLastError("Error sending data.");
+				}
 			}
 		}
 	}
+	finally
+	{
+		ReleaseShaper(shaper);
+	}
 
 	return sent;
 }
@@ -816,7 +1382,19 @@ int Udt::Socket::SendMessage(cli::array<System::Byte>^ buffer, int offset, int s
 	if ((offset + size) > buffer->Length)
 		throw gcnew ArgumentException("Buffer is smaller than specified segment (count + size).", "buffer");
 
-	return UdtSendMessage(_socket, buffer, offset, size);
+	TokenBucketNode* shaper = AcquireShaper();
+
+	try
+	{
+		if (!WaitForShaper(shaper))
+			return 0;
+
+		return AccountSent(shaper, UdtSendMessage(_socket, buffer, offset, size));
+	}
+	finally
+	{
+		ReleaseShaper(shaper);
+	}
 }
 
 int Udt::Socket::SendMessage(Message^ message)
@@ -828,7 +1406,96 @@ int Udt::Socket::SendMessage(Message^ message)
 
 	ArraySegment<Byte> buffer = message->Buffer;
 	int ttl = (int)message->TimeToLive.TotalMilliseconds;
-	return UdtSendMessage(_socket, buffer.Array, buffer.Offset, buffer.Count, ttl, message->InOrder);
+	TokenBucketNode* shaper = AcquireShaper();
+
+	try
+	{
+		if (!WaitForShaper(shaper))
+			return 0;
+
+		return AccountSent(shaper, UdtSendMessage(_socket, buffer.Array, buffer.Offset, buffer.Count, ttl, message->InOrder));
+	}
+	finally
+	{
+		ReleaseShaper(shaper);
+	}
+}
+
+TokenBucketNode* Udt::Socket::AcquireShaper(void)
+{
+	// Close or the Shaper setter may drop the socket's reference while a send waits
+	System::Threading::Monitor::Enter(_shaperLock);
+
+	try
+	{
+		if (_shaperNode != NULL)
+			_shaperNode->AddRef();
+
+		return _shaperNode;
+	}
+	finally
+	{
+		System::Threading::Monitor::Exit(_shaperLock);
+	}
+}
+
+void Udt::Socket::ReplaceShaper(TokenBucketNode* node)
+{
+	if (node != NULL)
+		node->AddRef();
+
+	System::Threading::Monitor::Enter(_shaperLock);
+
+	try
+	{
+		if (_shaperNode != NULL)
+			_shaperNode->Release();
+
+		_shaperNode = node;
+	}
+	finally
+	{
+		System::Threading::Monitor::Exit(_shaperLock);
+	}
+}
+
+void Udt::Socket::ReleaseShaper(TokenBucketNode* shaper)
+{
+	if (shaper != NULL)
+		shaper->Release();
+}
+
+bool Udt::Socket::WaitForShaper(TokenBucketNode* shaper)
+{
+	if (shaper == NULL)
+		return true;
+
+	if (!_blockingSend)
+		return shaper->Delay() == 0;
+
+	BandwidthShaper::Wait(shaper);
+	return true;
+}
+
+int Udt::Socket::AccountSent(TokenBucketNode* shaper, int sent)
+{
+	if (shaper != NULL && sent > 0)
+		shaper->Charge(sent);
+
+	SendCompletionQueue^ completions = _completions;
+
+	if (completions != nullptr)
+		completions->Count(sent);
+
+	return sent;
+}
+
+void Udt::Socket::Shaper::set(BandwidthShaper^ value)
+{
+	AssertNotDisposed();
+
+	ReplaceShaper(value == nullptr ? NULL : value->Node);
+	_shaper = value;
 }
 
 int Udt::Socket::ReceiveMessage(cli::array<System::Byte>^ buffer)
@@ -868,6 +1535,238 @@ int Udt::Socket::ReceiveMessage(cli::array<System::Byte>^ buffer, int offset, in
 	return result;
 }
 
+void AssertBufferSegment(cli::array<System::Byte>^ buffer, int offset, int size)
+{
+	if (buffer == nullptr)
+		throw gcnew ArgumentNullException("buffer");
+
+	if (offset < 0)
+		throw gcnew ArgumentOutOfRangeException("offset", offset, "Value must be greater than or equal to 0.");
+
+	if (size < 0)
+		throw gcnew ArgumentOutOfRangeException("size", size, "Value must be greater than or equal to 0.");
+
+	if ((offset + size) > buffer->Length)
+		throw gcnew ArgumentException("Buffer is smaller than specified segment (count + size).", "buffer");
+}
+
+Udt::SocketError Udt::Socket::TrySend(cli::array<System::Byte>^ buffer, int offset, int size, int% sent)
+{
+	AssertBufferSegment(buffer, offset, size);
+	sent = 0;
+
+	if (_isDisposed)
+		return Udt::SocketError::InvalidSocket;
+
+	if (size == 0)
+		return Udt::SocketError::Success;
+
+	TokenBucketNode* shaper = AcquireShaper();
+
+	try
+	{
+		if (!WaitForShaper(shaper))
+			return Udt::SocketError::NoSendBuffer;
+
+		if (shaper != NULL)
+			size = Math::Min(size, (int)BandwidthShaper::SendChunkSize);
+
+		cli::pin_ptr<unsigned char> buffer_pin = &buffer[0];
+		int result = UDT::send(_socket, (char*)&buffer_pin[offset], size, 0);
+
+		if (UDT::ERROR == result)
+			return (Udt::SocketError)UDT::getlasterror().getErrorCode();
+
+		sent = AccountSent(shaper, result);
+		return Udt::SocketError::Success;
+	}
+	finally
+	{
+		ReleaseShaper(shaper);
+	}
+}
+
+Udt::SocketError Udt::Socket::TryReceive(cli::array<System::Byte>^ buffer, int offset, int size, int% received)
+{
+	AssertBufferSegment(buffer, offset, size);
+	received = 0;
+
+	if (_isDisposed)
+		return Udt::SocketError::InvalidSocket;
+
+	if (size == 0)
+		return Udt::SocketError::Success;
+
+	cli::pin_ptr<unsigned char> buffer_pin = &buffer[0];
+	int result = UDT::recv(_socket, (char*)&buffer_pin[offset], size, 0);
+
+	if (UDT::ERROR == result)
+		return (Udt::SocketError)UDT::getlasterror().getErrorCode();
+
+	received = result;
+	return Udt::SocketError::Success;
+}
+
+Udt::SocketError Udt::Socket::TrySendMessage(cli::array<System::Byte>^ buffer, int offset, int size, int% sent)
+{
+	AssertBufferSegment(buffer, offset, size);
+	sent = 0;
+
+	if (_isDisposed)
+		return Udt::SocketError::InvalidSocket;
+
+	if (size == 0)
+		return Udt::SocketError::Success;
+
+	TokenBucketNode* shaper = AcquireShaper();
+
+	try
+	{
+		if (!WaitForShaper(shaper))
+			return Udt::SocketError::NoSendBuffer;
+
+		cli::pin_ptr<unsigned char> buffer_pin = &buffer[0];
+		int result = UDT::sendmsg(_socket, (char*)&buffer_pin[offset], size, -1, false);
+
+		if (UDT::ERROR == result)
+			return (Udt::SocketError)UDT::getlasterror().getErrorCode();
+
+		sent = AccountSent(shaper, result);
+		return Udt::SocketError::Success;
+	}
+	finally
+	{
+		ReleaseShaper(shaper);
+	}
+}
+
+Udt::SocketError Udt::Socket::TryReceiveMessage(cli::array<System::Byte>^ buffer, int offset, int size, int% received)
+{
+	AssertBufferSegment(buffer, offset, size);
+	received = 0;
+
+	if (_isDisposed)
+		return Udt::SocketError::InvalidSocket;
+
+	if (size == 0)
+		return Udt::SocketError::Success;
+
+	cli::pin_ptr<unsigned char> buffer_pin = &buffer[0];
+	int result = UDT::recvmsg(_socket, (char*)&buffer_pin[offset], size);
+
+	if (UDT::ERROR == result)
+		return (Udt::SocketError)UDT::getlasterror().getErrorCode();
+
+	received = result;
+	return Udt::SocketError::Success;
+}
+
+void AssertSpliceArgs(__int64 count, int bufferSize)
+{
+	if (count < -1)
+		throw gcnew ArgumentOutOfRangeException("count", count, "Value must be greater than or equal to -1.");
+
+	if (bufferSize < 1)
+		throw gcnew ArgumentOutOfRangeException("bufferSize", bufferSize, "Value must be greater than 0.");
+}
+
+void AssertSpliceSocket(System::Net::Sockets::Socket^ socket, String^ paramName)
+{
+	if (socket == nullptr)
+		throw gcnew ArgumentNullException(paramName);
+
+	if (socket->SocketType != System::Net::Sockets::SocketType::Stream)
+		throw gcnew ArgumentException("Socket type must be Stream.", paramName);
+
+	if (!socket->Blocking)
+		throw gcnew ArgumentException("Socket must be in blocking state.", paramName);
+}
+
+__int64 Udt::Socket::Splice(Udt::Socket^ destination)
+{
+	return Splice(destination, -1, DefaultSpliceBufferSize);
+}
+
+__int64 Udt::Socket::Splice(Udt::Socket^ destination, __int64 count)
+{
+	return Splice(destination, count, DefaultSpliceBufferSize);
+}
+
+__int64 Udt::Socket::Splice(Udt::Socket^ destination, __int64 count, int bufferSize)
+{
+	AssertNotDisposed();
+
+	if (destination == nullptr)
+		throw gcnew ArgumentNullException("destination");
+
+	destination->AssertNotDisposed();
+	AssertSpliceArgs(count, bufferSize);
+
+	if (_socketType != System::Net::Sockets::SocketType::Stream || !BlockingReceive)
+		throw gcnew InvalidOperationException("Socket must be a Stream socket in blocking receive state.");
+
+	if (destination->SocketType != System::Net::Sockets::SocketType::Stream)
+		throw gcnew ArgumentException("Socket type must be Stream.", "destination");
+
+	if (!destination->BlockingSend)
+		throw gcnew ArgumentException("Socket must be in blocking state.", "destination");
+
+	SpliceEndPoint source = { true, _socket, INVALID_SOCKET };
+	SpliceEndPoint target = { true, destination->_socket, INVALID_SOCKET };
+
+	return RunSplice(source, target, count, bufferSize);
+}
+
+__int64 Udt::Socket::Splice(System::Net::Sockets::Socket^ destination)
+{
+	return Splice(destination, -1, DefaultSpliceBufferSize);
+}
+
+__int64 Udt::Socket::Splice(System::Net::Sockets::Socket^ destination, __int64 count)
+{
+	return Splice(destination, count, DefaultSpliceBufferSize);
+}
+
+__int64 Udt::Socket::Splice(System::Net::Sockets::Socket^ destination, __int64 count, int bufferSize)
+{
+	AssertNotDisposed();
+	AssertSpliceSocket(destination, "destination");
+	AssertSpliceArgs(count, bufferSize);
+
+	if (_socketType != System::Net::Sockets::SocketType::Stream || !BlockingReceive)
+		throw gcnew InvalidOperationException("Socket must be a Stream socket in blocking receive state.");
+
+	SpliceEndPoint source = { true, _socket, INVALID_SOCKET };
+	SpliceEndPoint target = { false, UDT::INVALID_SOCK, (SOCKET)INTPTR_TO_UDTSOCKET(destination->Handle) };
+
+	return RunSplice(source, target, count, bufferSize);
+}
+
+__int64 Udt::Socket::SpliceFrom(System::Net::Sockets::Socket^ source)
+{
+	return SpliceFrom(source, -1, DefaultSpliceBufferSize);
+}
+
+__int64 Udt::Socket::SpliceFrom(System::Net::Sockets::Socket^ source, __int64 count)
+{
+	return SpliceFrom(source, count, DefaultSpliceBufferSize);
+}
+
+__int64 Udt::Socket::SpliceFrom(System::Net::Sockets::Socket^ source, __int64 count, int bufferSize)
+{
+	AssertNotDisposed();
+	AssertSpliceSocket(source, "source");
+	AssertSpliceArgs(count, bufferSize);
+
+	if (_socketType != System::Net::Sockets::SocketType::Stream || !_blockingSend)
+		throw gcnew InvalidOperationException("Socket must be a Stream socket in blocking send state.");
+
+	SpliceEndPoint from = { false, UDT::INVALID_SOCK, (SOCKET)INTPTR_TO_UDTSOCKET(source->Handle) };
+	SpliceEndPoint target = { true, _socket, INVALID_SOCKET };
+
+	return RunSplice(from, target, count, bufferSize);
+}
+
 void Udt::Socket::SetSocketOptionInt32(Udt::SocketOptionName name, int value)
 {
 	AssertNotDisposed();
@@ -1057,26 +1956,11 @@ void Udt::Socket::SetSocketOption(Udt::SocketOptionName name, System::Object^ va
 		{
 			if (value == nullptr)
 			{
-				CCCFactory<CUDTCC> factory;
-
-				if (UDT::ERROR == UDT::setsockopt(_socket, 0, (UDT::SOCKOPT)name, &factory, sizeof(CCCVirtualFactory)))
-				{
-					throw Udt::SocketException::GetLastError(String::Concat("Error clearing socket option ", name.ToString(), "."));
-				}
-
-				_congestionControl = nullptr;
+				ApplyCongestionControl(nullptr, _packetCapture);
 			}
 			else if (ICongestionControlFactory::typeid->IsAssignableFrom(value->GetType()))
 			{
-				ICongestionControlFactory^ ccValue = (ICongestionControlFactory^)value;
-				CCCWrapperFactory factory(ccValue);
-
-				if (UDT::ERROR == UDT::setsockopt(_socket, 0, (UDT::SOCKOPT)name, &factory, sizeof(CCCWrapperFactory)))
-				{
-					throw Udt::SocketException::GetLastError(String::Concat("Error setting socket option ", name.ToString(), " to ", value->ToString(), "."));
-				}
-
-				_congestionControl = ccValue;
+				ApplyCongestionControl((ICongestionControlFactory^)value, _packetCapture);
 			}
 			else
 			{
@@ -1125,6 +2009,69 @@ void Udt::Socket::SetSocketOption(Udt::SocketOptionName name, System::Object^ va
 	}
 }
 
+void Udt::Socket::ApplyCongestionControl(ICongestionControlFactory^ congestionControl, Udt::PacketCapture^ packetCapture)
+{
+	Udt::SocketOptionName name = Udt::SocketOptionName::CongestionControl;
+	int result;
+
+	NativeCongestionControlFactory^ native = dynamic_cast<NativeCongestionControlFactory^>(congestionControl);
+
+	CongestionControlGroup^ group = dynamic_cast<CongestionControlGroup^>(congestionControl);
+
+	if (native != nullptr)
+	{
+		result = UDT::setsockopt(_socket, 0, (UDT::SOCKOPT)name, native->Factory, sizeof(CCCVirtualFactory));
+	}
+	else if (group != nullptr)
+	{
+		CoupledCCFactory factory(group->State, packetCapture == nullptr ? NULL : packetCapture->Ring);
+		result = UDT::setsockopt(_socket, 0, (UDT::SOCKOPT)name, &factory, sizeof(CoupledCCFactory));
+	}
+	else if (congestionControl != nullptr)
+	{
+		CCCWrapperFactory factory(congestionControl, packetCapture == nullptr ? NULL : packetCapture->Ring);
+		result = UDT::setsockopt(_socket, 0, (UDT::SOCKOPT)name, &factory, sizeof(CCCWrapperFactory));
+	}
+	else if (packetCapture != nullptr)
+	{
+		CapturingUDTCCFactory factory(packetCapture->Ring);
+		result = UDT::setsockopt(_socket, 0, (UDT::SOCKOPT)name, &factory, sizeof(CapturingUDTCCFactory));
+	}
+	else
+	{
+		CCCFactory<CUDTCC> factory;
+		result = UDT::setsockopt(_socket, 0, (UDT::SOCKOPT)name, &factory, sizeof(CCCVirtualFactory));
+	}
+
+	if (UDT::ERROR == result)
+	{
+		if (congestionControl == nullptr && packetCapture == nullptr)
+			throw Udt::SocketException::GetLastError(String::Concat("Error clearing socket option ", name.ToString(), "."));
+		else
+			throw Udt::SocketException::GetLastError(String::Concat("Error setting socket option ", name.ToString(), "."));
+	}
+
+	_congestionControl = congestionControl;
+	_packetCapture = packetCapture;
+}
+
+void Udt::Socket::PacketCapture::set(Udt::PacketCapture^ value)
+{
+	AssertNotDisposed();
+
+	if (value != nullptr && value->IsDisposed)
+		throw gcnew ObjectDisposedException(value->ToString());
+
+	if (value != _packetCapture)
+		ApplyCongestionControl(_congestionControl, value);
+}
+
+void Udt::Socket::RegisterCapture(void)
+{
+	if (_packetCapture != nullptr && !_packetCapture->IsDisposed)
+		_packetCapture->Register(this);
+}
+
 System::Object^ Udt::Socket::GetSocketOption(Udt::SocketOptionName name)
 {
 	switch (name)
@@ -44,6 +44,12 @@
 namespace Udt
 {
 	interface class ICongestionControlFactory;
+	ref class PacketCapture;
+	ref class BandwidthShaper;
+	ref class BufferAutotuner;
+	ref class MemoryBudget;
+	ref class SendCompletionQueue;
+	class TokenBucketNode;
 
 	/// <summary>
 	/// Interface to a UDT socket.
@@ -56,7 +62,17 @@ namespace Udt
 		System::Net::Sockets::AddressFamily _addressFamily;
 		System::Net::Sockets::SocketType _socketType;
 		ICongestionControlFactory^ _congestionControl;
+		Udt::PacketCapture^ _packetCapture;
 		bool _blockingSend;
+		System::TimeSpan _connectStagger;
+		BandwidthShaper^ _shaper;
+		TokenBucketNode* _shaperNode;
+		System::Object^ _shaperLock;
+		BufferAutotuner^ _autotuner;
+		MemoryBudget^ _budget;
+		__int64 _budgetReserved;
+		bool _discoverPacketSize;
+		SendCompletionQueue^ _completions;
 
 		void AssertNotDisposed(void)
 		{
@@ -64,7 +80,7 @@ namespace Udt
 				throw gcnew System::ObjectDisposedException(this->ToString());
 		}
 
-		Socket(UDTSOCKET socket, System::Net::Sockets::AddressFamily family, System::Net::Sockets::SocketType type, ICongestionControlFactory^ congestionControl);
+		Socket(UDTSOCKET socket, System::Net::Sockets::AddressFamily family, System::Net::Sockets::SocketType type, ICongestionControlFactory^ congestionControl, Udt::PacketCapture^ packetCapture);
 
 		static Socket(void)
 		{
@@ -88,10 +104,28 @@ namespace Udt
 		void SetSocketOptionInt64(SocketOptionName name, __int64 value);
 		void SetSocketOptionBoolean(SocketOptionName name, bool value);
 
+		void ApplyCongestionControl(ICongestionControlFactory^ congestionControl, Udt::PacketCapture^ packetCapture);
+		void RegisterCapture(void);
+
+		TokenBucketNode* AcquireShaper(void);
+		void ReplaceShaper(TokenBucketNode* node);
+		static void ReleaseShaper(TokenBucketNode* shaper);
+		bool WaitForShaper(TokenBucketNode* shaper);
+		int SendBytes(const char* data, int size);
+		int AccountSent(TokenBucketNode* shaper, int sent);
+
 		static UDT::UDSET* CreateUDSet(System::String^ paramName, System::Collections::Generic::ICollection<Udt::Socket^>^ fds);
 		static void FillSocketList(const std::vector<UDTSOCKET>* list, System::Collections::Generic::Dictionary<UDTSOCKET, Udt::Socket^>^ sockets, System::Collections::Generic::ICollection<Udt::Socket^>^ fds);
 		static void Filter(UDT::UDSET* set, System::Collections::Generic::ICollection<Udt::Socket^>^ fds);
 
+		literal int ConnectAttemptTimeout = 3000;
+
+		void ConnectParallel(System::Collections::Generic::IList<System::Net::IPAddress^>^ addresses, int port);
+		Socket^ CreateConnectCandidate(System::Net::Sockets::AddressFamily family);
+		void ApplyPathPacketSize(const sockaddr_storage& destination);
+		void ReserveBudget(void);
+		void ReleaseBudget(void);
+
 	internal:
 
 		property UDTSOCKET Handle
@@ -106,6 +140,11 @@ namespace Udt
 		/// </summary>
 		static initonly System::TimeSpan InfiniteTimeout = System::TimeSpan(-1L);
 
+		/// <summary>
+		/// Default value of <see cref="ConnectStagger"/>.
+		/// </summary>
+		static initonly System::TimeSpan DefaultConnectStagger = System::TimeSpan::FromMilliseconds(250);
+
 		/// <summary>
 		/// Initialize a new instance using the specified address family and
 		/// socket type.
@@ -224,6 +263,9 @@ namespace Udt
 		/// <b>Accept</b> synchronously extracts the first pending connection
 		/// request from the connection request queue of the listening socket,
 		/// and then creates and returns a new <see cref="Socket"/>.
+		/// If the connection does not fit in the <see cref="Budget"/>, it
+		/// is closed and <b>Accept</b> fails with
+		/// <see cref="SocketError::NoBuffer"/>; the socket keeps listening.
 		/// </remarks>
 		/// <exception cref="Udt::SocketException">If an error occurs.</exception>
 		Socket^ Accept();
@@ -261,6 +303,21 @@ namespace Udt
 		/// <summary>
 		/// Establishes a connection to a remote host.
 		/// </summary>
+		/// <remarks>
+		/// <para>
+		/// When more than one address is given, handshakes are started
+		/// on separate UDT sockets, one every <see cref="ConnectStagger"/>
+		/// in address order (sooner if all started attempts have failed).
+		/// The first connection to complete is kept and the other attempts
+		/// are closed. Options set on this socket are copied to the extra
+		/// sockets before they connect.
+		/// </para>
+		/// <para>
+		/// A socket that has been bound only tries the first address in its
+		/// own family, the extra sockets could not share its local end
+		/// point. Rendezvous sockets only try the first address.
+		/// </para>
+		/// </remarks>
 		/// <param name="addresses">Addresses of the host to connect to.</param>
 		/// <param name="port">Port to connect to.</param>
 		/// <exception cref="System::ArgumentNullException">
@@ -388,6 +445,49 @@ namespace Udt
 		/// <exception cref="Udt::SocketException">If an error occurs.</exception>
 		int Send(cli::array<System::Byte>^ buffer, int offset, int size);
 
+		/// <summary>
+		/// Send bytes from native memory.
+		/// </summary>
+		/// <remarks>
+		/// Same as <see cref="Send(cli::array&lt;System::Byte&gt;^, int, int)"/>
+		/// without a managed array to fill or pin. UDT copies the data into
+		/// its send buffer, so the memory may be reused when the call
+		/// returns.
+		/// </remarks>
+		/// <param name="data">Address of the first byte to send.</param>
+		/// <param name="size">Number of bytes to send.</param>
+		/// <returns>The total number of bytes sent.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="data"/> is zero.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="size"/> is less than zero.</exception>
+		/// <exception cref="Udt::SocketException">If an error occurs.</exception>
+		int Send(System::IntPtr data, int size);
+
+		/// <summary>
+		/// Send bytes from native memory and get notified when the peer has
+		/// acknowledged them.
+		/// </summary>
+		/// <remarks>
+		/// <para>
+		/// Same as <see cref="Send(System::IntPtr, int)"/>. If any bytes
+		/// were sent, <paramref name="acknowledged"/> is called on a timer
+		/// thread with true once the peer has acknowledged them, or false
+		/// when the socket is closed or the connection breaks first. The
+		/// callback must not throw.
+		/// </para>
+		/// <para>
+		/// Data sent earlier, including with <c>SendFile</c>, is
+		/// acknowledged first, so it delays the notification too.
+		/// </para>
+		/// </remarks>
+		/// <param name="data">Address of the first byte to send.</param>
+		/// <param name="size">Number of bytes to send.</param>
+		/// <param name="acknowledged">Called once the bytes sent are acknowledged, or null.</param>
+		/// <returns>The total number of bytes sent.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="data"/> is zero.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="size"/> is less than zero.</exception>
+		/// <exception cref="Udt::SocketException">If an error occurs; <paramref name="acknowledged"/> is not called.</exception>
+		int Send(System::IntPtr data, int size, System::Action<bool>^ acknowledged);
+
 		/// <summary>
 		/// Send the contents of a file on this socket.
 		/// </summary>
@@ -450,6 +550,305 @@ namespace Udt
 		int ReceiveMessage(cli::array<System::Byte>^ buffer);
 		int ReceiveMessage(cli::array<System::Byte>^ buffer, int offset, int size);
 
+		/// <summary>
+		/// Send data with one UDT call, reporting failure as an error code
+		/// instead of an exception.
+		/// </summary>
+		/// <remarks>
+		/// Meant for polling loops on non-blocking sockets, where a full
+		/// send buffer is the normal case: that returns
+		/// <see cref="SocketError::NoSendBuffer"/> without building a
+		/// <see cref="SocketException"/>. A blocking socket may send only
+		/// part of the buffer. Invalid arguments still throw.
+		/// </remarks>
+		/// <param name="buffer">Buffer containing the data to send.</param>
+		/// <param name="offset">Position in <paramref name="buffer"/> of the first byte to send.</param>
+		/// <param name="size">Number of bytes to send.</param>
+		/// <param name="sent">Number of bytes sent, or 0 on error.</param>
+		/// <returns><see cref="SocketError::Success"/> or the UDT error.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="buffer"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="offset"/> or <paramref name="size"/> is less than 0.</exception>
+		/// <exception cref="System::ArgumentException">If <paramref name="buffer"/> is smaller than the segment.</exception>
+		Udt::SocketError TrySend(cli::array<System::Byte>^ buffer, int offset, int size, [System::Runtime::InteropServices::Out] int% sent);
+
+		/// <summary>
+		/// Receive data with one UDT call, reporting failure as an error
+		/// code instead of an exception.
+		/// </summary>
+		/// <remarks>
+		/// A non-blocking socket with no data ready returns
+		/// <see cref="SocketError::NoDataAvailable"/>. Invalid arguments
+		/// still throw.
+		/// </remarks>
+		/// <param name="buffer">Buffer to store the received data in.</param>
+		/// <param name="offset">Position in <paramref name="buffer"/> to store the first byte.</param>
+		/// <param name="size">Largest number of bytes to receive.</param>
+		/// <param name="received">Number of bytes received, or 0 on error.</param>
+		/// <returns><see cref="SocketError::Success"/> or the UDT error.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="buffer"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="offset"/> or <paramref name="size"/> is less than 0.</exception>
+		/// <exception cref="System::ArgumentException">If <paramref name="buffer"/> is smaller than the segment.</exception>
+		Udt::SocketError TryReceive(cli::array<System::Byte>^ buffer, int offset, int size, [System::Runtime::InteropServices::Out] int% received);
+
+		/// <summary>
+		/// Send a message, reporting failure as an error code instead of an
+		/// exception.
+		/// </summary>
+		/// <remarks>
+		/// Same as <see cref="TrySend"/> for
+		/// <see cref="SendMessage(cli::array&lt;System::Byte&gt;^, int, int)"/>.
+		/// </remarks>
+		/// <param name="buffer">Buffer containing the message.</param>
+		/// <param name="offset">Position in <paramref name="buffer"/> of the first byte of the message.</param>
+		/// <param name="size">Size of the message.</param>
+		/// <param name="sent">Number of bytes sent, or 0 on error.</param>
+		/// <returns><see cref="SocketError::Success"/> or the UDT error.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="buffer"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="offset"/> or <paramref name="size"/> is less than 0.</exception>
+		/// <exception cref="System::ArgumentException">If <paramref name="buffer"/> is smaller than the segment.</exception>
+		Udt::SocketError TrySendMessage(cli::array<System::Byte>^ buffer, int offset, int size, [System::Runtime::InteropServices::Out] int% sent);
+
+		/// <summary>
+		/// Receive a message, reporting failure as an error code instead of
+		/// an exception.
+		/// </summary>
+		/// <remarks>
+		/// Same as <see cref="TryReceive"/> for
+		/// <see cref="ReceiveMessage(cli::array&lt;System::Byte&gt;^, int, int)"/>.
+		/// </remarks>
+		/// <param name="buffer">Buffer to store the message in.</param>
+		/// <param name="offset">Position in <paramref name="buffer"/> to store the first byte.</param>
+		/// <param name="size">Largest number of bytes to receive.</param>
+		/// <param name="received">Number of bytes received, or 0 on error.</param>
+		/// <returns><see cref="SocketError::Success"/> or the UDT error.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="buffer"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="offset"/> or <paramref name="size"/> is less than 0.</exception>
+		/// <exception cref="System::ArgumentException">If <paramref name="buffer"/> is smaller than the segment.</exception>
+		Udt::SocketError TryReceiveMessage(cli::array<System::Byte>^ buffer, int offset, int size, [System::Runtime::InteropServices::Out] int% received);
+
+		/// <summary>
+		/// Move data received on this socket to another socket until the
+		/// connection is closed.
+		/// </summary>
+		/// <remarks>
+		/// Same as <c>Splice(destination, -1, DefaultSpliceBufferSize)</c>.
+		/// </remarks>
+		/// <param name="destination">Socket to send the received data on.</param>
+		/// <returns>The total number of bytes moved.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="destination"/> is null.</exception>
+		/// <exception cref="System::ArgumentException">
+		/// If <paramref name="destination"/> is not a <c>Stream</c> socket or is not in blocking send mode.
+		/// </exception>
+		/// <exception cref="System::InvalidOperationException">
+		/// If this socket is not a <c>Stream</c> socket or is not in blocking receive mode.
+		/// </exception>
+		/// <exception cref="Udt::SocketException">If an error occurs receiving or sending data.</exception>
+		__int64 Splice(Udt::Socket^ destination);
+
+		/// <summary>
+		/// Move data received on this socket to another socket.
+		/// </summary>
+		/// <remarks>
+		/// Same as <c>Splice(destination, count, DefaultSpliceBufferSize)</c>.
+		/// </remarks>
+		/// <param name="destination">Socket to send the received data on.</param>
+		/// <param name="count">Number of bytes to move or -1 to move until the connection is closed.</param>
+		/// <returns>The total number of bytes moved.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="destination"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="count"/> is less than -1.</exception>
+		/// <exception cref="System::ArgumentException">
+		/// If <paramref name="destination"/> is not a <c>Stream</c> socket or is not in blocking send mode.
+		/// </exception>
+		/// <exception cref="System::InvalidOperationException">
+		/// If this socket is not a <c>Stream</c> socket or is not in blocking receive mode.
+		/// </exception>
+		/// <exception cref="Udt::SocketException">If an error occurs receiving or sending data.</exception>
+		__int64 Splice(Udt::Socket^ destination, __int64 count);
+
+		/// <summary>
+		/// Move data received on this socket to another socket.
+		/// </summary>
+		/// <remarks>
+		/// <para>
+		/// The data is moved by a native receive/send loop through a single
+		/// buffer of <paramref name="bufferSize"/> bytes that is reused for
+		/// every chunk. No managed code runs per chunk.
+		/// </para>
+		/// <para>
+		/// Both sockets must be in blocking mode. A chunk is not received
+		/// until the previous chunk has been fully accepted by
+		/// <paramref name="destination"/>, so a slow destination applies
+		/// backpressure to the sender through the UDT flow window.
+		/// </para>
+		/// <para>
+		/// The loop ends when <paramref name="count"/> bytes have been moved
+		/// or the connection of this socket is closed. To relay in both
+		/// directions, call <b>Splice</b> on each socket from separate threads.
+		/// </para>
+		/// </remarks>
+		/// <param name="destination">Socket to send the received data on.</param>
+		/// <param name="count">Number of bytes to move or -1 to move until the connection is closed.</param>
+		/// <param name="bufferSize">Size of the buffer used to move data, in bytes.</param>
+		/// <returns>The total number of bytes moved.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="destination"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">
+		/// If <paramref name="count"/> is less than -1 or <paramref name="bufferSize"/> is less than 1.
+		/// </exception>
+		/// <exception cref="System::ArgumentException">
+		/// If <paramref name="destination"/> is not a <c>Stream</c> socket or is not in blocking send mode.
+		/// </exception>
+		/// <exception cref="System::InvalidOperationException">
+		/// If this socket is not a <c>Stream</c> socket or is not in blocking receive mode.
+		/// </exception>
+		/// <exception cref="Udt::SocketException">If an error occurs receiving or sending data.</exception>
+		__int64 Splice(Udt::Socket^ destination, __int64 count, int bufferSize);
+
+		/// <summary>
+		/// Move data received on this socket to an operating system socket
+		/// (i.e. a TCP connection) until the connection is closed.
+		/// </summary>
+		/// <remarks>
+		/// Same as <c>Splice(destination, -1, DefaultSpliceBufferSize)</c>.
+		/// </remarks>
+		/// <param name="destination">Socket to send the received data on.</param>
+		/// <returns>The total number of bytes moved.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="destination"/> is null.</exception>
+		/// <exception cref="System::ArgumentException">
+		/// If <paramref name="destination"/> is not a <c>Stream</c> socket or is not in blocking mode.
+		/// </exception>
+		/// <exception cref="System::InvalidOperationException">
+		/// If this socket is not a <c>Stream</c> socket or is not in blocking receive mode.
+		/// </exception>
+		/// <exception cref="Udt::SocketException">If an error occurs receiving data.</exception>
+		/// <exception cref="System::Net::Sockets::SocketException">If an error occurs sending data.</exception>
+		__int64 Splice(System::Net::Sockets::Socket^ destination);
+
+		/// <summary>
+		/// Move data received on this socket to an operating system socket
+		/// (i.e. a TCP connection).
+		/// </summary>
+		/// <remarks>
+		/// Same as <c>Splice(destination, count, DefaultSpliceBufferSize)</c>.
+		/// </remarks>
+		/// <param name="destination">Socket to send the received data on.</param>
+		/// <param name="count">Number of bytes to move or -1 to move until the connection is closed.</param>
+		/// <returns>The total number of bytes moved.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="destination"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="count"/> is less than -1.</exception>
+		/// <exception cref="System::ArgumentException">
+		/// If <paramref name="destination"/> is not a <c>Stream</c> socket or is not in blocking mode.
+		/// </exception>
+		/// <exception cref="System::InvalidOperationException">
+		/// If this socket is not a <c>Stream</c> socket or is not in blocking receive mode.
+		/// </exception>
+		/// <exception cref="Udt::SocketException">If an error occurs receiving data.</exception>
+		/// <exception cref="System::Net::Sockets::SocketException">If an error occurs sending data.</exception>
+		__int64 Splice(System::Net::Sockets::Socket^ destination, __int64 count);
+
+		/// <summary>
+		/// Move data received on this socket to an operating system socket
+		/// (i.e. a TCP connection).
+		/// </summary>
+		/// <remarks>
+		/// See <see cref="Splice(Udt::Socket^,__int64,int)"/>. <paramref name="destination"/>
+		/// must be a connected, blocking stream socket.
+		/// </remarks>
+		/// <param name="destination">Socket to send the received data on.</param>
+		/// <param name="count">Number of bytes to move or -1 to move until the connection is closed.</param>
+		/// <param name="bufferSize">Size of the buffer used to move data, in bytes.</param>
+		/// <returns>The total number of bytes moved.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="destination"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">
+		/// If <paramref name="count"/> is less than -1 or <paramref name="bufferSize"/> is less than 1.
+		/// </exception>
+		/// <exception cref="System::ArgumentException">
+		/// If <paramref name="destination"/> is not a <c>Stream</c> socket or is not in blocking mode.
+		/// </exception>
+		/// <exception cref="System::InvalidOperationException">
+		/// If this socket is not a <c>Stream</c> socket or is not in blocking receive mode.
+		/// </exception>
+		/// <exception cref="Udt::SocketException">If an error occurs receiving data.</exception>
+		/// <exception cref="System::Net::Sockets::SocketException">If an error occurs sending data.</exception>
+		__int64 Splice(System::Net::Sockets::Socket^ destination, __int64 count, int bufferSize);
+
+		/// <summary>
+		/// Move data received on an operating system socket (i.e. a TCP
+		/// connection) to this socket until <paramref name="source"/> is
+		/// shut down by the remote host.
+		/// </summary>
+		/// <remarks>
+		/// Same as <c>SpliceFrom(source, -1, DefaultSpliceBufferSize)</c>.
+		/// </remarks>
+		/// <param name="source">Socket to receive data from.</param>
+		/// <returns>The total number of bytes moved.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="source"/> is null.</exception>
+		/// <exception cref="System::ArgumentException">
+		/// If <paramref name="source"/> is not a <c>Stream</c> socket or is not in blocking mode.
+		/// </exception>
+		/// <exception cref="System::InvalidOperationException">
+		/// If this socket is not a <c>Stream</c> socket or is not in blocking send mode.
+		/// </exception>
+		/// <exception cref="System::Net::Sockets::SocketException">If an error occurs receiving data.</exception>
+		/// <exception cref="Udt::SocketException">If an error occurs sending data.</exception>
+		__int64 SpliceFrom(System::Net::Sockets::Socket^ source);
+
+		/// <summary>
+		/// Move data received on an operating system socket (i.e. a TCP
+		/// connection) to this socket.
+		/// </summary>
+		/// <remarks>
+		/// Same as <c>SpliceFrom(source, count, DefaultSpliceBufferSize)</c>.
+		/// </remarks>
+		/// <param name="source">Socket to receive data from.</param>
+		/// <param name="count">Number of bytes to move or -1 to move until the connection is closed.</param>
+		/// <returns>The total number of bytes moved.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="source"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="count"/> is less than -1.</exception>
+		/// <exception cref="System::ArgumentException">
+		/// If <paramref name="source"/> is not a <c>Stream</c> socket or is not in blocking mode.
+		/// </exception>
+		/// <exception cref="System::InvalidOperationException">
+		/// If this socket is not a <c>Stream</c> socket or is not in blocking send mode.
+		/// </exception>
+		/// <exception cref="System::Net::Sockets::SocketException">If an error occurs receiving data.</exception>
+		/// <exception cref="Udt::SocketException">If an error occurs sending data.</exception>
+		__int64 SpliceFrom(System::Net::Sockets::Socket^ source, __int64 count);
+
+		/// <summary>
+		/// Move data received on an operating system socket (i.e. a TCP
+		/// connection) to this socket.
+		/// </summary>
+		/// <remarks>
+		/// See <see cref="Splice(Udt::Socket^,__int64,int)"/>. <paramref name="source"/>
+		/// must be a connected, blocking stream socket. The loop ends when
+		/// <paramref name="count"/> bytes have been moved or <paramref name="source"/>
+		/// is shut down by the remote host.
+		/// </remarks>
+		/// <param name="source">Socket to receive data from.</param>
+		/// <param name="count">Number of bytes to move or -1 to move until the connection is closed.</param>
+		/// <param name="bufferSize">Size of the buffer used to move data, in bytes.</param>
+		/// <returns>The total number of bytes moved.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="source"/> is null.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">
+		/// If <paramref name="count"/> is less than -1 or <paramref name="bufferSize"/> is less than 1.
+		/// </exception>
+		/// <exception cref="System::ArgumentException">
+		/// If <paramref name="source"/> is not a <c>Stream</c> socket or is not in blocking mode.
+		/// </exception>
+		/// <exception cref="System::InvalidOperationException">
+		/// If this socket is not a <c>Stream</c> socket or is not in blocking send mode.
+		/// </exception>
+		/// <exception cref="System::Net::Sockets::SocketException">If an error occurs receiving data.</exception>
+		/// <exception cref="Udt::SocketException">If an error occurs sending data.</exception>
+		__int64 SpliceFrom(System::Net::Sockets::Socket^ source, __int64 count, int bufferSize);
+
+		/// <summary>
+		/// Default buffer size, in bytes, used by the <b>Splice</b> and
+		/// <b>SpliceFrom</b> overloads without a buffer size.
+		/// </summary>
+		/// <value>65,536</value>
+		literal int DefaultSpliceBufferSize = 65536;
+
 		/// <summary>
 		/// Retrieve internal protocol parameters and performance trace.
 		/// </summary>
@@ -569,6 +968,86 @@ namespace Udt
 			void set(bool value) { SetSocketOptionBoolean(Udt::SocketOptionName::BlockingReceive, value); }
 		}
 
+		/// <summary>
+		/// Get or set the delay between starting connection attempts when
+		/// connecting to multiple addresses.
+		/// </summary>
+		/// <remarks>
+		/// Defaults to <see cref="DefaultConnectStagger"/>. A value of
+		/// <see cref="System::TimeSpan::Zero"/> starts all attempts at once.
+		/// </remarks>
+		/// <exception cref="System::ArgumentOutOfRangeException">If the value is negative.</exception>
+		property System::TimeSpan ConnectStagger
+		{
+			System::TimeSpan get(void) { return _connectStagger; }
+			void set(System::TimeSpan value);
+		}
+
+		/// <summary>
+		/// Get or set the capture that records the packets and congestion
+		/// control events of this socket, or null to not capture.
+		/// </summary>
+		/// <remarks>
+		/// Must be set before the socket connects or listens. Sockets
+		/// accepted by this socket record to the same capture.
+		/// </remarks>
+		/// <exception cref="System::ObjectDisposedException">If the capture has been disposed.</exception>
+		/// <exception cref="SocketException">If the socket is already connected or listening.</exception>
+		property Udt::PacketCapture^ PacketCapture
+		{
+			Udt::PacketCapture^ get(void) { return _packetCapture; }
+			void set(Udt::PacketCapture^ value);
+		}
+
+		/// <summary>
+		/// Get or set the bandwidth shaper that limits data sent by this
+		/// socket, or null to not shape.
+		/// </summary>
+		/// <remarks>
+		/// Shaped blocking sends wait for the shaper and hand data to UDT
+		/// in pieces of at most <see cref="BandwidthShaper::SendChunkSize"/>
+		/// bytes. Shaped non-blocking sends return 0 while the shaper has
+		/// no tokens. Sockets accepted by this socket are not shaped.
+		/// </remarks>
+		/// <exception cref="System::ObjectDisposedException">If the socket or the shaper has been disposed.</exception>
+		property BandwidthShaper^ Shaper
+		{
+			BandwidthShaper^ get(void) { return _shaper; }
+			void set(BandwidthShaper^ value);
+		}
+
+		/// <summary>
+		/// Get or set the autotuner that sizes this socket's buffers and
+		/// flow window before it connects, or null to keep them as set.
+		/// </summary>
+		/// <remarks>
+		/// The socket reports its path measurements to the autotuner when
+		/// it closes. Sockets accepted by this socket use the same
+		/// autotuner.
+		/// </remarks>
+		property BufferAutotuner^ Autotuner
+		{
+			BufferAutotuner^ get(void) { return _autotuner; }
+			void set(BufferAutotuner^ value) { AssertNotDisposed(); _autotuner = value; }
+		}
+
+		/// <summary>
+		/// Get or set the memory budget this socket's buffers are counted
+		/// against, or null to leave them uncounted.
+		/// </summary>
+		/// <remarks>
+		/// The buffers are fitted to the budget when the socket binds or
+		/// connects, and reserved until it closes. Sockets accepted by this
+		/// socket use the same budget. Set it after the autotuner has been
+		/// set, the budget applies on top of it.
+		/// </remarks>
+		/// <exception cref="System::InvalidOperationException">If the socket holds a reservation in the current budget.</exception>
+		property MemoryBudget^ Budget
+		{
+			MemoryBudget^ get(void) { return _budget; }
+			void set(MemoryBudget^ value);
+		}
+
 		property bool Rendezvous
 		{
 			bool get(void) { return GetSocketOptionBoolean(Udt::SocketOptionName::Rendezvous); }
@@ -600,6 +1079,27 @@ namespace Udt
 			}
 		}
 
+		/// <summary>
+		/// Get or set whether <see cref="MaxPacketSize"/> is chosen from the
+		/// path MTU when the socket connects.
+		/// </summary>
+		/// <remarks>
+		/// When true, connecting sets <see cref="MaxPacketSize"/> to the
+		/// largest packet that fits the path MTU Windows has discovered for
+		/// the destination, up to 9000 bytes. If none has been discovered,
+		/// the MTU of the outgoing interface is used up to 1500 bytes,
+		/// since a later hop may be smaller. Read
+		/// <see cref="MaxPacketSize"/> after connecting to see the chosen
+		/// size. A socket bound before it connects keeps its configured
+		/// size, since UDT no longer accepts it. Defaults to false, which
+		/// keeps the configured size.
+		/// </remarks>
+		property bool DiscoverPacketSize
+		{
+			bool get(void) { return _discoverPacketSize; }
+			void set(bool value) { AssertNotDisposed(); _discoverPacketSize = value; }
+		}
+
 		property int MaxPacketSize
 		{
 			int get(void) { return GetSocketOptionInt32(Udt::SocketOptionName::MaxPacketSize); }
@@ -653,7 +1153,9 @@ namespace Udt
 		/// </summary>
 		/// <remarks>
 		/// The custom congestion control algorithm will be passed to any
-		/// sockets accepted by this socket.
+		/// sockets accepted by this socket. Assign a
+		/// <see cref="NativeCongestionControlFactory"/> to run a C++
+		/// algorithm without entering the CLR.
 		/// </remarks>
 		property ICongestionControlFactory^ CongestionControl
 		{
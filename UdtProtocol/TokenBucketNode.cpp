@@ -0,0 +1,245 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+
+#include <udt.h>
+
+#include "TokenBucketNode.h"
+#include "MicrosecondClock.h"
+
+using namespace Udt;
+
+#pragma managed(push, off)
+
+TokenBucketNode::TokenBucketNode(TokenBucketNode* parent, double rate, double ceiling, double burst)
+	: _parent(parent), _root(parent == NULL ? this : parent->_root), _references(1),
+	_rate(rate), _ceiling(ceiling), _burst(burst), _rateTokens(burst), _ceilingTokens(burst),
+	_bytesSent(0), _bytesBorrowed(0), _throttleCount(0), _throttled(false)
+{
+	if (_parent != NULL)
+		_parent->AddRef();
+	else
+		InitializeCriticalSection(&_lock);
+
+	_lastRefill = MicrosecondClock::Now();
+}
+
+TokenBucketNode::~TokenBucketNode(void)
+{
+	if (_parent != NULL)
+		_parent->Release();
+	else
+		DeleteCriticalSection(&_lock);
+}
+
+void TokenBucketNode::AddRef(void)
+{
+	InterlockedIncrement(&_references);
+}
+
+void TokenBucketNode::Release(void)
+{
+	if (InterlockedDecrement(&_references) == 0)
+		delete this;
+}
+
+void TokenBucketNode::Refill(__int64 now)
+{
+	double elapsed = (now - _lastRefill) / 1000000.0;
+	_lastRefill = now;
+
+	_rateTokens += elapsed * _rate;
+	if (_rateTokens > _burst) _rateTokens = _burst;
+
+	_ceilingTokens += elapsed * _ceiling;
+	if (_ceilingTokens > _burst) _ceilingTokens = _burst;
+}
+
+__int64 TokenBucketNode::Delay(void)
+{
+	__int64 now = MicrosecondClock::Now();
+	double ceilingWait = 0;
+	double rateWait = -1;
+
+	EnterCriticalSection(&_root->_lock);
+
+	for (TokenBucketNode* node = this; node != NULL; node = node->_parent)
+	{
+		node->Refill(now);
+
+		if (node->_ceilingTokens <= 0)
+		{
+			double wait = node->_ceiling > 0 ? (1 - node->_ceilingTokens) * 1000000.0 / node->_ceiling : 1000000.0;
+			if (wait > ceilingWait) ceilingWait = wait;
+		}
+
+		// Wait for the first node on the path that can lend
+		if (node->_rateTokens > 0)
+		{
+			rateWait = 0;
+		}
+		else if (node->_rate > 0)
+		{
+			double wait = (1 - node->_rateTokens) * 1000000.0 / node->_rate;
+			if (rateWait < 0 || wait < rateWait) rateWait = wait;
+		}
+	}
+
+	if (rateWait < 0)
+		rateWait = 1000000.0;
+
+	__int64 delay = (__int64)(ceilingWait > rateWait ? ceilingWait : rateWait);
+
+	if (delay > 0)
+		_throttled = true;
+
+	LeaveCriticalSection(&_root->_lock);
+
+	return delay;
+}
+
+void TokenBucketNode::Charge(int bytes)
+{
+	__int64 now = MicrosecondClock::Now();
+
+	EnterCriticalSection(&_root->_lock);
+
+	TokenBucketNode* lender = NULL;
+
+	for (TokenBucketNode* node = this; node != NULL; node = node->_parent)
+	{
+		node->Refill(now);
+
+		if (lender == NULL && node->_rateTokens > 0)
+			lender = node;
+	}
+
+	// Nobody can lend; the leaf goes into debt
+	if (lender == NULL)
+		lender = this;
+
+	bool charging = false;
+
+	for (TokenBucketNode* node = this; node != NULL; node = node->_parent)
+	{
+		if (node == lender)
+			charging = true;
+
+		if (charging)
+			node->_rateTokens -= bytes;
+		else
+			node->_bytesBorrowed += bytes;
+
+		node->_ceilingTokens -= bytes;
+		node->_bytesSent += bytes;
+	}
+
+	if (_throttled)
+	{
+		++_throttleCount;
+		_throttled = false;
+	}
+
+	LeaveCriticalSection(&_root->_lock);
+}
+
+void TokenBucketNode::SetRates(double rate, double ceiling, double burst)
+{
+	EnterCriticalSection(&_root->_lock);
+
+	Refill(MicrosecondClock::Now());
+	_rate = rate;
+	_ceiling = ceiling;
+	_burst = burst;
+
+	if (_rateTokens > _burst) _rateTokens = _burst;
+	if (_ceilingTokens > _burst) _ceilingTokens = _burst;
+
+	LeaveCriticalSection(&_root->_lock);
+}
+
+double TokenBucketNode::Rate(void)
+{
+	EnterCriticalSection(&_root->_lock);
+	double value = _rate;
+	LeaveCriticalSection(&_root->_lock);
+
+	return value;
+}
+
+double TokenBucketNode::Ceiling(void)
+{
+	EnterCriticalSection(&_root->_lock);
+	double value = _ceiling;
+	LeaveCriticalSection(&_root->_lock);
+
+	return value;
+}
+
+double TokenBucketNode::Burst(void)
+{
+	EnterCriticalSection(&_root->_lock);
+	double value = _burst;
+	LeaveCriticalSection(&_root->_lock);
+
+	return value;
+}
+
+__int64 TokenBucketNode::BytesSent(void)
+{
+	EnterCriticalSection(&_root->_lock);
+	__int64 value = _bytesSent;
+	LeaveCriticalSection(&_root->_lock);
+
+	return value;
+}
+
+__int64 TokenBucketNode::BytesBorrowed(void)
+{
+	EnterCriticalSection(&_root->_lock);
+	__int64 value = _bytesBorrowed;
+	LeaveCriticalSection(&_root->_lock);
+
+	return value;
+}
+
+__int64 TokenBucketNode::ThrottleCount(void)
+{
+	EnterCriticalSection(&_root->_lock);
+	__int64 value = _throttleCount;
+	LeaveCriticalSection(&_root->_lock);
+
+	return value;
+}
+
+#pragma managed(pop)
@@ -0,0 +1,113 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	/// <summary>
+	/// One node of a hierarchical token bucket shaper.
+	/// </summary>
+	/// <remarks>
+	/// Each node has two buckets, as in Linux HTB. The rate bucket fills at
+	/// the node's assured rate and the ceiling bucket at the most it may
+	/// send including borrowed share. Sending from a leaf takes rate tokens
+	/// from the nearest node on the path to the root that has any, so an
+	/// idle sibling's share is lent through their common parent, and
+	/// charges that node and everything above it. Every ceiling bucket on
+	/// the path must allow the send. Buckets may go into debt by one send,
+	/// which is repaid before the next one. The whole tree shares the
+	/// root's lock; nodes hold a reference to their parent.
+	/// </remarks>
+	class TokenBucketNode
+	{
+	private:
+		TokenBucketNode* _parent;
+		TokenBucketNode* _root;
+		CRITICAL_SECTION _lock;
+		volatile LONG _references;
+
+		double _rate;
+		double _ceiling;
+		double _burst;
+		double _rateTokens;
+		double _ceilingTokens;
+		__int64 _lastRefill;
+
+		__int64 _bytesSent;
+		__int64 _bytesBorrowed;
+		__int64 _throttleCount;
+		bool _throttled;
+
+		TokenBucketNode(const TokenBucketNode&);
+		TokenBucketNode& operator=(const TokenBucketNode&);
+
+		~TokenBucketNode(void);
+
+		void Refill(__int64 now);
+
+	public:
+
+		TokenBucketNode(TokenBucketNode* parent, double rate, double ceiling, double burst);
+
+		void AddRef(void);
+		void Release(void);
+
+		/// <summary>
+		/// Get the time until this node may send, in microseconds, or 0 if
+		/// it may send now.
+		/// </summary>
+		/// <remarks>
+		/// A delay marks the next send as throttled; polling again until
+		/// it may send does not count again.
+		/// </remarks>
+		__int64 Delay(void);
+
+		/// <summary>
+		/// Take tokens for bytes that were sent through this node, and
+		/// count the send if it had to wait.
+		/// </summary>
+		void Charge(int bytes);
+
+		/// <summary>
+		/// Change the rates; takes effect for the next send.
+		/// </summary>
+		void SetRates(double rate, double ceiling, double burst);
+
+		double Rate(void);
+		double Ceiling(void);
+		double Burst(void);
+		__int64 BytesSent(void);
+		__int64 BytesBorrowed(void);
+		__int64 ThrottleCount(void);
+	};
+}
@@ -0,0 +1,140 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "UdtClient.h"
+
+#include "NetworkStream.h"
+#include "Socket.h"
+
+using namespace System;
+using namespace System::Net;
+using namespace Udt;
+
+UdtClient::UdtClient(void)
+{
+	_client = gcnew Udt::Socket(System::Net::Sockets::AddressFamily::InterNetwork, System::Net::Sockets::SocketType::Stream);
+}
+
+UdtClient::UdtClient(System::Net::Sockets::AddressFamily family)
+{
+	_client = gcnew Udt::Socket(family, System::Net::Sockets::SocketType::Stream);
+}
+
+UdtClient::UdtClient(String^ host, int port)
+{
+	if (host == nullptr)
+		throw gcnew ArgumentNullException("host");
+
+	// Pick the socket family from the first address, as Socket::Connect does
+	cli::array<IPAddress^>^ addresses = Dns::GetHostAddresses(host);
+
+	if (addresses->Length == 0)
+		throw gcnew ArgumentException("Host has no addresses.", "host");
+
+	_client = gcnew Udt::Socket(addresses[0]->AddressFamily, System::Net::Sockets::SocketType::Stream);
+
+	try
+	{
+		_client->Connect(addresses, port);
+	}
+	catch (Exception^)
+	{
+		_client->Close();
+		throw;
+	}
+}
+
+UdtClient::UdtClient(Udt::Socket^ socket)
+{
+	_client = socket;
+}
+
+UdtClient::~UdtClient(void)
+{
+	Close();
+}
+
+void UdtClient::AssertNotDisposed(void)
+{
+	if (_isDisposed)
+		throw gcnew ObjectDisposedException(this->ToString());
+}
+
+void UdtClient::Close(void)
+{
+	if (!_isDisposed)
+	{
+		_isDisposed = true;
+
+		if (_stream != nullptr)
+			delete _stream;
+
+		_client->Close();
+	}
+}
+
+void UdtClient::Connect(String^ host, int port)
+{
+	AssertNotDisposed();
+	_client->Connect(host, port);
+}
+
+void UdtClient::Connect(IPAddress^ address, int port)
+{
+	AssertNotDisposed();
+	_client->Connect(address, port);
+}
+
+void UdtClient::Connect(IPEndPoint^ endPoint)
+{
+	AssertNotDisposed();
+	_client->Connect(endPoint);
+}
+
+Udt::NetworkStream^ UdtClient::GetStream(void)
+{
+	AssertNotDisposed();
+
+	if (!Connected)
+		throw gcnew InvalidOperationException("The operation is not allowed on non-connected sockets.");
+
+	if (_stream == nullptr)
+		_stream = gcnew Udt::NetworkStream(_client, false);
+
+	return _stream;
+}
+
+bool UdtClient::Connected::get(void)
+{
+	return _client->State == Udt::SocketState::Connected;
+}
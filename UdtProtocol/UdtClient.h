@@ -0,0 +1,165 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	ref class Socket;
+	ref class NetworkStream;
+
+	/// <summary>
+	/// Provides client connections for UDT stream network services.
+	/// </summary>
+	public ref class UdtClient
+	{
+	private:
+		Udt::Socket^ _client;
+		Udt::NetworkStream^ _stream;
+		bool _isDisposed;
+
+		void AssertNotDisposed(void);
+
+	internal:
+
+		UdtClient(Udt::Socket^ socket);
+
+	public:
+
+		/// <summary>
+		/// Initialize a new instance using an IPv4 stream socket.
+		/// </summary>
+		/// <exception cref="Udt::SocketException">If an error occurs creating the socket.</exception>
+		UdtClient(void);
+
+		/// <summary>
+		/// Initialize a new instance using the specified address family.
+		/// </summary>
+		/// <param name="family">Address family.</param>
+		/// <exception cref="System::ArgumentException">
+		/// <paramref name="family"/> is not either <c>InterNetwork</c> or <c>InterNetworkV6</c>
+		/// </exception>
+		/// <exception cref="Udt::SocketException">If an error occurs creating the socket.</exception>
+		UdtClient(System::Net::Sockets::AddressFamily family);
+
+		/// <summary>
+		/// Initialize a new instance and connect to the specified host.
+		/// </summary>
+		/// <param name="host">Name of the host to connect to.</param>
+		/// <param name="port">Port to connect to.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="host"/> is a null reference.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">
+		/// If <paramref name="port"/> is less than <see cref="System::Net::IPEndPoint::MinPort"/>
+		/// or greater than <see cref="System::Net::IPEndPoint::MaxPort"/>.
+		/// </exception>
+		/// <exception cref="Udt::SocketException">If an error occurs.</exception>
+		UdtClient(System::String^ host, int port);
+
+		/// <summary>
+		/// Closes the client.
+		/// </summary>
+		~UdtClient(void);
+
+		/// <summary>
+		/// Close the network stream and the underlying socket.
+		/// </summary>
+		void Close(void);
+
+		/// <summary>
+		/// Establishes a connection to a remote host.
+		/// </summary>
+		/// <param name="host">Name of the host to connect to.</param>
+		/// <param name="port">Port to connect to.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="host"/> is a null reference.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">
+		/// If <paramref name="port"/> is less than <see cref="System::Net::IPEndPoint::MinPort"/>
+		/// or greater than <see cref="System::Net::IPEndPoint::MaxPort"/>.
+		/// </exception>
+		/// <exception cref="Udt::SocketException">If an error occurs.</exception>
+		/// <exception cref="System::ObjectDisposedException">If the client has been closed.</exception>
+		void Connect(System::String^ host, int port);
+
+		/// <summary>
+		/// Establishes a connection to a remote host.
+		/// </summary>
+		/// <param name="address">Address of the host to connect to.</param>
+		/// <param name="port">Port to connect to.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="address"/> is a null reference.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">
+		/// If <paramref name="port"/> is less than <see cref="System::Net::IPEndPoint::MinPort"/>
+		/// or greater than <see cref="System::Net::IPEndPoint::MaxPort"/>.
+		/// </exception>
+		/// <exception cref="Udt::SocketException">If an error occurs.</exception>
+		/// <exception cref="System::ObjectDisposedException">If the client has been closed.</exception>
+		void Connect(System::Net::IPAddress^ address, int port);
+
+		/// <summary>
+		/// Establishes a connection to a remote host.
+		/// </summary>
+		/// <param name="endPoint">Remote end point to connect to.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="endPoint"/> is a null reference.</exception>
+		/// <exception cref="Udt::SocketException">If an error occurs.</exception>
+		/// <exception cref="System::ObjectDisposedException">If the client has been closed.</exception>
+		[System::Diagnostics::CodeAnalysis::SuppressMessageAttribute(
+			"Microsoft.Naming",
+			"CA1702:CompoundWordsShouldBeCasedCorrectly",
+			Justification = "EndPoint is the casing used in IPEndPoint")]
+		void Connect(System::Net::IPEndPoint^ endPoint);
+
+		/// <summary>
+		/// Get the stream used to send and receive data.
+		/// </summary>
+		/// <remarks>
+		/// The same stream is returned on every call. The stream does not own
+		/// the socket; closing the client closes both.
+		/// </remarks>
+		/// <exception cref="System::InvalidOperationException">If the client is not connected.</exception>
+		/// <exception cref="System::ObjectDisposedException">If the client has been closed.</exception>
+		Udt::NetworkStream^ GetStream(void);
+
+		/// <summary>
+		/// Get the underlying socket.
+		/// </summary>
+		property Udt::Socket^ Client
+		{
+			Udt::Socket^ get(void) { return _client; }
+		}
+
+		/// <summary>
+		/// Get if the underlying socket is connected.
+		/// </summary>
+		property bool Connected
+		{
+			bool get(void);
+		}
+	};
+}
@@ -0,0 +1,166 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "UdtClientPool.h"
+
+#include "UdtClient.h"
+#include "Socket.h"
+
+using namespace System;
+using namespace System::Collections::Concurrent;
+using namespace System::Collections::Generic;
+using namespace System::Net;
+using namespace Udt;
+
+UdtClientPool::UdtClientPool(void)
+{
+	_idle = gcnew ConcurrentDictionary<IPEndPoint^, ConcurrentStack<UdtClient^>^>();
+	_maxIdlePerEndPoint = DefaultMaxIdlePerEndPoint;
+}
+
+UdtClientPool::UdtClientPool(int maxIdlePerEndPoint)
+{
+	if (maxIdlePerEndPoint < 0)
+		throw gcnew ArgumentOutOfRangeException("maxIdlePerEndPoint", maxIdlePerEndPoint, "Value must be greater than or equal to 0.");
+
+	_idle = gcnew ConcurrentDictionary<IPEndPoint^, ConcurrentStack<UdtClient^>^>();
+	_maxIdlePerEndPoint = maxIdlePerEndPoint;
+}
+
+UdtClientPool::~UdtClientPool(void)
+{
+	_isDisposed = true;
+	Clear();
+}
+
+void UdtClientPool::AssertNotDisposed(void)
+{
+	if (_isDisposed)
+		throw gcnew ObjectDisposedException(this->ToString());
+}
+
+ConcurrentStack<UdtClient^>^ UdtClientPool::GetIdle(IPEndPoint^ endPoint)
+{
+	ConcurrentStack<UdtClient^>^ idle;
+
+	if (!_idle->TryGetValue(endPoint, idle))
+		idle = _idle->GetOrAdd(endPoint, gcnew ConcurrentStack<UdtClient^>());
+
+	return idle;
+}
+
+UdtClient^ UdtClientPool::Rent(IPEndPoint^ endPoint)
+{
+	if (endPoint == nullptr)
+		throw gcnew ArgumentNullException("endPoint");
+
+	AssertNotDisposed();
+
+	// Most recently returned first, it is the least likely to have
+	// been dropped by the peer
+	ConcurrentStack<UdtClient^>^ idle = GetIdle(endPoint);
+	UdtClient^ client;
+
+	while (idle->TryPop(client))
+	{
+		if (client->Connected)
+			return client;
+
+		client->Close();
+	}
+
+	client = gcnew UdtClient(endPoint->AddressFamily);
+
+	try
+	{
+		client->Connect(endPoint);
+	}
+	catch (Exception^)
+	{
+		client->Close();
+		throw;
+	}
+
+	return client;
+}
+
+void UdtClientPool::Return(IPEndPoint^ endPoint, UdtClient^ client)
+{
+	if (endPoint == nullptr)
+		throw gcnew ArgumentNullException("endPoint");
+
+	if (client == nullptr)
+		throw gcnew ArgumentNullException("client");
+
+	if (_isDisposed || !client->Connected)
+	{
+		client->Close();
+		return;
+	}
+
+	ConcurrentStack<UdtClient^>^ idle = GetIdle(endPoint);
+
+	// The count check races with other returns, the limit is approximate
+	if (idle->Count >= _maxIdlePerEndPoint)
+	{
+		client->Close();
+		return;
+	}
+
+	idle->Push(client);
+
+	// Clear may have run between the disposed check and the push
+	if (_isDisposed)
+		Clear();
+}
+
+void UdtClientPool::Clear(void)
+{
+	for each (KeyValuePair<IPEndPoint^, ConcurrentStack<UdtClient^>^> entry in _idle)
+	{
+		UdtClient^ client;
+
+		while (entry.Value->TryPop(client))
+			client->Close();
+	}
+}
+
+int UdtClientPool::IdleCount::get(void)
+{
+	int count = 0;
+
+	for each (KeyValuePair<IPEndPoint^, ConcurrentStack<UdtClient^>^> entry in _idle)
+		count += entry.Value->Count;
+
+	return count;
+}
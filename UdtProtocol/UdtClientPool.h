@@ -0,0 +1,154 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	ref class UdtClient;
+
+	/// <summary>
+	/// Keeps established <see cref="UdtClient"/> connections so they can be
+	/// reused for later requests to the same remote end point.
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// A UDT handshake costs several round trips. Renting a pooled
+	/// connection skips it when a warm connection to the end point is idle.
+	/// </para>
+	/// <para>
+	/// A client must only be returned when the application protocol leaves
+	/// the connection in a clean state (no unread or partially written data).
+	/// Clients that are no longer connected are discarded.
+	/// </para>
+	/// <para>
+	/// All members are thread safe.
+	/// </para>
+	/// </remarks>
+	public ref class UdtClientPool
+	{
+	private:
+		System::Collections::Concurrent::ConcurrentDictionary<System::Net::IPEndPoint^, System::Collections::Concurrent::ConcurrentStack<Udt::UdtClient^>^>^ _idle;
+		int _maxIdlePerEndPoint;
+		bool _isDisposed;
+
+		void AssertNotDisposed(void);
+		System::Collections::Concurrent::ConcurrentStack<Udt::UdtClient^>^ GetIdle(System::Net::IPEndPoint^ endPoint);
+
+	public:
+
+		/// <summary>
+		/// Default value of <see cref="MaxIdlePerEndPoint"/>.
+		/// </summary>
+		[System::Diagnostics::CodeAnalysis::SuppressMessageAttribute(
+			"Microsoft.Naming",
+			"CA1702:CompoundWordsShouldBeCasedCorrectly",
+			Justification = "EndPoint is the casing used in IPEndPoint")]
+		literal int DefaultMaxIdlePerEndPoint = 8;
+
+		/// <summary>
+		/// Initialize a new instance.
+		/// </summary>
+		UdtClientPool(void);
+
+		/// <summary>
+		/// Initialize a new instance.
+		/// </summary>
+		/// <param name="maxIdlePerEndPoint">Maximum number of idle connections kept for each end point.</param>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="maxIdlePerEndPoint"/> is less than 0.</exception>
+		UdtClientPool(int maxIdlePerEndPoint);
+
+		/// <summary>
+		/// Closes all idle connections.
+		/// </summary>
+		~UdtClientPool(void);
+
+		/// <summary>
+		/// Get a connected client for the specified end point, reusing an
+		/// idle connection if one is available.
+		/// </summary>
+		/// <param name="endPoint">Remote end point.</param>
+		/// <returns>Connected client.</returns>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="endPoint"/> is a null reference.</exception>
+		/// <exception cref="Udt::SocketException">If a new connection is required and an error occurs connecting.</exception>
+		/// <exception cref="System::ObjectDisposedException">If the pool has been disposed.</exception>
+		[System::Diagnostics::CodeAnalysis::SuppressMessageAttribute(
+			"Microsoft.Naming",
+			"CA1702:CompoundWordsShouldBeCasedCorrectly",
+			Justification = "EndPoint is the casing used in IPEndPoint")]
+		Udt::UdtClient^ Rent(System::Net::IPEndPoint^ endPoint);
+
+		/// <summary>
+		/// Return a client obtained from <see cref="Rent"/> to the pool.
+		/// </summary>
+		/// <remarks>
+		/// The client is closed instead of being kept if it is no longer
+		/// connected, the pool for the end point is full or the pool has
+		/// been disposed.
+		/// </remarks>
+		/// <param name="endPoint">End point the client was rented for.</param>
+		/// <param name="client">Client to return.</param>
+		/// <exception cref="System::ArgumentNullException">
+		/// If <paramref name="endPoint"/> or <paramref name="client"/> is a null reference.
+		/// </exception>
+		[System::Diagnostics::CodeAnalysis::SuppressMessageAttribute(
+			"Microsoft.Naming",
+			"CA1702:CompoundWordsShouldBeCasedCorrectly",
+			Justification = "EndPoint is the casing used in IPEndPoint")]
+		void Return(System::Net::IPEndPoint^ endPoint, Udt::UdtClient^ client);
+
+		/// <summary>
+		/// Close all idle connections.
+		/// </summary>
+		void Clear(void);
+
+		/// <summary>
+		/// Get the maximum number of idle connections kept for each end point.
+		/// </summary>
+		[System::Diagnostics::CodeAnalysis::SuppressMessageAttribute(
+			"Microsoft.Naming",
+			"CA1702:CompoundWordsShouldBeCasedCorrectly",
+			Justification = "EndPoint is the casing used in IPEndPoint")]
+		property int MaxIdlePerEndPoint
+		{
+			int get(void) { return _maxIdlePerEndPoint; }
+		}
+
+		/// <summary>
+		/// Get the total number of idle connections in the pool.
+		/// </summary>
+		property int IdleCount
+		{
+			int get(void);
+		}
+	};
+}
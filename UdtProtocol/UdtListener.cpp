@@ -0,0 +1,293 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#include "StdAfx.h"
+#include "UdtListener.h"
+
+#include "Socket.h"
+#include "SocketException.h"
+#include "UdtClient.h"
+
+#include <udt.h>
+
+using namespace System;
+using namespace System::Collections::Concurrent;
+using namespace System::Net;
+using namespace System::Threading;
+using namespace Udt;
+
+UdtListener::UdtListener(IPEndPoint^ localEP)
+{
+	if (localEP == nullptr)
+		throw gcnew ArgumentNullException("localEP");
+
+	_endPoint = localEP;
+	_queueCapacity = DefaultQueueCapacity;
+	_epollId = -1;
+}
+
+UdtListener::UdtListener(IPAddress^ localaddr, int port)
+{
+	if (localaddr == nullptr)
+		throw gcnew ArgumentNullException("localaddr");
+
+	if (port < IPEndPoint::MinPort || port > IPEndPoint::MaxPort)
+		throw gcnew ArgumentOutOfRangeException("port", port, String::Concat("Value must be between ", (Object^)IPEndPoint::MinPort, " and ", (Object^)IPEndPoint::MaxPort, "."));
+
+	_endPoint = gcnew IPEndPoint(localaddr, port);
+	_queueCapacity = DefaultQueueCapacity;
+	_epollId = -1;
+}
+
+UdtListener::UdtListener(IPEndPoint^ localEP, int queueCapacity)
+{
+	if (localEP == nullptr)
+		throw gcnew ArgumentNullException("localEP");
+
+	if (queueCapacity < 1)
+		throw gcnew ArgumentOutOfRangeException("queueCapacity", queueCapacity, "Value must be greater than 0.");
+
+	_endPoint = localEP;
+	_queueCapacity = queueCapacity;
+	_epollId = -1;
+}
+
+UdtListener::~UdtListener(void)
+{
+	Stop();
+}
+
+void UdtListener::AssertActive(void)
+{
+	if (!_active)
+		throw gcnew InvalidOperationException("Not listening. You must call the Start() method before calling this method.");
+}
+
+void UdtListener::Start(void)
+{
+	Start(DefaultBacklog);
+}
+
+void UdtListener::Start(int backlog)
+{
+	if (backlog < 1)
+		throw gcnew ArgumentOutOfRangeException("backlog", backlog, "Value must be greater than 0.");
+
+	if (_active)
+		return;
+
+	Udt::Socket^ server = gcnew Udt::Socket(_endPoint->AddressFamily, System::Net::Sockets::SocketType::Stream);
+
+	try
+	{
+		server->Bind(_endPoint);
+		server->Listen(backlog);
+
+		_epollId = UDT::epoll_create();
+
+		if (_epollId < 0)
+			throw Udt::SocketException::GetLastError("Error creating epoll id.");
+
+		// Only wait for incoming connections, a listening socket is
+		// always reported as writable.
+		int events = UDT_EPOLL_IN;
+		if (UDT::epoll_add_usock(_epollId, server->Handle, &events) < 0)
+			throw Udt::SocketException::GetLastError("Error adding UDT socket to epoll.");
+	}
+	catch (Exception^)
+	{
+		if (_epollId >= 0)
+		{
+			UDT::epoll_release(_epollId);
+			_epollId = -1;
+		}
+
+		server->Close();
+		throw;
+	}
+
+	_server = server;
+	_acceptError = nullptr;
+	_stopSource = gcnew CancellationTokenSource();
+	_pending = gcnew BlockingCollection<Udt::Socket^>(gcnew ConcurrentQueue<Udt::Socket^>(), _queueCapacity);
+	_active = true;
+
+	_acceptThread = gcnew Thread(gcnew ThreadStart(this, &UdtListener::AcceptLoop));
+	_acceptThread->IsBackground = true;
+	_acceptThread->Name = String::Concat("UdtListener ", _server->LocalEndPoint);
+	_acceptThread->Start();
+}
+
+void UdtListener::Stop(void)
+{
+	if (!_active)
+		return;
+
+	_active = false;
+	_stopSource->Cancel();
+	_acceptThread->Join();
+	_acceptThread = nullptr;
+
+	UDT::epoll_release(_epollId);
+	_epollId = -1;
+
+	_server->Close();
+	_server = nullptr;
+
+	BlockingCollection<Udt::Socket^>^ pending = _pending;
+	_pending = nullptr;
+
+	Udt::Socket^ socket;
+	while (pending->TryTake(socket))
+		socket->Close();
+
+	delete pending;
+	delete _stopSource;
+	_stopSource = nullptr;
+}
+
+void UdtListener::AcceptLoop(void)
+{
+	CancellationToken stopToken = _stopSource->Token;
+	std::set<UDTSOCKET> readSockets;
+
+	try
+	{
+		while (!stopToken.IsCancellationRequested)
+		{
+			readSockets.clear();
+
+			if (UDT::epoll_wait(_epollId, &readSockets, NULL, AcceptPollMilliseconds) < 0)
+			{
+				if (UDT::getlasterror().getErrorCode() == CUDTException::ETIMEOUT)
+					continue;
+
+				throw Udt::SocketException::GetLastError("Error waiting for socket epoll.");
+			}
+
+			if (readSockets.empty())
+				continue;
+
+			Udt::Socket^ socket;
+
+			try
+			{
+				socket = _server->Accept();
+			}
+			catch (Udt::SocketException^)
+			{
+				// Only this connection is lost, e.g. it did not fit the server's budget
+				continue;
+			}
+
+			try
+			{
+				_pending->Add(socket, stopToken);
+			}
+			catch (OperationCanceledException^)
+			{
+				socket->Close();
+				break;
+			}
+		}
+	}
+	catch (Exception^ ex)
+	{
+		if (!stopToken.IsCancellationRequested)
+			_acceptError = ex;
+	}
+	finally
+	{
+		_pending->CompleteAdding();
+	}
+}
+
+bool UdtListener::Pending(void)
+{
+	AssertActive();
+	return _pending->Count > 0;
+}
+
+Udt::Socket^ UdtListener::AcceptSocket(void)
+{
+	return AcceptSocket(Udt::Socket::InfiniteTimeout);
+}
+
+Udt::Socket^ UdtListener::AcceptSocket(TimeSpan timeout)
+{
+	int timeoutMs;
+
+	if (timeout == Udt::Socket::InfiniteTimeout)
+		timeoutMs = Timeout::Infinite;
+	else if (timeout < TimeSpan::Zero || timeout.TotalMilliseconds > Int32::MaxValue)
+		throw gcnew ArgumentOutOfRangeException("timeout", timeout, "Value must be InfiniteTimeout or between 0 and Int32.MaxValue milliseconds.");
+	else
+		timeoutMs = (int)timeout.TotalMilliseconds;
+
+	AssertActive();
+
+	BlockingCollection<Udt::Socket^>^ pending = _pending;
+	Udt::Socket^ socket;
+
+	try
+	{
+		if (pending->TryTake(socket, timeoutMs))
+			return socket;
+
+		if (pending->IsCompleted)
+			throw gcnew InvalidOperationException("Listener has stopped accepting connections.", _acceptError);
+	}
+	catch (ObjectDisposedException^)
+	{
+		// Stopped by another thread
+		throw gcnew InvalidOperationException("Listener has stopped accepting connections.");
+	}
+
+	return nullptr;
+}
+
+Udt::UdtClient^ UdtListener::AcceptUdtClient(void)
+{
+	return gcnew UdtClient(AcceptSocket());
+}
+
+IPEndPoint^ UdtListener::LocalEndPoint::get(void)
+{
+	Udt::Socket^ server = _server;
+	return server == nullptr ? _endPoint : server->LocalEndPoint;
+}
+
+int UdtListener::PendingCount::get(void)
+{
+	BlockingCollection<Udt::Socket^>^ pending = _pending;
+	return pending == nullptr ? 0 : pending->Count;
+}
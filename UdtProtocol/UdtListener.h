@@ -0,0 +1,233 @@
+/*****************************************************************
+ *
+ * BSD LICENCE (http://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Copyright (c) 2010, Cory Thomas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the <ORGANIZATION> nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************/
+
+#pragma once
+
+namespace Udt
+{
+	ref class Socket;
+	ref class UdtClient;
+
+	/// <summary>
+	/// Listens for connections from UDT network clients.
+	/// </summary>
+	/// <remarks>
+	/// <para>
+	/// Connections are accepted on a dedicated background thread as soon as
+	/// they arrive and are placed in a bounded queue until they are
+	/// retrieved with <see cref="AcceptSocket"/> or <see cref="AcceptUdtClient"/>.
+	/// A slow consumer therefore never delays the UDT handshake of
+	/// other peers.
+	/// </para>
+	/// <para>
+	/// When the queue is full the accept thread stops accepting, and further
+	/// connection requests are held in the UDT listen backlog.
+	/// </para>
+	/// <para>
+	/// A connection that fails to be accepted, for example because it does
+	/// not fit the <see cref="Socket::Budget"/> of <see cref="Server"/>, is
+	/// dropped and the listener keeps accepting others.
+	/// </para>
+	/// </remarks>
+	public ref class UdtListener
+	{
+	private:
+		Udt::Socket^ _server;
+		System::Net::IPEndPoint^ _endPoint;
+		int _queueCapacity;
+		int _epollId;
+		System::Threading::Thread^ _acceptThread;
+		System::Threading::CancellationTokenSource^ _stopSource;
+		System::Collections::Concurrent::BlockingCollection<Udt::Socket^>^ _pending;
+		System::Exception^ _acceptError;
+		bool _active;
+
+		literal int DefaultBacklog = 1024;
+		literal int AcceptPollMilliseconds = 100;
+
+		void AcceptLoop(void);
+		void AssertActive(void);
+
+	public:
+
+		/// <summary>
+		/// Default maximum number of accepted connections that are queued
+		/// waiting to be retrieved.
+		/// </summary>
+		literal int DefaultQueueCapacity = 128;
+
+		/// <summary>
+		/// Initialize a new instance that listens on the specified local end point.
+		/// </summary>
+		/// <param name="localEP">Local end point to listen on.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="localEP"/> is a null reference.</exception>
+		UdtListener(System::Net::IPEndPoint^ localEP);
+
+		/// <summary>
+		/// Initialize a new instance that listens on the specified local address and port.
+		/// </summary>
+		/// <param name="localaddr">Local address to listen on.</param>
+		/// <param name="port">Port to listen on.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="localaddr"/> is a null reference.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">
+		/// If <paramref name="port"/> is less than <see cref="System::Net::IPEndPoint::MinPort"/>
+		/// or greater than <see cref="System::Net::IPEndPoint::MaxPort"/>.
+		/// </exception>
+		UdtListener(System::Net::IPAddress^ localaddr, int port);
+
+		/// <summary>
+		/// Initialize a new instance that listens on the specified local end point.
+		/// </summary>
+		/// <param name="localEP">Local end point to listen on.</param>
+		/// <param name="queueCapacity">Maximum number of accepted connections waiting to be retrieved.</param>
+		/// <exception cref="System::ArgumentNullException">If <paramref name="localEP"/> is a null reference.</exception>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="queueCapacity"/> is less than 1.</exception>
+		UdtListener(System::Net::IPEndPoint^ localEP, int queueCapacity);
+
+		/// <summary>
+		/// Stops the listener.
+		/// </summary>
+		~UdtListener(void);
+
+		/// <summary>
+		/// Start listening for incoming connection requests.
+		/// </summary>
+		/// <remarks>
+		/// Does nothing if the listener has already been started.
+		/// </remarks>
+		/// <exception cref="Udt::SocketException">If an error occurs binding or listening.</exception>
+		void Start(void);
+
+		/// <summary>
+		/// Start listening for incoming connection requests.
+		/// </summary>
+		/// <remarks>
+		/// Does nothing if the listener has already been started.
+		/// </remarks>
+		/// <param name="backlog">Maximum length of the UDT pending connections queue.</param>
+		/// <exception cref="System::ArgumentOutOfRangeException">If <paramref name="backlog"/> is less than 1.</exception>
+		/// <exception cref="Udt::SocketException">If an error occurs binding or listening.</exception>
+		void Start(int backlog);
+
+		/// <summary>
+		/// Stop listening and close the listening socket.
+		/// </summary>
+		/// <remarks>
+		/// Connections that were accepted but not yet retrieved are closed.
+		/// </remarks>
+		void Stop(void);
+
+		/// <summary>
+		/// Determine if there are pending connections.
+		/// </summary>
+		/// <returns>True if a call to <see cref="AcceptSocket"/> will not block.</returns>
+		/// <exception cref="System::InvalidOperationException">If the listener has not been started.</exception>
+		bool Pending(void);
+
+		/// <summary>
+		/// Retrieve the next accepted connection, waiting until one is available.
+		/// </summary>
+		/// <returns>Connected socket.</returns>
+		/// <exception cref="System::InvalidOperationException">
+		/// If the listener has not been started<br/>
+		/// <b>- or -</b><br/>
+		/// the background accept thread failed.
+		/// </exception>
+		Udt::Socket^ AcceptSocket(void);
+
+		/// <summary>
+		/// Retrieve the next accepted connection, waiting up to the specified
+		/// time for one to be available.
+		/// </summary>
+		/// <param name="timeout">Maximum time to wait or <see cref="Udt::Socket::InfiniteTimeout"/>.</param>
+		/// <returns>Connected socket, or a null reference if the timeout elapsed.</returns>
+		/// <exception cref="System::InvalidOperationException">
+		/// If the listener has not been started<br/>
+		/// <b>- or -</b><br/>
+		/// the background accept thread failed.
+		/// </exception>
+		Udt::Socket^ AcceptSocket(System::TimeSpan timeout);
+
+		/// <summary>
+		/// Retrieve the next accepted connection as a <see cref="UdtClient"/>,
+		/// waiting until one is available.
+		/// </summary>
+		/// <returns>Connected client.</returns>
+		/// <exception cref="System::InvalidOperationException">
+		/// If the listener has not been started<br/>
+		/// <b>- or -</b><br/>
+		/// the background accept thread failed.
+		/// </exception>
+		Udt::UdtClient^ AcceptUdtClient(void);
+
+		/// <summary>
+		/// Get the local end point the listener is bound to.
+		/// </summary>
+		/// <remarks>
+		/// Once started, this is the actual end point of the listening
+		/// socket (i.e. an ephemeral port is resolved).
+		/// </remarks>
+		[System::Diagnostics::CodeAnalysis::SuppressMessageAttribute(
+			"Microsoft.Naming",
+			"CA1702:CompoundWordsShouldBeCasedCorrectly",
+			Justification = "EndPoint is the casing used in IPEndPoint")]
+		property System::Net::IPEndPoint^ LocalEndPoint
+		{
+			System::Net::IPEndPoint^ get(void);
+		}
+
+		/// <summary>
+		/// Get the underlying listening socket, or a null reference if the
+		/// listener is not started.
+		/// </summary>
+		property Udt::Socket^ Server
+		{
+			Udt::Socket^ get(void) { return _server; }
+		}
+
+		/// <summary>
+		/// Get if the listener is started.
+		/// </summary>
+		property bool Active
+		{
+			bool get(void) { return _active; }
+		}
+
+		/// <summary>
+		/// Get the number of accepted connections waiting to be retrieved.
+		/// </summary>
+		property int PendingCount
+		{
+			int get(void);
+		}
+	};
+}